@@ -18,9 +18,38 @@
 // basic linear algebra subroutines
 #include <stddef.h>
 
+#include <type_traits>
+#include <vector>
+
 namespace proofs {
+
+// Fields that support lazy reduction define an Accum type for unreduced
+// sums of products, together with mac(s, x, y), which adds x * y to s,
+// and reduce_accum(s).  See fp_generic.h and gf2_128.h.
+template <class Field, class = void>
+struct HasAccum : std::false_type {};
+
+template <class Field>
+struct HasAccum<Field, std::void_t<typename Field::Accum>> : std::true_type {};
+
+// Fields may specialize BlasKernels to provide faster implementations of
+// some Blas routines on arrays, see fp_p256.h for an example.  A
+// specialization sets kEnabled and defines dot(), scale(), axpy(),
+// vaxpy(), vymax() and bind() with the same arguments as the Blas
+// routines, except that dot() returns its result through an extra
+// argument.  Each kernel returns false if it declines the call, e.g.
+// because the array is short or the CPU lacks the necessary
+// instructions, in which case Blas falls back to the generic code.
+// enabled(n) tells whether the kernels accept arrays of length N.
+template <class Field>
+struct BlasKernels {
+  static constexpr bool kEnabled = false;
+};
+
 template <class Field>
 class Blas {
+  using Kernels = BlasKernels<Field>;
+
  public:
   using Elt = typename Field::Elt;
 
@@ -28,6 +57,16 @@ class Blas {
   static Elt dot(size_t n, const Elt x[/*n:incx*/], size_t incx,
                  const Elt y[/*n:incy*/], size_t incy, const Field& F) {
     Elt r = F.zero();
+    if constexpr (Kernels::kEnabled) {
+      if (Kernels::dot(n, r, x, incx, y, incy, F)) return r;
+    }
+    if constexpr (HasAccum<Field>::value) {
+      typename Field::Accum s{};
+      for (size_t i = 0; i < n; i++) {
+        F.mac(s, x[i * incx], y[i * incy]);
+      }
+      return F.reduce_accum(s);
+    }
     for (size_t i = 0; i < n; i++) {
       F.add(r, F.mulf(x[i * incx], y[i * incy]));
     }
@@ -47,6 +86,9 @@ class Blas {
   // y = a*y
   static void scale(size_t n, Elt y[/*k:incy*/], size_t incy, const Elt a,
                     const Field& F) {
+    if constexpr (Kernels::kEnabled) {
+      if (Kernels::scale(n, y, incy, a, F)) return;
+    }
     for (size_t i = 0; i < n; i++) {
       F.mul(y[i * incy], a);
     }
@@ -55,6 +97,9 @@ class Blas {
   // y = a*x + y.
   static void axpy(size_t n, Elt y[/*k:incy*/], size_t incy, const Elt a,
                    const Elt x[/*k:incx*/], size_t incx, const Field& F) {
+    if constexpr (Kernels::kEnabled) {
+      if (Kernels::axpy(n, y, incy, a, x, incx, F)) return;
+    }
     for (size_t i = 0; i < n; i++) {
       F.add(y[i * incy], F.mulf(x[i * incx], a));
     }
@@ -64,6 +109,9 @@ class Blas {
   static void vaxpy(size_t n, Elt y[/*k:incy*/], size_t incy,
                     const Elt a[/*k:inca*/], size_t inca,
                     const Elt x[/*k:incx*/], size_t incx, const Field& F) {
+    if constexpr (Kernels::kEnabled) {
+      if (Kernels::vaxpy(n, y, incy, a, inca, x, incx, F)) return;
+    }
     for (size_t i = 0; i < n; i++) {
       F.add(y[i * incy], F.mulf(x[i * incx], a[i * inca]));
     }
@@ -73,11 +121,29 @@ class Blas {
   static void vymax(size_t n, Elt y[/*k:incy*/], size_t incy,
                     const Elt a[/*k:inca*/], size_t inca,
                     const Elt x[/*k:incx*/], size_t incx, const Field& F) {
+    if constexpr (Kernels::kEnabled) {
+      if (Kernels::vymax(n, y, incy, a, inca, x, incx, F)) return;
+    }
     for (size_t i = 0; i < n; i++) {
       F.sub(y[i * incy], F.mulf(x[i * incx], a[i * inca]));
     }
   }
 
+  // w[i] = x[2 * i] + r * (x[2 * i + 1] - x[2 * i]), the affine
+  // interpolation of consecutive pairs used for binding a variable.  W may
+  // alias X, as long as W does not start after X.
+  static void bind(size_t n, Elt w[/*n*/], const Elt x[/*2*n*/], const Elt& r,
+                   const Field& F) {
+    if constexpr (Kernels::kEnabled) {
+      if (Kernels::bind(n, w, x, r, F)) return;
+    }
+    for (size_t i = 0; i < n; i++) {
+      Elt d = F.subf(x[2 * i + 1], x[2 * i]);
+      F.mul(d, r);
+      w[i] = F.addf(x[2 * i], d);
+    }
+  }
+
   static bool equal(size_t n, const Elt x[/*n:incx*/], size_t incx,
                     const Elt y[/*n:incy*/], size_t incy, const Field& F) {
     for (size_t i = 0; i < n; i++) {
@@ -116,6 +182,96 @@ class Blas {
     }
   }
 };
+
+// An array of N sums of products, for linear combinations of many
+// vectors, y += SUM_{i} a[i] * X[i] or y += SUM_{i} A[i] \otimes X[i].
+// When the field supports lazy reduction, the sums are kept unreduced
+// and each output is reduced once in add_to().  Fields whose Blas
+// kernels handle arrays of length N accumulate reduced elements with
+// those kernels instead, which is faster.
+template <class Field>
+class BlasAccumulator {
+  using Elt = typename Field::Elt;
+  using Kernels = BlasKernels<Field>;
+
+ public:
+  BlasAccumulator(size_t n, const Field& F) : n_(n), f_(F) {
+    if (lazy(n)) {
+      if constexpr (HasAccum<Field>::value) {
+        acc_.resize(n);
+      }
+    } else {
+      sum_.resize(n, F.zero());
+    }
+  }
+
+  // sum[j] += a * x[j]
+  void axpy(const Elt& a, const Elt x[/*n*/]) {
+    if constexpr (HasAccum<Field>::value) {
+      if (!acc_.empty()) {
+        for (size_t j = 0; j < n_; ++j) {
+          f_.mac(acc_[j], a, x[j]);
+        }
+        return;
+      }
+    }
+    Blas<Field>::axpy(n_, sum_.data(), 1, a, x, 1, f_);
+  }
+
+  // sum[j] += a[j] * x[j]
+  void vaxpy(const Elt a[/*n*/], const Elt x[/*n*/]) {
+    if constexpr (HasAccum<Field>::value) {
+      if (!acc_.empty()) {
+        for (size_t j = 0; j < n_; ++j) {
+          f_.mac(acc_[j], a[j], x[j]);
+        }
+        return;
+      }
+    }
+    Blas<Field>::vaxpy(n_, sum_.data(), 1, a, 1, x, 1, f_);
+  }
+
+  // y[j] += sum[j]
+  void add_to(Elt y[/*n*/]) const {
+    if constexpr (HasAccum<Field>::value) {
+      if (!acc_.empty()) {
+        for (size_t j = 0; j < n_; ++j) {
+          f_.add(y[j], f_.reduce_accum(acc_[j]));
+        }
+        return;
+      }
+    }
+    for (size_t j = 0; j < n_; ++j) {
+      f_.add(y[j], sum_[j]);
+    }
+  }
+
+ private:
+  static bool lazy(size_t n) {
+    if constexpr (!HasAccum<Field>::value) {
+      return false;
+    } else if constexpr (Kernels::kEnabled) {
+      return !Kernels::enabled(n);
+    } else {
+      return true;
+    }
+  }
+
+  template <class F, bool = HasAccum<F>::value>
+  struct AccumOf {
+    using type = typename F::Accum;
+  };
+  template <class F>
+  struct AccumOf<F, false> {
+    struct type {};
+  };
+  using Accum = typename AccumOf<Field>::type;
+
+  size_t n_;
+  const Field& f_;
+  std::vector<Accum> acc_;
+  std::vector<Elt> sum_;
+};
 }  // namespace proofs
 
 #endif  // PRIVACY_PROOFS_ZK_LIB_ALGEBRA_BLAS_H_
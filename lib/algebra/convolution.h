@@ -24,6 +24,8 @@
 #include "algebra/blas.h"
 #include "algebra/fft.h"
 #include "algebra/rfft.h"
+#include "algebra/twiddle.h"
+#include "util/ceildiv.h"
 
 /*
 All of the classes in this package compute convolutions.
@@ -65,9 +67,12 @@ class FFTConvolution {
         n_(n),
         m_(m),
         padding_(choose_padding(m)),
+        roots_f_(Twiddle<Field>::of_root(padding_, f_.invertf(omega_),
+                                         omega_order_, f_)),
+        roots_b_(Twiddle<Field>::of_root(padding_, omega_, omega_order_, f_)),
         y_fft_(padding_, f_.zero()) {
     Blas<Field>::copy(m, &y_fft_[0], 1, y, 1);
-    FFT<Field>::fftf(&y_fft_[0], padding_, omega_, omega_order_, f_);
+    FFT<Field>::fftb(&y_fft_[0], padding_, roots_f_, f_);
 
     // Pre-scale Y by 1/N to compensate for the scaling in FFTB(FFTF(.))
     Blas<Field>::scale(padding_, &y_fft_[0], 1,
@@ -80,16 +85,30 @@ class FFTConvolution {
   void convolution(const Elt x[/*n_*/], Elt z[/*m_*/]) const {
     std::vector<Elt> x_fft(padding_, f_.zero());
     Blas<Field>::copy(n_, &x_fft[0], 1, x, 1);
-    FFT<Field>::fftf(&x_fft[0], padding_, omega_, omega_order_, f_);
+    convolution_in_place(&x_fft[0]);
+    Blas<Field>::copy(m_, z, 1, &x_fft[0], 1);
+  }
+
+  // In-place convolution in a caller-provided buffer of padding()
+  // elements, for callers that convolve many arrays.  On input, X[0, n)
+  // holds x and X[n, padding) is zero.  On output, X[0, m) holds z.
+  void convolution_in_place(Elt X[/*padding_*/]) const {
+    FFT<Field>::fftb(X, padding_, roots_f_, f_);
     // Pointwise multiplication.
     for (size_t i = 0; i < padding_; ++i) {
-      f_.mul(x_fft[i], y_fft_[i]);
+      f_.mul(X[i], y_fft_[i]);
     }
     // Backward fft.
-    FFT<Field>::fftb(&x_fft[0], padding_, omega_, omega_order_, f_);
-    Blas<Field>::copy(m_, z, 1, &x_fft[0], 1);
+    FFT<Field>::fftb(X, padding_, roots_b_, f_);
   }
 
+  size_t padding() const { return padding_; }
+
+  // Approximate cost of one convolution, in units of one multiply-add
+  // in Field.  The constant is fit to BM_LigeroReqColumns in
+  // ligero/ligero_test.cc.
+  size_t cost() const { return 5 * padding_ * lg(padding_) / 4; }
+
  private:
   const Field& f_;
   const Elt omega_;
@@ -100,6 +119,11 @@ class FFTConvolution {
   size_t m_;  // total number of points output (points in + new points out)
   size_t padding_;
 
+  // Twiddle factors of the forward (inverse root) and backward
+  // transforms of size padding_, computed once for all convolutions.
+  const Twiddle<Field> roots_f_;
+  const Twiddle<Field> roots_b_;
+
   // fft(y[i]) / padding
   // padded with zeroes to the next power of 2 at least m.
   std::vector<Elt> y_fft_;
@@ -141,9 +165,11 @@ class FFTExtConvolution {
         n_(n),
         m_(m),
         padding_(choose_padding(m)),
+        roots_(RFFT<FieldExt>::twiddles(padding_, omega_, omega_order_,
+                                        f_ext_)),
         y_fft_(padding_, f_.zero()) {
     Blas<Field>::copy(m, &y_fft_[0], 1, y, 1);
-    RFFT<FieldExt>::r2hc(&y_fft_[0], padding_, omega_, omega_order_, f_ext_);
+    RFFT<FieldExt>::r2hc(&y_fft_[0], padding_, roots_, f_ext_);
 
     // Pre-scale Y by 1/N to compensate for the scaling in HC2R(R2HC(.))
     Blas<Field>::scale(padding_, &y_fft_[0], 1,
@@ -156,24 +182,39 @@ class FFTExtConvolution {
   void convolution(const Elt x[/*n_*/], Elt z[/*m_*/]) const {
     std::vector<Elt> x_fft(padding_, f_.zero());
     Blas<Field>::copy(n_, &x_fft[0], 1, x, 1);
-    RFFT<FieldExt>::r2hc(&x_fft[0], padding_, omega_, omega_order_, f_ext_);
+    convolution_in_place(&x_fft[0]);
+    Blas<Field>::copy(m_, z, 1, &x_fft[0], 1);
+  }
+
+  // In-place convolution in a caller-provided buffer of padding()
+  // elements, for callers that convolve many arrays.  On input, X[0, n)
+  // holds x and X[n, padding) is zero.  On output, X[0, m) holds z.
+  void convolution_in_place(Elt X[/*padding_*/]) const {
+    RFFT<FieldExt>::r2hc(X, padding_, roots_, f_ext_);
 
     // Pointwise multiplication
     {
       size_t i;
-      f_.mul(x_fft[0], y_fft_[0]);  // DC is real
+      f_.mul(X[0], y_fft_[0]);  // DC is real
       for (i = 1; i + i < padding_; ++i) {
-        RFFT<FieldExt>::cmul(&x_fft[i], &x_fft[padding_ - i], y_fft_[i],
+        RFFT<FieldExt>::cmul(&X[i], &X[padding_ - i], y_fft_[i],
                              y_fft_[padding_ - i], f_);
       }
-      f_.mul(x_fft[i], y_fft_[i]);  // Nyquist is real
+      f_.mul(X[i], y_fft_[i]);  // Nyquist is real
     }
 
     // Backward FFT.
-    RFFT<FieldExt>::hc2r(&x_fft[0], padding_, omega_, omega_order_, f_ext_);
-    Blas<Field>::copy(m_, z, 1, &x_fft[0], 1);
+    RFFT<FieldExt>::hc2r(X, padding_, roots_, f_ext_);
   }
 
+  size_t padding() const { return padding_; }
+
+  // Approximate cost of one convolution, in units of one multiply-add
+  // in Field.  The transforms work in FieldExt, hence the larger
+  // constant, which is fit to BM_LigeroReqColumns in
+  // ligero/ligero_test.cc.
+  size_t cost() const { return 10 * padding_ * lg(padding_); }
+
  private:
   const Field& f_;
   const FieldExt& f_ext_;
@@ -185,6 +226,10 @@ class FFTExtConvolution {
   size_t m_;  // total number of points output in convolution
   size_t padding_;
 
+  // Twiddle factors for transforms of size padding_, computed once
+  // for all convolutions.
+  const Twiddle<FieldExt> roots_;
+
   // fft(y[i]) / padding
   // padded with zeroes to the next power of 2 at least m.
   std::vector<Elt> y_fft_;
@@ -71,8 +71,17 @@ class FFT {
       return;
     }
 
-    Elt omega_n = Twiddle<Field>::reroot(omega, omega_order, n, F);
-    Twiddle<Field> roots(n, omega_n, F);
+    fftb(A, n, Twiddle<Field>::of_root(n, omega, omega_order, F), F);
+  }
+
+  // Backward FFT with precomputed twiddle factors ROOTS of order N.
+  // Callers that transform many arrays of the same size should
+  // compute ROOTS once.
+  static void fftb(Elt A[/*n*/], size_t n, const Twiddle<Field>& roots,
+                   const Field& F) {
+    if (n <= 1) {
+      return;
+    }
 
     Permutations<Elt>::bitrev(A, n);
 
@@ -73,6 +73,10 @@ class FpGeneric {
     for (size_t bits = 0; bits < 2 * kBits; ++bits) {
       add(rsquare_, rsquare_);
     }
+    accum_scale_ = Elt{N(1)};
+    for (size_t bits = 0; bits < Nat<2 * W64 + 1>::kBits; ++bits) {
+      add(accum_scale_, accum_scale_);
+    }
 
     for (uint64_t i = 0; i < sizeof(k_) / sizeof(k_[0]); ++i) {
       // convert k_[i] into montgomery form by calling mul0()
@@ -382,6 +386,34 @@ class FpGeneric {
     return Elt{reduce_nat(s)};
   }
 
+  // Lazy reduction of sums of products.  An Accum holds the exact
+  // integer sum of the products of the Montgomery representations,
+  // which reduce_accum() converts back to an Elt with a single
+  // reduction.  A value-initialized Accum is zero, and it has room for
+  // at least 2^32 products.
+  struct Accum {
+    Nat<2 * W64 + 1> n;
+  };
+
+  // s += x * y, without reduction
+  void mac(Accum& s, const Elt& x, const Elt& y) const {
+    constexpr size_t kLimbsS = Nat<2 * W64 + 1>::kLimbs;
+    limb_t l[kLimbs], h[kLimbs];
+    for (size_t i = 0; i < kLimbs; ++i) {
+      mulhl(kLimbs, l, h, x.n.limb_[i], y.n.limb_);
+      accum(kLimbsS - i, &s.n.limb_[i], kLimbs, l);
+      accum(kLimbsS - i - 1, &s.n.limb_[i + 1], kLimbs, h);
+    }
+  }
+
+  Elt reduce_accum(const Accum& s) const {
+    // reduce_nat() divides by 2^(bits in Accum), and the products carry
+    // an extra factor of R = 2^kBits.  accum_scale_ fixes both.
+    Elt r{reduce_nat(s.n)};
+    mul(r, accum_scale_);
+    return r;
+  }
+
  private:
   void maybe_minus_m(limb_t a[kLimbs], limb_t ah) const {
     limb_t a1[kLimbs];
@@ -479,7 +511,8 @@ class FpGeneric {
   }
 
   N negm_;
-  Elt rsquare_;  // 2^(kbits + kBits) mod p
+  Elt rsquare_;      // 2^(kbits + kBits) mod p
+  Elt accum_scale_;  // 2^(bits in Accum) mod p, not in Montgomery form
   limb_t mprime_;
   Elt k_[3];  // small constants
   Elt half_;  // 1/2
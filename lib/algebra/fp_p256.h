@@ -15,10 +15,14 @@
 #ifndef PRIVACY_PROOFS_ZK_LIB_ALGEBRA_FP_P256_H_
 #define PRIVACY_PROOFS_ZK_LIB_ALGEBRA_FP_P256_H_
 
+#include <stddef.h>
+
 #include <array>
 #include <cstdint>
 
+#include "algebra/blas.h"
 #include "algebra/fp_generic.h"
+#include "algebra/fp_p256_vector.h"
 #include "algebra/nat.h"
 #include "algebra/sysdep.h"
 
@@ -63,6 +67,69 @@ struct Fp256Reduce {
 
 template <bool optimized_mul = false>
 using Fp256 = FpGeneric<4, optimized_mul, Fp256Reduce>;
+
+// Blas routines on Fp256 arrays use the vector kernels when the CPU
+// supports them.
+template <bool optimized_mul>
+struct BlasKernels<FpGeneric<4, optimized_mul, Fp256Reduce>> {
+  using Field = Fp256<optimized_mul>;
+  using Elt = typename Field::Elt;
+
+  static constexpr bool kEnabled =
+      Fp256Vector::kCompiled && sizeof(typename Field::limb_t) == 8;
+
+  static bool enabled(size_t n) {
+    return n >= Fp256Vector::kMinLength && Fp256Vector::available();
+  }
+
+  static bool dot(size_t n, Elt& r, const Elt x[], size_t incx, const Elt y[],
+                  size_t incy, const Field& F) {
+    if (!enabled(n)) return false;
+    Fp256Vector::dot(n, limbs(&r), limbs(x), incx, limbs(y), incy);
+    return true;
+  }
+
+  static bool scale(size_t n, Elt y[], size_t incy, const Elt& a,
+                    const Field& F) {
+    if (!enabled(n)) return false;
+    Fp256Vector::scale(n, limbs(y), incy, limbs(&a));
+    return true;
+  }
+
+  static bool axpy(size_t n, Elt y[], size_t incy, const Elt& a, const Elt x[],
+                   size_t incx, const Field& F) {
+    if (!enabled(n)) return false;
+    Fp256Vector::axpy(n, limbs(y), incy, limbs(&a), limbs(x), incx);
+    return true;
+  }
+
+  static bool vaxpy(size_t n, Elt y[], size_t incy, const Elt a[], size_t inca,
+                    const Elt x[], size_t incx, const Field& F) {
+    if (!enabled(n)) return false;
+    Fp256Vector::vaxpy(n, limbs(y), incy, limbs(a), inca, limbs(x), incx);
+    return true;
+  }
+
+  static bool vymax(size_t n, Elt y[], size_t incy, const Elt a[], size_t inca,
+                    const Elt x[], size_t incx, const Field& F) {
+    if (!enabled(n)) return false;
+    Fp256Vector::vymax(n, limbs(y), incy, limbs(a), inca, limbs(x), incx);
+    return true;
+  }
+
+  static bool bind(size_t n, Elt w[], const Elt x[], const Elt& r,
+                   const Field& F) {
+    if (!enabled(n)) return false;
+    Fp256Vector::bind(n, limbs(w), limbs(x), limbs(&r));
+    return true;
+  }
+
+ private:
+  static_assert(sizeof(Elt) == 4 * sizeof(uint64_t));
+
+  static uint64_t* limbs(Elt* x) { return x->n.limb_; }
+  static const uint64_t* limbs(const Elt* x) { return x->n.limb_; }
+};
 }  // namespace proofs
 
 #endif  // PRIVACY_PROOFS_ZK_LIB_ALGEBRA_FP_P256_H_
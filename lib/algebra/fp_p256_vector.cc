@@ -0,0 +1,367 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "algebra/fp_p256_vector.h"
+
+#include <stddef.h>
+
+#include <cstdint>
+
+#include "algebra/fp_p256.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+
+#define PROOFS_TARGET_IFMA __attribute__((target("avx512f,avx512ifma")))
+
+namespace proofs {
+namespace {
+
+/*
+Each __m512i holds one 52-bit limb of eight field elements, and an
+element is five such limbs.  The AVX-512 IFMA instructions multiply the
+low 52 bits of two lanes and add either the low or the high 52 bits of
+the 104-bit product to a 64-bit accumulator, which leaves enough
+headroom to postpone carries until the end of a multiplication.
+
+Montgomery reduction must divide by 2^256 to agree with Fp256, which is
+not a multiple of the radix, so the last reduction round removes 48 bits
+instead of 52.  Since p = -1 mod 2^96, the Montgomery constant
+-p^{-1} mod 2^52 is 1 and the quotient digit of each round is simply the
+low limb of the accumulator.
+*/
+constexpr uint64_t kMask52 = (static_cast<uint64_t>(1) << 52) - 1;
+constexpr uint64_t kMask48 = (static_cast<uint64_t>(1) << 48) - 1;
+
+constexpr const std::array<uint64_t, 4>& kP64 = Fp256Reduce::kModulus;
+constexpr uint64_t kP52[5] = {
+    kP64[0] & kMask52,
+    ((kP64[0] >> 52) | (kP64[1] << 12)) & kMask52,
+    ((kP64[1] >> 40) | (kP64[2] << 24)) & kMask52,
+    ((kP64[2] >> 28) | (kP64[3] << 36)) & kMask52,
+    kP64[3] >> 16,
+};
+
+struct Lanes {
+  __m512i l[5];
+};
+
+PROOFS_TARGET_IFMA inline __m512i bcast(uint64_t x) {
+  return _mm512_set1_epi64(static_cast<long long>(x));
+}
+
+// Shifts and permutations with a zeroing mask.  The unmasked intrinsics
+// pass an undefined vector as the source of the masked-off lanes, which
+// GCC reports as uninitialized once they are inlined.  With a full mask
+// the compiler emits the same unmasked instructions.  The shifts are
+// macros because their count must be an immediate.
+constexpr __mmask8 kAllLanes = static_cast<__mmask8>(0xFF);
+
+#define PROOFS_SLLI(a, n) _mm512_maskz_slli_epi64(kAllLanes, (a), (n))
+#define PROOFS_SRLI(a, n) _mm512_maskz_srli_epi64(kAllLanes, (a), (n))
+#define PROOFS_SRAI(a, n) _mm512_maskz_srai_epi64(kAllLanes, (a), (n))
+
+PROOFS_TARGET_IFMA inline __m512i permute(__m512i idx, __m512i a) {
+  return _mm512_maskz_permutexvar_epi64(kAllLanes, idx, a);
+}
+
+// Offsets in uint64_t of eight consecutive elements with stride INC.
+PROOFS_TARGET_IFMA inline __m512i lane_index(size_t inc) {
+  long long s = static_cast<long long>(4 * inc);
+  return _mm512_set_epi64(7 * s, 6 * s, 5 * s, 4 * s, 3 * s, 2 * s, s, 0);
+}
+
+PROOFS_TARGET_IFMA inline __mmask8 lane_mask(size_t n) {
+  return n >= 8 ? static_cast<__mmask8>(0xFF)
+                : static_cast<__mmask8>((1u << n) - 1u);
+}
+
+PROOFS_TARGET_IFMA inline void from_words(Lanes& v, const __m512i w[4]) {
+  const __m512i m = bcast(kMask52);
+  v.l[0] = _mm512_and_si512(w[0], m);
+  v.l[1] = _mm512_and_si512(
+      _mm512_or_si512(PROOFS_SRLI(w[0], 52), PROOFS_SLLI(w[1], 12)), m);
+  v.l[2] = _mm512_and_si512(
+      _mm512_or_si512(PROOFS_SRLI(w[1], 40), PROOFS_SLLI(w[2], 24)), m);
+  v.l[3] = _mm512_and_si512(
+      _mm512_or_si512(PROOFS_SRLI(w[2], 28), PROOFS_SLLI(w[3], 36)), m);
+  v.l[4] = PROOFS_SRLI(w[3], 16);
+}
+
+PROOFS_TARGET_IFMA inline void to_words(__m512i w[4], const Lanes& v) {
+  w[0] = _mm512_or_si512(v.l[0], PROOFS_SLLI(v.l[1], 52));
+  w[1] = _mm512_or_si512(PROOFS_SRLI(v.l[1], 12), PROOFS_SLLI(v.l[2], 40));
+  w[2] = _mm512_or_si512(PROOFS_SRLI(v.l[2], 24), PROOFS_SLLI(v.l[3], 28));
+  w[3] = _mm512_or_si512(PROOFS_SRLI(v.l[3], 36), PROOFS_SLLI(v.l[4], 16));
+}
+
+// Load the elements at X + IDX for the lanes in K, and zero elsewhere.
+PROOFS_TARGET_IFMA inline void load(Lanes& v, const uint64_t* x, __m512i idx,
+                                    __mmask8 k) {
+  __m512i w[4];
+  for (size_t j = 0; j < 4; ++j) {
+    w[j] = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), k, idx, x + j,
+                                       8);
+  }
+  from_words(v, w);
+}
+
+PROOFS_TARGET_IFMA inline void store(uint64_t* x, __m512i idx, __mmask8 k,
+                                     const Lanes& v) {
+  __m512i w[4];
+  to_words(w, v);
+  for (size_t j = 0; j < 4; ++j) {
+    _mm512_mask_i64scatter_epi64(x + j, k, idx, w[j], 8);
+  }
+}
+
+PROOFS_TARGET_IFMA inline void broadcast(Lanes& v, const uint64_t a[4]) {
+  __m512i w[4];
+  for (size_t j = 0; j < 4; ++j) {
+    w[j] = bcast(a[j]);
+  }
+  from_words(v, w);
+}
+
+// Propagate carries (or borrows, with arithmetic shifts) so that l[0..3]
+// are in [0, 2^52).  l[4] absorbs the final carry and may be negative.
+PROOFS_TARGET_IFMA inline void normalize(Lanes& v) {
+  const __m512i m = bcast(kMask52);
+  for (size_t j = 0; j < 4; ++j) {
+    v.l[j + 1] = _mm512_add_epi64(v.l[j + 1], PROOFS_SRAI(v.l[j], 52));
+    v.l[j] = _mm512_and_si512(v.l[j], m);
+  }
+}
+
+// Given normalized v in [0, 2p), reduce to [0, p).
+PROOFS_TARGET_IFMA inline void reduce_once(Lanes& v) {
+  Lanes s;
+  for (size_t j = 0; j < 5; ++j) {
+    s.l[j] = _mm512_sub_epi64(v.l[j], bcast(kP52[j]));
+  }
+  normalize(s);
+  __mmask8 ge = _mm512_cmpge_epi64_mask(s.l[4], _mm512_setzero_si512());
+  for (size_t j = 0; j < 5; ++j) {
+    v.l[j] = _mm512_mask_blend_epi64(ge, v.l[j], s.l[j]);
+  }
+}
+
+PROOFS_TARGET_IFMA inline void add(Lanes& x, const Lanes& y) {
+  for (size_t j = 0; j < 5; ++j) {
+    x.l[j] = _mm512_add_epi64(x.l[j], y.l[j]);
+  }
+  normalize(x);
+  reduce_once(x);
+}
+
+PROOFS_TARGET_IFMA inline void sub(Lanes& x, const Lanes& y) {
+  for (size_t j = 0; j < 5; ++j) {
+    x.l[j] = _mm512_sub_epi64(x.l[j], y.l[j]);
+  }
+  normalize(x);
+  __mmask8 lt = _mm512_cmplt_epi64_mask(x.l[4], _mm512_setzero_si512());
+  for (size_t j = 0; j < 5; ++j) {
+    x.l[j] = _mm512_mask_add_epi64(x.l[j], lt, x.l[j], bcast(kP52[j]));
+  }
+  normalize(x);
+}
+
+// x = x * y / 2^256 mod p
+PROOFS_TARGET_IFMA inline void mul(Lanes& x, const Lanes& y) {
+  __m512i t[10];
+  for (size_t k = 0; k < 10; ++k) {
+    t[k] = _mm512_setzero_si512();
+  }
+  for (size_t i = 0; i < 5; ++i) {
+    for (size_t j = 0; j < 5; ++j) {
+      t[i + j] = _mm512_madd52lo_epu64(t[i + j], x.l[i], y.l[j]);
+      t[i + j + 1] = _mm512_madd52hi_epu64(t[i + j + 1], x.l[i], y.l[j]);
+    }
+  }
+
+  // Four rounds of 52 bits and one of 48 bits, 256 bits in total.
+  for (size_t k = 0; k < 5; ++k) {
+    __m512i q = _mm512_and_si512(t[k], bcast(k < 4 ? kMask52 : kMask48));
+    for (size_t j = 0; j < 5; ++j) {
+      t[k + j] = _mm512_madd52lo_epu64(t[k + j], q, bcast(kP52[j]));
+      t[k + j + 1] = _mm512_madd52hi_epu64(t[k + j + 1], q, bcast(kP52[j]));
+    }
+    if (k < 4) {
+      t[k + 1] = _mm512_add_epi64(t[k + 1], PROOFS_SRLI(t[k], 52));
+    }
+  }
+
+  // The result, less than 2p, is t[4..9] shifted right by 48 bits.
+  const __m512i m = bcast(kMask52);
+  for (size_t k = 4; k < 9; ++k) {
+    t[k + 1] = _mm512_add_epi64(t[k + 1], PROOFS_SRLI(t[k], 52));
+    t[k] = _mm512_and_si512(t[k], m);
+  }
+  for (size_t j = 0; j < 5; ++j) {
+    x.l[j] = _mm512_or_si512(PROOFS_SRLI(t[4 + j], 48),
+                             _mm512_and_si512(PROOFS_SLLI(t[5 + j], 4), m));
+  }
+  reduce_once(x);
+}
+
+PROOFS_TARGET_IFMA void dot_ifma(size_t n, uint64_t r[4], const uint64_t x[],
+                                 size_t incx, const uint64_t y[], size_t incy) {
+  const __m512i ix = lane_index(incx), iy = lane_index(incy);
+  Lanes acc, vx, vy;
+  for (size_t j = 0; j < 5; ++j) {
+    acc.l[j] = _mm512_setzero_si512();
+  }
+  for (size_t i = 0; i < n; i += 8) {
+    __mmask8 k = lane_mask(n - i);
+    load(vx, x + 4 * i * incx, ix, k);
+    load(vy, y + 4 * i * incy, iy, k);
+    mul(vx, vy);
+    add(acc, vx);
+  }
+
+  // Sum the eight lanes into lane 0.
+  const __m512i perm[3] = {
+      _mm512_set_epi64(3, 2, 1, 0, 7, 6, 5, 4),
+      _mm512_set_epi64(5, 4, 7, 6, 1, 0, 3, 2),
+      _mm512_set_epi64(6, 7, 4, 5, 2, 3, 0, 1),
+  };
+  for (size_t s = 0; s < 3; ++s) {
+    for (size_t j = 0; j < 5; ++j) {
+      vx.l[j] = permute(perm[s], acc.l[j]);
+    }
+    add(acc, vx);
+  }
+  store(r, lane_index(0), 1, acc);
+}
+
+PROOFS_TARGET_IFMA void scale_ifma(size_t n, uint64_t y[], size_t incy,
+                                   const uint64_t a[4]) {
+  const __m512i iy = lane_index(incy);
+  Lanes va, vy;
+  broadcast(va, a);
+  for (size_t i = 0; i < n; i += 8) {
+    __mmask8 k = lane_mask(n - i);
+    load(vy, y + 4 * i * incy, iy, k);
+    mul(vy, va);
+    store(y + 4 * i * incy, iy, k, vy);
+  }
+}
+
+PROOFS_TARGET_IFMA void axpy_ifma(size_t n, uint64_t y[], size_t incy,
+                                  const uint64_t a[4], const uint64_t x[],
+                                  size_t incx) {
+  const __m512i ix = lane_index(incx), iy = lane_index(incy);
+  Lanes va, vx, vy;
+  broadcast(va, a);
+  for (size_t i = 0; i < n; i += 8) {
+    __mmask8 k = lane_mask(n - i);
+    load(vx, x + 4 * i * incx, ix, k);
+    load(vy, y + 4 * i * incy, iy, k);
+    mul(vx, va);
+    add(vy, vx);
+    store(y + 4 * i * incy, iy, k, vy);
+  }
+}
+
+template <bool kSubtract>
+PROOFS_TARGET_IFMA void vaxpy_ifma(size_t n, uint64_t y[], size_t incy,
+                                   const uint64_t a[], size_t inca,
+                                   const uint64_t x[], size_t incx) {
+  const __m512i ix = lane_index(incx), iy = lane_index(incy),
+                ia = lane_index(inca);
+  Lanes va, vx, vy;
+  for (size_t i = 0; i < n; i += 8) {
+    __mmask8 k = lane_mask(n - i);
+    load(vx, x + 4 * i * incx, ix, k);
+    load(va, a + 4 * i * inca, ia, k);
+    load(vy, y + 4 * i * incy, iy, k);
+    mul(vx, va);
+    if (kSubtract) {
+      sub(vy, vx);
+    } else {
+      add(vy, vx);
+    }
+    store(y + 4 * i * incy, iy, k, vy);
+  }
+}
+
+PROOFS_TARGET_IFMA void bind_ifma(size_t n, uint64_t w[], const uint64_t x[],
+                                  const uint64_t r[4]) {
+  const __m512i ix = lane_index(2), iw = lane_index(1);
+  Lanes vr, v0, v1;
+  broadcast(vr, r);
+  for (size_t i = 0; i < n; i += 8) {
+    __mmask8 k = lane_mask(n - i);
+    load(v0, x + 8 * i, ix, k);
+    load(v1, x + 8 * i + 4, ix, k);
+    sub(v1, v0);
+    mul(v1, vr);
+    add(v0, v1);
+    store(w + 4 * i, iw, k, v0);
+  }
+}
+
+}  // namespace
+
+bool Fp256Vector::available() {
+  static const bool ok = __builtin_cpu_supports("avx512f") &&
+                         __builtin_cpu_supports("avx512ifma");
+  return ok;
+}
+
+void Fp256Vector::dot(size_t n, uint64_t r[4], const uint64_t x[], size_t incx,
+                      const uint64_t y[], size_t incy) {
+  dot_ifma(n, r, x, incx, y, incy);
+}
+
+void Fp256Vector::scale(size_t n, uint64_t y[], size_t incy,
+                        const uint64_t a[4]) {
+  scale_ifma(n, y, incy, a);
+}
+
+void Fp256Vector::axpy(size_t n, uint64_t y[], size_t incy, const uint64_t a[4],
+                       const uint64_t x[], size_t incx) {
+  axpy_ifma(n, y, incy, a, x, incx);
+}
+
+void Fp256Vector::vaxpy(size_t n, uint64_t y[], size_t incy,
+                        const uint64_t a[], size_t inca, const uint64_t x[],
+                        size_t incx) {
+  vaxpy_ifma<false>(n, y, incy, a, inca, x, incx);
+}
+
+void Fp256Vector::vymax(size_t n, uint64_t y[], size_t incy,
+                        const uint64_t a[], size_t inca, const uint64_t x[],
+                        size_t incx) {
+  vaxpy_ifma<true>(n, y, incy, a, inca, x, incx);
+}
+
+void Fp256Vector::bind(size_t n, uint64_t w[], const uint64_t x[],
+                       const uint64_t r[4]) {
+  bind_ifma(n, w, x, r);
+}
+
+}  // namespace proofs
+
+#undef PROOFS_SLLI
+#undef PROOFS_SRLI
+#undef PROOFS_SRAI
+
+#else  // no vector kernels
+
+namespace proofs {
+bool Fp256Vector::available() { return false; }
+}  // namespace proofs
+
+#endif
@@ -0,0 +1,80 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_ALGEBRA_FP_P256_VECTOR_H_
+#define PRIVACY_PROOFS_ZK_LIB_ALGEBRA_FP_P256_VECTOR_H_
+
+#include <stddef.h>
+
+#include <cstdint>
+
+namespace proofs {
+
+/*
+Vector kernels for arrays of elements of the P-256 base field.
+
+Elements are in the Montgomery form of Fp256, that is, four little-endian
+uint64_t limbs holding x * 2^256 mod p, fully reduced.  Element i of an
+array X with stride INCX starts at X[4 * i * incx].  Results are
+bit-for-bit identical to the scalar Fp256 arithmetic.
+
+The only implementation uses AVX-512 IFMA, with eight elements per
+vector in radix 2^52.  It is compiled on x86_64 with per-function target
+attributes, so the rest of the library does not require AVX-512.  Callers
+must check available() at runtime before calling any of the kernels, and
+fall back to the scalar code otherwise.
+*/
+class Fp256Vector {
+ public:
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  static constexpr bool kCompiled = true;
+#else
+  static constexpr bool kCompiled = false;
+#endif
+
+  // Arrays shorter than this are not worth the setup cost.
+  static constexpr size_t kMinLength = 16;
+
+  // True if the CPU supports the vector kernels.
+  static bool available();
+
+  // R = SUM_{i} x[i * incx] * y[i * incy]
+  static void dot(size_t n, uint64_t r[/*4*/], const uint64_t x[], size_t incx,
+                  const uint64_t y[], size_t incy);
+
+  // y[i * incy] *= a
+  static void scale(size_t n, uint64_t y[], size_t incy,
+                    const uint64_t a[/*4*/]);
+
+  // y[i * incy] += a * x[i * incx]
+  static void axpy(size_t n, uint64_t y[], size_t incy, const uint64_t a[/*4*/],
+                   const uint64_t x[], size_t incx);
+
+  // y[i * incy] += a[i * inca] * x[i * incx]
+  static void vaxpy(size_t n, uint64_t y[], size_t incy, const uint64_t a[],
+                    size_t inca, const uint64_t x[], size_t incx);
+
+  // y[i * incy] -= a[i * inca] * x[i * incx]
+  static void vymax(size_t n, uint64_t y[], size_t incy, const uint64_t a[],
+                    size_t inca, const uint64_t x[], size_t incx);
+
+  // w[i] = x[2 * i] + r * (x[2 * i + 1] - x[2 * i]).  W may alias X, as
+  // long as W does not start after X.
+  static void bind(size_t n, uint64_t w[], const uint64_t x[],
+                   const uint64_t r[/*4*/]);
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_ALGEBRA_FP_P256_VECTOR_H_
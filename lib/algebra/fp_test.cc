@@ -17,7 +17,9 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
+#include "algebra/blas.h"
 #include "algebra/bogorng.h"
 #include "algebra/fp_p128.h"
 #include "algebra/fp_p256.h"
@@ -386,6 +388,144 @@ TEST(Fp, castable) {
   EXPECT_TRUE(F.of_bytes_field(b));
 }
 
+// Lazy reduction agrees with reducing after every product, including
+// for sums of many products of large elements.
+template <class Field>
+void accum_test(const Field& F) {
+  using Elt = typename Field::Elt;
+  Bogorng<Field> rng(&F);
+  typename Field::Accum s{};
+  Elt want = F.zero();
+  for (size_t i = 0; i < 1000; ++i) {
+    Elt x = (i % 3 == 0) ? F.mone() : rng.next();
+    Elt y = (i % 5 == 0) ? F.mone() : rng.next();
+    F.mac(s, x, y);
+    F.add(want, F.mulf(x, y));
+    if (i % 97 == 0) {
+      EXPECT_EQ(F.reduce_accum(s), want);
+    }
+  }
+  EXPECT_EQ(F.reduce_accum(s), want);
+  EXPECT_EQ(F.reduce_accum(typename Field::Accum{}), F.zero());
+}
+
+TEST(Fp, Accum) {
+  accum_test(Fp<1>("18446744073709551557"));
+  accum_test(Fp256<true>());
+  accum_test(Fp384<true>());
+  accum_test(Fp521<true>());
+}
+
+TEST(Fp, BlasAccumulator) {
+  using Field = Fp256<true>;
+  using Elt = Field::Elt;
+  const Field F;
+  Bogorng<Field> rng(&F);
+
+  // Short arrays take the lazy path, long ones may use the vector kernels.
+  for (size_t n : {5, 64}) {
+    std::vector<Elt> y(n), want(n), a(n), x(n);
+    for (size_t j = 0; j < n; ++j) {
+      y[j] = want[j] = rng.next();
+    }
+    BlasAccumulator<Field> sum(n, F);
+    for (size_t i = 0; i < 10; ++i) {
+      const Elt u = rng.next();
+      for (size_t j = 0; j < n; ++j) {
+        a[j] = rng.next();
+        x[j] = rng.next();
+      }
+      sum.axpy(u, x.data());
+      sum.vaxpy(a.data(), x.data());
+      for (size_t j = 0; j < n; ++j) {
+        F.add(want[j], F.mulf(u, x[j]));
+        F.add(want[j], F.mulf(a[j], x[j]));
+      }
+    }
+    sum.add_to(y.data());
+    EXPECT_EQ(y, want);
+  }
+}
+
+// Blas on Fp256 arrays dispatches to the vector kernels when the CPU
+// supports them.  Compare against element-by-element scalar arithmetic,
+// across lengths that exercise partial vectors and non-unit strides.
+TEST(Fp, VectorKernels) {
+  using Field = Fp256<true>;
+  using Elt = Field::Elt;
+  using B = Blas<Field>;
+  const Field F;
+  Bogorng<Field> rng(&F);
+
+  auto fill = [&](std::vector<Elt>& v) {
+    for (size_t i = 0; i < v.size(); ++i) {
+      switch (i % 7) {
+        case 0:
+          v[i] = F.zero();
+          break;
+        case 3:
+          v[i] = F.mone();
+          break;
+        default:
+          v[i] = rng.next();
+      }
+    }
+  };
+
+  for (size_t n : {1, 15, 16, 17, 24, 31, 64, 101}) {
+    for (size_t inc : {1, 3}) {
+      std::vector<Elt> x(n * inc), y(n * inc), a(n * inc);
+      fill(x);
+      fill(y);
+      fill(a);
+      const Elt s = rng.next();
+
+      Elt want = F.zero();
+      for (size_t i = 0; i < n; ++i) {
+        F.add(want, F.mulf(x[i * inc], y[i * inc]));
+      }
+      EXPECT_EQ(B::dot(n, x.data(), inc, y.data(), inc, F), want);
+
+      std::vector<Elt> z = y, w = y;
+      B::scale(n, z.data(), inc, s, F);
+      for (size_t i = 0; i < n; ++i) F.mul(w[i * inc], s);
+      EXPECT_EQ(z, w);
+
+      z = y, w = y;
+      B::axpy(n, z.data(), inc, s, x.data(), inc, F);
+      for (size_t i = 0; i < n; ++i) F.add(w[i * inc], F.mulf(s, x[i * inc]));
+      EXPECT_EQ(z, w);
+
+      z = y, w = y;
+      B::vaxpy(n, z.data(), inc, a.data(), inc, x.data(), inc, F);
+      for (size_t i = 0; i < n; ++i) {
+        F.add(w[i * inc], F.mulf(a[i * inc], x[i * inc]));
+      }
+      EXPECT_EQ(z, w);
+
+      z = y, w = y;
+      B::vymax(n, z.data(), inc, a.data(), inc, x.data(), inc, F);
+      for (size_t i = 0; i < n; ++i) {
+        F.sub(w[i * inc], F.mulf(a[i * inc], x[i * inc]));
+      }
+      EXPECT_EQ(z, w);
+    }
+
+    // bind(), both out of place and in place.
+    std::vector<Elt> x(2 * n), z(n), w(n);
+    fill(x);
+    const Elt r = rng.next();
+    for (size_t i = 0; i < n; ++i) {
+      w[i] = F.addf(x[2 * i], F.mulf(r, F.subf(x[2 * i + 1], x[2 * i])));
+    }
+    B::bind(n, z.data(), x.data(), r, F);
+    EXPECT_EQ(z, w);
+    B::bind(n, x.data(), x.data(), r, F);
+    x.resize(n);
+    EXPECT_EQ(x, w);
+  }
+}
+
 // ======= Benchmarks ============
 
 template <class Field>
@@ -444,6 +584,23 @@ void BM_p256_mul(benchmark::State& state) {
 }
 BENCHMARK(BM_p256_mul);
 
+void BM_p256_axpy(benchmark::State& state) {
+  const Fp256<true> F;
+  Bogorng<Fp256<true>> rng(&F);
+  const size_t n = state.range(0);
+  std::vector<Fp256<true>::Elt> x(n), y(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = rng.next();
+    y[i] = rng.next();
+  }
+  const auto a = rng.next();
+  for (auto _ : state) {
+    Blas<Fp256<true>>::axpy(n, y.data(), 1, a, x.data(), 1, F);
+    benchmark::DoNotOptimize(y.data());
+  }
+}
+BENCHMARK(BM_p256_axpy)->Arg(1 << 12);
+
 void BM_p384_mul(benchmark::State& state) {
   const Fp384<true> F;
   bench_mul(F, state);
@@ -0,0 +1,80 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_ALGEBRA_INTERPOLATOR_CACHE_H_
+#define PRIVACY_PROOFS_ZK_LIB_ALGEBRA_INTERPOLATOR_CACHE_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace proofs {
+
+/*
+InterpolatorCache wraps an interpolator factory such as ReedSolomonFactory
+or LCH14ReedSolomonFactory, and it can be used in its place.  The first
+call to make(n, m) constructs an interpolator through the underlying
+factory, and later calls with the same (n, m) return the same instance.
+
+Interpolators are immutable after construction, and interpolate() is
+const, so a single instance can be shared by concurrent provers and
+verifiers.  make() itself is thread-safe.  The cache is not bounded, so
+it should be used for the handful of shapes fixed by a set of Ligero
+parameters, and not for arbitrary sizes.
+
+The underlying factory must outlive the cache.
+*/
+template <class Factory>
+class InterpolatorCache {
+ public:
+  using Interpolator = typename decltype(std::declval<const Factory&>().make(
+      0, 0))::element_type;
+
+  explicit InterpolatorCache(const Factory& factory) : factory_(factory) {}
+
+  InterpolatorCache(const InterpolatorCache&) = delete;
+  InterpolatorCache& operator=(const InterpolatorCache&) = delete;
+
+  std::shared_ptr<const Interpolator> make(size_t n, size_t m) const {
+    const std::pair<size_t, size_t> key(n, m);
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      auto it = cache_.find(key);
+      if (it != cache_.end()) {
+        return it->second;
+      }
+    }
+
+    // Construct outside of the lock, since this is the expensive part.
+    // If two threads race, the first one to insert wins and the other
+    // instance is discarded.
+    std::shared_ptr<const Interpolator> interp = factory_.make(n, m);
+    std::lock_guard<std::mutex> lock(mu_);
+    return cache_.try_emplace(key, std::move(interp)).first->second;
+  }
+
+ private:
+  const Factory& factory_;
+  mutable std::mutex mu_;
+  mutable std::map<std::pair<size_t, size_t>,
+                   std::shared_ptr<const Interpolator>>
+      cache_;
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_ALGEBRA_INTERPOLATOR_CACHE_H_
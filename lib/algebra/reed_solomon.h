@@ -20,7 +20,9 @@
 #include <memory>
 #include <vector>
 
+#include "algebra/blas.h"
 #include "algebra/utility.h"
+#include "util/panic.h"
 
 namespace proofs {
 
@@ -54,11 +56,11 @@ class ReedSolomon {
         degree_bound_(n - 1),
         m_(m),
         leading_constant_(m - n + 1),
-        binom_i_(n) {
-    // inverses[i]: inverses[i] = 1/i from i = 1 to m-1 (inverses[0] = 0)
-    std::vector<Elt> inverses(m_);
-    AlgebraUtil<Field>::batch_inverse_arithmetic(m, &inverses[0], F);
-    c_ = factory.make(n, m, &inverses[0]);
+        binom_i_(n),
+        inverses_(m) {
+    // inverses_[i]: inverses_[i] = 1/i from i = 1 to m-1 (inverses_[0] = 0)
+    AlgebraUtil<Field>::batch_inverse_arithmetic(m, &inverses_[0], F);
+    c_ = factory.make(n, m, &inverses_[0]);
     leading_constant_[0] = F.one();
     binom_i_[0] = F.one();
     // Set leading_constant_[i] = (i+degree_bound_) choose degree_bound_
@@ -66,7 +68,7 @@ class ReedSolomon {
     for (size_t i = 1; i + degree_bound_ < m; ++i) {
       leading_constant_[i] =
           F.mulf(leading_constant_[i - 1],
-                 F.mulf(F.of_scalar(degree_bound_ + i), inverses[i]));
+                 F.mulf(F.of_scalar(degree_bound_ + i), inverses_[i]));
     }
     // Finish computing the leading constants:
     // (-1)^degree_bound_ (k-degree_bound_) \binom{k}{degree_bound_}
@@ -80,7 +82,7 @@ class ReedSolomon {
 
     for (size_t i = 1; i < n; ++i) {
       binom_i_[i] =
-          F.mulf(binom_i_[i - 1], F.mulf(F.of_scalar(n - i), inverses[i]));
+          F.mulf(binom_i_[i - 1], F.mulf(F.of_scalar(n - i), inverses_[i]));
     }
     for (size_t i = 1; i < n; i += 2) {
       F.neg(binom_i_[i]);
@@ -109,6 +111,66 @@ class ReedSolomon {
     }
   }
 
+  // Equivalent to interpolate(&y[r * stride]) for 0 <= r < NROWS, but
+  // all rows share one scratch buffer that the convolver transforms in
+  // place, so that there is no allocation or copying per row.  Requires
+  // a convolver with convolution_in_place(), such as FFTConvolution or
+  // FFTExtConvolution.
+  void interpolate_many(size_t nrows, Elt y[/*nrows:stride*/],
+                        size_t stride) const {
+    const Field& F = f_;
+    size_t n = degree_bound_ + 1;
+    std::vector<Elt> X(c_->padding());
+
+    for (size_t r = 0; r < nrows; ++r) {
+      Elt* yr = &y[r * stride];
+      for (size_t i = 0; i < n; i++) {
+        X[i] = F.mulf(binom_i_[i], yr[i]);
+      }
+      for (size_t i = n; i < X.size(); ++i) {
+        X[i] = F.zero();
+      }
+      c_->convolution_in_place(&X[0]);
+      for (size_t i = n; i < m_; ++i) {
+        yr[i] = F.mulf(leading_constant_[i - degree_bound_], X[i]);
+      }
+    }
+  }
+
+  // Approximate cost of interpolate(), in units of one multiply-add in
+  // Field, for choosing between interpolate() and lagrange_weights().
+  // Requires a convolver with cost(), such as FFTConvolution or
+  // FFTExtConvolution.
+  size_t interpolate_cost() const { return c_->cost() + 2 * m_; }
+
+  // Coefficients of the interpolation at a few points: sets
+  // L[i * n + j] to the coefficient of Y[j] in Y'[IDX[i]], where Y' is
+  // the array that interpolate(Y) would produce.  Thus Y'[IDX[i]] is the
+  // dot product of L[i * n + *] with Y[*], which costs n multiplications
+  // per point instead of a full interpolation.
+  void lagrange_weights(size_t nidx, Elt L[/*nidx, n*/],
+                        const size_t idx[/*nidx*/]) const {
+    const Field& F = f_;
+    size_t n = degree_bound_ + 1;
+
+    for (size_t i = 0; i < nidx; ++i) {
+      size_t k = idx[i];
+      check(k < m_, "k < m_");
+      Elt* Li = &L[i * n];
+      if (k < n) {
+        Blas<Field>::clear(n, Li, 1, F);
+        Li[k] = F.one();
+      } else {
+        // Same sum as the convolution in interpolate(), restricted to
+        // the single output point K.
+        const Elt& lc = leading_constant_[k - degree_bound_];
+        for (size_t j = 0; j < n; ++j) {
+          Li[j] = F.mulf(lc, F.mulf(binom_i_[j], inverses_[k - j]));
+        }
+      }
+    }
+  }
+
  private:
   const Field& f_;
 
@@ -127,6 +189,8 @@ class ReedSolomon {
   std::vector<Elt> leading_constant_;
   // (-1)^i (degree_bound_ choose i) from i=0 to i=degree_bound_
   std::vector<Elt> binom_i_;
+  // 1/i from i=1 to i=m-1, for lagrange_weights()
+  std::vector<Elt> inverses_;
 };
 
 template <class Field, class ConvolutionFactory>
@@ -30,6 +30,7 @@
 #include "algebra/fp_p128.h"
 #include "algebra/fp_p256.h"
 #include "algebra/interpolation.h"
+#include "algebra/interpolator_cache.h"
 #include "algebra/poly.h"
 #include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
@@ -168,6 +169,80 @@ TEST(ReedSolomonTest, ReedSolomon) {
   one_field_reed_solomon(omegag, omegag_order, G);
 }
 
+TEST(ReedSolomonTest, InterpolatorCache) {
+  using Elt = Fp<1>::Elt;
+  using FFTConvolutionFactory = FFTConvolutionFactory<Fp<1>>;
+  using RSFactory = ReedSolomonFactory<Fp<1>, FFTConvolutionFactory>;
+
+  FFTConvolutionFactory factory(G, omegag, omegag_order);
+  RSFactory rs_factory(factory, G);
+  InterpolatorCache<RSFactory> cache(rs_factory);
+
+  // The same shape yields the same instance, other shapes do not.
+  auto r1 = cache.make(N, M);
+  auto r2 = cache.make(N, M);
+  auto r3 = cache.make(N, M + 1);
+  EXPECT_EQ(r1.get(), r2.get());
+  EXPECT_NE(r1.get(), r3.get());
+
+  // The cached interpolator computes the same as a fresh one.
+  Bogorng<Fp<1>> rng(&G);
+  std::vector<Elt> A(M), B(M);
+  for (size_t i = 0; i < N; ++i) {
+    A[i] = B[i] = rng.next();
+  }
+  r2->interpolate(&A[0]);
+  rs_factory.make(N, M)->interpolate(&B[0]);
+  EXPECT_EQ(A, B);
+}
+
+TEST(ReedSolomonTest, InterpolateMany) {
+  using Elt = Fp<1>::Elt;
+  using FFTConvolutionFactory = FFTConvolutionFactory<Fp<1>>;
+  constexpr size_t nrows = 5, stride = M + 3;
+
+  FFTConvolutionFactory factory(G, omegag, omegag_order);
+  ReedSolomon<Fp<1>, FFTConvolutionFactory> r(N, M, G, factory);
+  Bogorng<Fp<1>> rng(&G);
+
+  std::vector<Elt> Y(nrows * stride), Z(nrows * stride);
+  for (size_t row = 0; row < nrows; ++row) {
+    for (size_t i = 0; i < N; ++i) {
+      Y[row * stride + i] = Z[row * stride + i] = rng.next();
+    }
+  }
+
+  r.interpolate_many(nrows, &Y[0], stride);
+  for (size_t row = 0; row < nrows; ++row) {
+    r.interpolate(&Z[row * stride]);
+  }
+  EXPECT_EQ(Y, Z);
+}
+
+TEST(ReedSolomonTest, LagrangeWeights) {
+  using Elt = Fp<1>::Elt;
+  using FFTConvolutionFactory = FFTConvolutionFactory<Fp<1>>;
+
+  FFTConvolutionFactory factory(G, omegag, omegag_order);
+  ReedSolomon<Fp<1>, FFTConvolutionFactory> r(N, M, G, factory);
+  Bogorng<Fp<1>> rng(&G);
+
+  std::vector<Elt> Y(M);
+  for (size_t i = 0; i < N; ++i) {
+    Y[i] = rng.next();
+  }
+
+  const size_t idx[] = {0, N - 1, N, N + 1, M / 2, M - 1};
+  constexpr size_t nidx = sizeof(idx) / sizeof(idx[0]);
+  std::vector<Elt> L(nidx * N);
+  r.lagrange_weights(nidx, &L[0], idx);
+
+  r.interpolate(&Y[0]);
+  for (size_t i = 0; i < nidx; ++i) {
+    EXPECT_EQ(Blas<Fp<1>>::dot(N, &L[i * N], 1, &Y[0], 1, G), Y[idx[i]]);
+  }
+}
+
 TEST(Reed_Solomon, Product) {
   // Test that the product of two polynomials of degree < SMALL
   // has degree < 2*SMALL-1.  Start with A[SMALL] and B[SMALL],
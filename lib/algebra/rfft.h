@@ -269,18 +269,29 @@ class RFFT {
   }
 
  public:
+  // Twiddle factors for transforms of size N, which are the same for
+  // r2hc() and hc2r().
+  static Twiddle<FieldExt> twiddles(size_t n, const CElt& omega,
+                                    uint64_t omega_order, const FieldExt& C) {
+    validate_root(omega, C);
+    return Twiddle<FieldExt>::of_root(n, omega, omega_order, C);
+  }
+
   // Forward real to half-complex in-place transform.
   // N (the length of A) must be a power of 2
   static void r2hc(RElt A[/*n*/], size_t n, const CElt& omega,
                    uint64_t omega_order, const FieldExt& C) {
+    r2hc(A, n, twiddles(n, omega, omega_order, C), C);
+  }
+
+  // Forward transform with the precomputed ROOTS = twiddles(N, ...).
+  static void r2hc(RElt A[/*n*/], size_t n, const Twiddle<FieldExt>& roots,
+                   const FieldExt& C) {
     const Field& R = C.base_field();
-    validate_root(omega, C);
 
     if (n == 2) {
       r2hcI_2(A, 1, R);
     } else if (n >= 4) {
-      CElt omega_n = Twiddle<FieldExt>::reroot(omega, omega_order, n, C);
-      Twiddle<FieldExt> roots(n, omega_n, C);
       validate_I(roots.w_[n / 4], C);
 
       Permutations<RElt>::bitrev(A, n);
@@ -321,14 +332,17 @@ class RFFT {
   // Backward half-complex to real in-place transform.
   static void hc2r(RElt A[/*n*/], size_t n, const CElt& omega,
                    uint64_t omega_order, const FieldExt& C) {
+    hc2r(A, n, twiddles(n, omega, omega_order, C), C);
+  }
+
+  // Backward transform with the precomputed ROOTS = twiddles(N, ...).
+  static void hc2r(RElt A[/*n*/], size_t n, const Twiddle<FieldExt>& roots,
+                   const FieldExt& C) {
     const Field& R = C.base_field();
-    validate_root(omega, C);
 
     if (n == 2) {
       hc2rI_2(A, 1, R);
     } else if (n >= 4) {
-      CElt omega_n = Twiddle<FieldExt>::reroot(omega, omega_order, n, C);
-      Twiddle<FieldExt> roots(n, omega_n, C);
       validate_I(roots.w_[n / 4], C);
 
       size_t m = n;
@@ -35,12 +35,19 @@ class Twiddle {
   explicit Twiddle(size_t n, const Elt& omega_n, const Field& F)
       : order_(n), w_(n / 2) {
     auto w = F.one();
-    for (size_t i = 0; 2 * i < n; ++i) {
+    for (size_t i = 0; i < n / 2; ++i) {
       w_[i] = w;
       F.mul(w, omega_n);
     }
   }
 
+  // Twiddle factors for a transform of size N, given a root of unity
+  // OMEGA of order OMEGA_ORDER >= N.
+  static Twiddle of_root(size_t n, const Elt& omega, uint64_t omega_order,
+                         const Field& F) {
+    return Twiddle(n, reroot(omega, omega_order, n, F), F);
+  }
+
   // given a n-th root of unity omega_n, return a r-th root of unity
   // for r <= n
   static Elt reroot(const Elt& omega_n, uint64_t n, uint64_t r,
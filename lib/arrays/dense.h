@@ -18,6 +18,7 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <memory>
@@ -26,6 +27,7 @@
 #include "algebra/blas.h"
 #include "algebra/poly.h"
 #include "arrays/affine.h"
+#include "util/executor.h"
 #include "util/panic.h"
 
 namespace proofs {
@@ -71,26 +73,78 @@ class Dense {
 
   void clear(const Field& F) { Blas<Field>::clear(n0_ * n1_, &v_[0], 1, F); }
 
+  // Change the dimensions to N0 x N1, keeping the storage if it is
+  // large enough.  The contents are unspecified afterwards.
+  void resize(corner_t n0, corner_t n1) {
+    n0_ = n0;
+    n1_ = n1;
+    v_.resize(n0 * n1);
+  }
+
+  // Resize to the dimensions of Y and copy Y.
+  void copy_from(const Dense& y) {
+    resize(y.n0_, y.n1_);
+    Blas<Field>::copy(n0_ * n1_, &v_[0], 1, &y.v_[0], 1);
+  }
+
   // For a given random number r, the binding operation computes
   //   v[i] = (1 - r) * v[2 * i] + r * v[2 * i + 1]
   //        = v[2 * i] + r * (v[2 * i + 1] - v[2 * i])
   // and shrinks the array v by half.
   void bind(const Elt& r, const Field& F) {
     corner_t rd = 0, wr = 0;
+    corner_t npairs = n0_ / 2u;
     for (corner_t i1 = 0; i1 < n1_; ++i1) {
-      corner_t i0 = 0;
-      while (2 * i0 + 1 < n0_) {
-        v_[wr] = affine_interpolation(r, v_[rd], v_[rd + 1], F);
-        i0++, rd += 2, wr += 1;
-      }
-      if (2 * i0 < n0_) {
+      Blas<Field>::bind(npairs, &v_[wr], &v_[rd], r, F);
+      rd += 2 * npairs, wr += npairs;
+      if (2 * npairs < n0_) {
         v_[wr] = affine_interpolation(r, v_[rd], F.zero(), F);
-        i0++, rd++, wr++;
+        rd++, wr++;
       }
     }
     n0_ = (n0_ + 1u) / 2u;
   }
 
+  // Same as bind(r, F), but computed in parallel on EX.  The bound
+  // array is written to SCRATCH so that disjoint ranges of it can be
+  // produced concurrently, and then swapped with the array.  SCRATCH
+  // only grows, so a caller that keeps it across calls allocates at
+  // most once.  Small arrays are bound in place.
+  void bind(const Elt& r, const Field& F, Executor& ex,
+            std::vector<Elt>* scratch) {
+    corner_t h0 = (n0_ + 1u) / 2u;
+    corner_t n = h0 * n1_;
+    if (ex.concurrency() <= 1 || n < kBindPerTask) {
+      bind(r, F);
+      return;
+    }
+
+    corner_t npairs = n0_ / 2u;
+    if (scratch->size() < n) {
+      scratch->resize(n);
+    }
+    std::vector<Elt>& w = *scratch;
+    ex.parallel_for(n, kBindPerTask, [&](size_t b, size_t e) {
+      for (corner_t wr = b; wr < e;) {
+        // Bind the part of row i1 that falls in [wr, e).
+        corner_t i1 = wr / h0, i0 = wr % h0;
+        corner_t row_end = std::min<corner_t>(e, (i1 + 1) * h0);
+        corner_t rd = i1 * n0_ + 2 * i0;
+        if (i0 < npairs) {
+          corner_t m = std::min<corner_t>(row_end - wr, npairs - i0);
+          Blas<Field>::bind(m, &w[wr], &v_[rd], r, F);
+          wr += m, rd += 2 * m;
+        }
+        if (wr < row_end) {
+          w[wr] = affine_interpolation(r, v_[rd], F.zero(), F);
+          ++wr;
+        }
+      }
+    });
+    v_.swap(w);
+    n0_ = h0;
+  }
+
   void bind_all(size_t logv, const Elt r[/*logv*/], const Field& F) {
     for (size_t v = 0; v < logv; ++v) {
       bind(r[v], F);
@@ -103,15 +157,11 @@ class Dense {
   // the n0_ dimension, which is scaled by x_last.  This "last" quirk
   // is used by EQ.
   void scale(const Elt& x, const Elt& x_last, const Field& F) {
-    corner_t ndx = 0;
+    if (n0_ == 0) return;
     for (corner_t i1 = 0; i1 < n1_; ++i1) {
-      corner_t i0 = 0;
-      for (; i0 + 1 < n0_; ++i0) {
-        F.mul(v_[ndx++], x);
-      }
-      if (i0 < n0_) {
-        F.mul(v_[ndx++], x_last);
-      }
+      corner_t ndx = i1 * n0_;
+      Blas<Field>::scale(n0_ - 1, &v_[ndx], 1, x, F);
+      F.mul(v_[ndx + n0_ - 1], x_last);
     }
   }
 
@@ -145,6 +195,10 @@ class Dense {
     check(n1_ == 1, "n1_ == 1");
     return v_[0];
   }
+
+ private:
+  // Minimum number of output elements per task of the parallel bind().
+  static constexpr corner_t kBindPerTask = 4096;
 };
 
 // Helper class to fill a dense array a la std::vector<>
@@ -23,8 +23,10 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <absl/cleanup/cleanup.h>
 #include <absl/flags/flag.h>
@@ -35,9 +37,14 @@
 #include "util/panic.h"
 #include "util/readbuffer.h"
 #include "zk/zk_common.h"
+#include "algebra/convolution.h"
+#include "algebra/fp2.h"
+#include "algebra/reed_solomon.h"
 #include "circuits/mdoc/mdoc_decompress.h"
 #include "ec/p256.h"
 #include "gf2k/gf2_128.h"
+#include "gf2k/lch14_reed_solomon.h"
+#include "ligero/ligero_cost.h"
 #include "ligero/ligero_param.h"
 #include "proto/circuit.h"
 
@@ -46,6 +53,14 @@ ABSL_FLAG(std::string, output_dir, "circuits",
           "Output directory for the circuit file");
 ABSL_FLAG(int, num_attributes, 1,
           "Number of attributes for the circuit (selects ZkSpec)");
+ABSL_FLAG(int, rateinv, 0,
+          "Inverse rate of the Ligero code; 0 uses the value in the ZkSpec");
+ABSL_FLAG(int, nreq, 0,
+          "Number of opened Ligero columns; 0 uses the value in the ZkSpec");
+ABSL_FLAG(double, prover_budget_ms, std::numeric_limits<double>::infinity(),
+          "Budget for the modeled Ligero prover time of the hash and "
+          "signature proofs together.  The default selects the smallest "
+          "proof.");
 
 std::string BytesToHexString(const uint8_t* bytes, size_t len) {
   std::stringstream ss;
@@ -56,19 +71,76 @@ std::string BytesToHexString(const uint8_t* bytes, size_t len) {
   return ss.str();
 }
 
-// Recompute the parameters to find the optimal fine grained block_enc.
+// Root of unity for the f_p256^2 extension field.
+static constexpr char kRootX[] =
+    "112649224146410281873500457609690258373018840430489408729223714171582664"
+    "680802";
+static constexpr char kRootY[] =
+    "84087994358540907695740461427818660560182168997182378749313018254450460212"
+    "908";
+
+constexpr size_t kMinBlockEnc = 100;
+constexpr size_t kMaxBlockEnc = 1 << 17;
+
+// Sizes at which to calibrate the encoding cost: four per power of
+// two, plus the first size past each power of two, where the FFT size
+// of the prime-field interpolator doubles.
+std::vector<size_t> calibration_sizes(size_t max_size) {
+  std::vector<size_t> sizes;
+  for (size_t p = 64; p <= max_size; p *= 2) {
+    for (size_t e : {p, p + 1, p + p / 4, p + p / 2, p + 3 * p / 4}) {
+      if (e >= kMinBlockEnc / 2 && e <= max_size) {
+        sizes.push_back(e);
+      }
+    }
+  }
+  return sizes;
+}
+
+// Compute the cost of every block_enc under the model M and print the
+// Pareto frontier of (proof size, prover time, verifier time).
 template <class LigeroParam>
-size_t optimize(LigeroParam &lp) {
-  size_t min_proof_size = lp.layout(lp.block_enc);
-  size_t best_block_enc = lp.block_enc;
-  for (size_t e = 100; e <= (1 << 17); e++) {
-    size_t proof_size = lp.layout(e);
-    if (proof_size < min_proof_size) {
-      min_proof_size = proof_size;
-      best_block_enc = e;
+std::vector<proofs::LigeroCost> frontier(const char* name,
+                                         const LigeroParam& lp,
+                                         const proofs::LigeroCostModel& m) {
+  std::vector<proofs::LigeroCost> pts;
+  for (size_t e = kMinBlockEnc; e <= kMaxBlockEnc; e++) {
+    pts.push_back(proofs::ligero_cost(lp, e, m));
+  }
+  std::vector<proofs::LigeroCost> f = proofs::ligero_pareto_frontier(pts);
+  for (const proofs::LigeroCost& c : f) {
+    std::cout << "  " << name << " frontier: be:" << c.block_enc
+              << " sz:" << c.proof_bytes << " prover_ms:" << c.prover_ms
+              << " verifier_ms:" << c.verifier_ms << std::endl;
+  }
+  return f;
+}
+
+// The pair of points on the two frontiers with the smallest total proof
+// size whose total prover time fits in BUDGET_MS, or the pair with the
+// fastest prover if none fits.
+std::pair<proofs::LigeroCost, proofs::LigeroCost> choose(
+    const std::vector<proofs::LigeroCost>& fh,
+    const std::vector<proofs::LigeroCost>& fs, double budget_ms) {
+  std::pair<proofs::LigeroCost, proofs::LigeroCost> best{fh[0], fs[0]};
+  bool fits = false;
+  for (const proofs::LigeroCost& h : fh) {
+    for (const proofs::LigeroCost& s : fs) {
+      double ms = h.prover_ms + s.prover_ms;
+      size_t sz = h.proof_bytes + s.proof_bytes;
+      double best_ms = best.first.prover_ms + best.second.prover_ms;
+      size_t best_sz = best.first.proof_bytes + best.second.proof_bytes;
+      if (ms <= budget_ms) {
+        if (!fits || sz < best_sz || (sz == best_sz && ms < best_ms)) {
+          best = {h, s};
+          fits = true;
+        }
+      } else if (!fits && ms < best_ms) {
+        best = {h, s};
+      }
     }
   }
-  return best_block_enc;
+  return best;
 }
 
 // Decompress and parse the circuit bytes, optimize the Ligero
@@ -97,25 +169,31 @@ void optimize_params(const uint8_t* circuit_bytes, size_t circuit_len,
   auto c_hash = cr_h.from_bytes(rb_circuit, false);
   proofs::check(c_hash != nullptr, "Hash circuit could not be parsed");
 
+  // Optimize for the Ligero rate and number of queries of the ZkSpec,
+  // or for those given on the command line to produce a new profile.
+  size_t rateinv = zk_spec->rateinv, nreq = zk_spec->nreq;
+  if (absl::GetFlag(FLAGS_rateinv) > 0) {
+    rateinv = absl::GetFlag(FLAGS_rateinv);
+  }
+  if (absl::GetFlag(FLAGS_nreq) > 0) {
+    nreq = absl::GetFlag(FLAGS_nreq);
+  }
+
   proofs::LigeroParam<f_128> hp(
       (c_hash->ninputs - c_hash->npub_in) +
           proofs::ZkCommon<f_128>::pad_size(*c_hash),
-      c_hash->nl, kLigeroRate, kLigeroNreq);
+      c_hash->nl, rateinv, nreq);
 
   size_t min_proof_size = hp.layout(hp.block_enc);
   std::cout << "  hash legacy parameters: be:" << hp.block_enc
             << " sz:" << min_proof_size << " r:" << hp.r << " w:" << hp.w
             << " b:" << hp.block << " nr:" << hp.nrow << " nq:" << hp.nqtriples
             << std::endl;
-  size_t best_block_enc = optimize(hp);
-  min_proof_size = hp.layout(best_block_enc);
-  std::cout << "  hash   best parameters: be:" << best_block_enc
-            << " sz:" << min_proof_size << std::endl;
 
   proofs::LigeroParam<proofs::Fp256Base> sp(
       (c_sig->ninputs - c_sig->npub_in) +
           proofs::ZkCommon<proofs::Fp256Base>::pad_size(*c_sig),
-      c_sig->nl, kLigeroRate, kLigeroNreq);
+      c_sig->nl, rateinv, nreq);
 
   min_proof_size = sp.layout(sp.block_enc);
 
@@ -124,16 +202,46 @@ void optimize_params(const uint8_t* circuit_bytes, size_t circuit_len,
             << " b:" << sp.block << " nr:" << sp.nrow << " nq:" << sp.nqtriples
             << std::endl;
 
-  size_t sig_best_block_enc = optimize(sp);
-  min_proof_size = sp.layout(sig_best_block_enc);
+  // Fit the cost models on this machine with the interpolators used by
+  // mdoc_zk.  LCH14 block_enc must fit in the 16-bit subfield.
+  std::cout << "Calibrating the Ligero cost model..." << std::endl;
+  const proofs::LCH14ReedSolomonFactory<f_128> rsf_h(Fs);
+  const proofs::LigeroCostModel mh = proofs::calibrate_ligero_cost(
+      calibration_sizes((1 << f_128::kSubFieldBits) - 1), rateinv, rsf_h, Fs);
 
-  std::cout << "   sig   best parameters: be:" << sig_best_block_enc
-            << " sz:" << min_proof_size << std::endl;
+  using f2_p256 = proofs::Fp2<proofs::Fp256Base>;
+  using FftExtConvolutionFactory =
+      proofs::FFTExtConvolutionFactory<proofs::Fp256Base, f2_p256>;
+  const f2_p256 p256_2(proofs::p256_base);
+  const FftExtConvolutionFactory fft_b(proofs::p256_base, p256_2,
+                                       p256_2.of_string(kRootX, kRootY),
+                                       1ull << 31);
+  const proofs::ReedSolomonFactory<proofs::Fp256Base,
+                                   FftExtConvolutionFactory>
+      rsf_b(fft_b, proofs::p256_base);
+  const proofs::LigeroCostModel ms = proofs::calibrate_ligero_cost(
+      calibration_sizes(kMaxBlockEnc), rateinv, rsf_b, proofs::p256_base);
+
+  std::vector<proofs::LigeroCost> fh = frontier("hash", hp, mh);
+  std::vector<proofs::LigeroCost> fs = frontier(" sig", sp, ms);
+
+  double budget_ms = absl::GetFlag(FLAGS_prover_budget_ms);
+  auto [h, s] = choose(fh, fs, budget_ms);
+  std::cout << "  hash   best parameters: be:" << h.block_enc
+            << " sz:" << h.proof_bytes << " prover_ms:" << h.prover_ms
+            << " verifier_ms:" << h.verifier_ms << std::endl;
+  std::cout << "   sig   best parameters: be:" << s.block_enc
+            << " sz:" << s.proof_bytes << " prover_ms:" << s.prover_ms
+            << " verifier_ms:" << s.verifier_ms << std::endl;
+  if (h.prover_ms + s.prover_ms > budget_ms) {
+    std::cout << "  no parameters meet the prover budget of " << budget_ms
+              << " ms" << std::endl;
+  }
 
   std::cout << "{\"" << zk_spec->system << "\", \"" << circuit_id_hex << "\", "
             << zk_spec->num_attributes << ", " << zk_spec->version << ", "
-            << best_block_enc << ", " << sig_best_block_enc << "},"
-            << std::endl;
+            << h.block_enc << ", " << s.block_enc << ", " << rateinv << ", "
+            << nreq << "}," << std::endl;
 }
 
 // Helper to find a ZkSpecStruct matching the desired number of attributes.
@@ -20,11 +20,13 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <vector>
 
 #include "algebra/convolution.h"
 #include "algebra/fp2.h"
+#include "algebra/interpolator_cache.h"
 #include "algebra/reed_solomon.h"
 #include "arrays/dense.h"
 #include "circuits/mac/mac_reference.h"
@@ -38,9 +40,12 @@
 #include "random/secure_random_engine.h"
 #include "random/transcript.h"
 #include "sumcheck/circuit.h"
+#include "util/ceildiv.h"
+#include "util/executor.h"
 #include "util/log.h"
 #include "util/panic.h"
 #include "util/readbuffer.h"
+#include "util/writebuffer.h"
 #include "zk/zk_proof.h"
 #include "zk/zk_prover.h"
 #include "zk/zk_verifier.h"
@@ -77,6 +82,8 @@ using f_128 = GF2_128<>;
 using gf2k = f_128::Elt;
 
 using RSFactory = LCH14ReedSolomonFactory<f_128>;
+using RSCache_b = InterpolatorCache<RSFactory_b>;
+using RSCache = InterpolatorCache<RSFactory>;
 
 // Root of unity for the f_p256^2 extension field.
 static constexpr char kRootX[] =
@@ -86,6 +93,35 @@ static constexpr char kRootY[] =
     "84087994358540907695740461427818660560182168997182378749313018254450460212"
     "908";
 
+// Reed-Solomon interpolators for both fields, shared by all the provers
+// and verifiers in the process.  The interpolators depend only on the
+// Ligero block sizes, and thus each one is built the first time a ZkSpec
+// needs it and then reused by every later proof and verification.
+struct MdocReedSolomon {
+  const f_128 fs;
+  const f2_p256 p256_2;
+  const FftExtConvolutionFactory fft_b;
+  const RSFactory_b rsf_b;
+  const RSFactory rsf_h;
+  const RSCache_b cache_b;
+  const RSCache cache_h;
+
+  MdocReedSolomon()
+      : fs(),
+        p256_2(p256_base),
+        fft_b(p256_base, p256_2, p256_2.of_string(kRootX, kRootY), 1ull << 31),
+        rsf_b(fft_b, p256_base),
+        rsf_h(fs),
+        cache_b(rsf_b),
+        cache_h(rsf_h) {}
+};
+
+static const MdocReedSolomon &mdoc_reed_solomon() {
+  // Never destroyed, so that it remains valid during static destruction.
+  static const MdocReedSolomon *rs = new MdocReedSolomon();
+  return *rs;
+}
+
 // Magic constant 4 is derived from the circuit layout.
 // It represents the location of the signature MAC wire in the signature
 // verification circuit and must be updated if the public interface of the sig
@@ -209,7 +245,7 @@ bool fill_witness(DenseFiller<Fp256Base> &fill_b, DenseFiller<f_128> &fill_s,
                   const Elt &pkY, const uint8_t *tr, size_t tr_len,
                   const RequestedAttribute *attrs, size_t attrs_len,
                   const uint8_t *now, ProverState &state,
-                  SecureRandomEngine &rng, const f_128 &Fs, size_t version) {
+                  RandomEngine &rng, const f_128 &Fs, size_t version) {
   using MdocHW = MdocHashWitness<P256, f_128>;
   using MdocSW = MdocSignatureWitness<P256, Fp256Scalar>;
 
@@ -314,44 +350,22 @@ bool sameNamespace(const RequestedAttribute attrs[/*n*/], size_t n) {
   return true;
 }
 
-// =========== End of helper functions =====================
-extern "C" {
-/*
-API version that uses 2 circuits over different fields.
-*/
-using MdocSWw = MdocSignatureWitness<P256, Fp256Scalar>;
-
-// Main endpoint for producing a ZK proof for mdoc properties.
-// This implementation uses 2 separate circuits over 2 fields to verify
-// the signature and the hash components of the mdoc.
-// It is the caller's job to free the memory pointed to by prf.
-MdocProverErrorCode run_mdoc_prover(
-    const uint8_t *bcp, size_t bcsz, /* circuit data */
-    const uint8_t *mdoc, size_t mdoc_len, const char *pkx,
-    const char *pky,                          /* string rep of public key */
-    const uint8_t *transcript, size_t tr_len, /* session transcript */
-    const RequestedAttribute *attrs, size_t attrs_len,
-    const char *now, /* time formatted as "2023-11-02T09:00:00Z" */
-    uint8_t **prf, size_t *proof_len, const ZkSpecStruct *zk_spec) {
-  if (bcp == nullptr || mdoc == nullptr || pkx == nullptr || pky == nullptr ||
-      transcript == nullptr || attrs == nullptr || now == nullptr ||
-      prf == nullptr || proof_len == nullptr || zk_spec == nullptr) {
-    return MDOC_PROVER_NULL_INPUT;
-  }
-
-  Elt pkX, pkY;
-  if (!parsePk(pkx, pky, pkX, pkY)) {
-    log(ERROR, "invalid pkx, pky");
-    return MDOC_PROVER_INVALID_INPUT;
-  }
-
-  if (!sameNamespace(attrs, attrs_len)) {
-    log(ERROR, "attributes must all be in the same namespace");
-    return MDOC_PROVER_INVALID_INPUT;
-  }
+// A ZkSpec must carry its own Ligero parameters.  Zero values, as left
+// by an initializer that predates the rateinv and nreq fields, are
+// rejected rather than defaulted, so that a prover and a verifier
+// cannot silently disagree on them.
+bool hasLigeroParams(const ZkSpecStruct &zk_spec) {
+  return zk_spec.rateinv > 0 && zk_spec.nreq > 0;
+}
 
-  // Parse circuits from cached byte representation.
-  const f2_p256 p256_2(p256_base);
+// Decompresses BCP and parses the signature and hash circuits into
+// C_SIG and C_HASH.  Returns MDOC_PROVER_CIRCUIT_PARSING_FAILURE if the
+// bytes or the signature circuit are invalid, and
+// MDOC_PROVER_HASH_PARSING_FAILURE if the hash circuit is invalid.
+MdocProverErrorCode parse_circuits(
+    std::unique_ptr<Circuit<Fp256Base>> &c_sig,
+    std::unique_ptr<Circuit<f_128>> &c_hash, const uint8_t *bcp, size_t bcsz,
+    bool enforce_circuit_id) {
   const f_128 Fs;
 
   size_t len = kCircuitSizeMax;
@@ -366,18 +380,187 @@ MdocProverErrorCode run_mdoc_prover(
   ReadBuffer rb_circuit(bytes.data(), full_size);
 
   CircuitRep<Fp256Base> cr_s(p256_base, P256_ID);
-  auto c_sig = cr_s.from_bytes(rb_circuit, enforce_circuit_id_in_prover);
+  c_sig = cr_s.from_bytes(rb_circuit, enforce_circuit_id);
   if (c_sig == nullptr) {
     log(ERROR, "signature circuit could not be parsed");
     return MDOC_PROVER_CIRCUIT_PARSING_FAILURE;
   }
-  CircuitRep<f_128> cr_h(Fs, GF2_128_ID);
-  auto c_hash = cr_h.from_bytes(rb_circuit, enforce_circuit_id_in_prover);
 
+  CircuitRep<f_128> cr_h(Fs, GF2_128_ID);
+  c_hash = cr_h.from_bytes(rb_circuit, enforce_circuit_id);
   if (c_hash == nullptr) {
     log(ERROR, "hash circuit could not be parsed");
     return MDOC_PROVER_HASH_PARSING_FAILURE;
   }
+  return MDOC_PROVER_SUCCESS;
+}
+
+}  // namespace proofs
+
+// A pair of circuits parsed once and shared by many proofs.  The circuits
+// are never modified after parsing, and thus the handle can be used by
+// concurrent provers and verifiers.
+struct MdocCircuit {
+  std::unique_ptr<proofs::Circuit<proofs::Fp256Base>> c_sig;
+  std::unique_ptr<proofs::Circuit<proofs::f_128>> c_hash;
+};
+
+namespace proofs {
+
+// Verifies mdoc proofs against one circuit handle and ZkSpec.  The constructor
+// performs all the work that does not depend on the proof: the ZkVerifiers
+// compute the Ligero parameters and quadratic constraints, and the Reed-Solomon
+// interpolators come from the process-wide cache.  verify() is const and only
+// reads this state, and thus one instance can verify any number of proofs
+// concurrently.
+class MdocVerifier {
+ public:
+  MdocVerifier(const MdocCircuit &circuit, const ZkSpecStruct &zk_spec)
+      : zk_spec_(zk_spec),
+        c_sig_(*circuit.c_sig),
+        c_hash_(*circuit.c_hash),
+        fs_(),
+        hash_v_(c_hash_, mdoc_reed_solomon().cache_h, zk_spec.rateinv,
+                zk_spec.nreq, zk_spec.block_enc_hash, fs_),
+        sig_v_(c_sig_, mdoc_reed_solomon().cache_b, zk_spec.rateinv,
+               zk_spec.nreq, zk_spec.block_enc_sig, p256_base) {}
+
+  MdocVerifierErrorCode verify(const Elt &pkX, const Elt &pkY,
+                               const uint8_t *transcript, size_t tr_len,
+                               const RequestedAttribute *attrs,
+                               size_t attrs_len, const char *now,
+                               const uint8_t *zkproof, size_t proof_len,
+                               const char *docType) const {
+    if (!sameNamespace(attrs, attrs_len)) {
+      log(ERROR, "attributes must all be in the same namespace");
+      return MDOC_VERIFIER_INVALID_INPUT;
+    }
+
+    // Sanity check input sizes.
+    if (tr_len < 1 || attrs_len < 1 || proof_len < 20000) {
+      return MDOC_VERIFIER_ARGUMENTS_TOO_SMALL;
+    }
+
+    log(INFO, "circuit created. h[in:%zu], s[in:%zu]", c_hash_.ninputs,
+        c_sig_.ninputs);
+
+    // Parse proofs
+    ZkProof<f_128> pr_hash(c_hash_, zk_spec_.rateinv, zk_spec_.nreq,
+                           zk_spec_.block_enc_hash);
+    ZkProof<Fp256Base> pr_sig(c_sig_, zk_spec_.rateinv, zk_spec_.nreq,
+                              zk_spec_.block_enc_sig);
+
+    log(INFO,
+        "proof params: h[nl:%zu, ni:%zu], s[nl:%zu, ni:%zu] hc[b:%zu r:%zu] "
+        "sc[b:%zu r:%zu]",
+        c_hash_.nl, c_hash_.ninputs, c_sig_.nl, c_sig_.ninputs,
+        pr_hash.param.block, pr_hash.param.nrow, pr_sig.param.block,
+        pr_sig.param.nrow);
+
+    // Parse the proof in place.
+    ReadBuffer rb(zkproof, proof_len);
+
+    // Read macs from proof string.
+    // The sanity check above ensures that the proof is big enough for the
+    // MACs.
+    gf2k macs[6];
+
+    for (size_t i = 0; i < 6; ++i) {
+      macs[i] = fs_.of_bytes_field(rb.next(f_128::kBytes)).value();
+    }
+
+    // The proof read methods check proof length internally.
+    if (!pr_hash.read(rb, fs_)) {
+      log(ERROR, "hash proof could not be parsed");
+      return MDOC_VERIFIER_HASH_PARSING_FAILURE;
+    };
+    if (!pr_sig.read(rb, p256_base)) {
+      log(ERROR, "sig proof could not be parsed");
+      return MDOC_VERIFIER_SIGNATURE_PARSING_FAILURE;
+    }
+    if (rb.remaining() != 0) {
+      log(ERROR, "proof bytes contains extra data: %zu bytes", rb.remaining());
+      return MDOC_VERIFIER_SIGNATURE_PARSING_FAILURE;
+    }
+
+    log(INFO, "proofs read");
+
+    // =============== Verify
+
+    // Use the transcript from the session to select the random oracle.
+    class Transcript tv(transcript, tr_len, zk_spec_.version);
+
+    hash_v_.recv_commitment(pr_hash, tv);
+    sig_v_.recv_commitment(pr_sig, tv);
+
+    gf2k av = generate_mac_key(tv);
+
+    // =============== Create public inputs
+    auto pub_hash = Dense<f_128>(1, c_hash_.npub_in);
+    auto pub_sig = Dense<Fp256Base>(1, c_sig_.npub_in);
+    DenseFiller<f_128> hash_filler(pub_hash);
+    DenseFiller<Fp256Base> sig_filler(pub_sig);
+
+    size_t dlen = strlen(docType);
+    if (!fill_public_inputs(sig_filler, hash_filler, pkX, pkY, transcript,
+                            tr_len, attrs, attrs_len, (const uint8_t *)now,
+                            (const uint8_t *)docType, dlen, macs, av, fs_,
+                            zk_spec_.version)) {
+      return MDOC_VERIFIER_GENERAL_FAILURE;
+    }
+
+    if (hash_filler.size() != c_hash_.npub_in ||
+        sig_filler.size() != c_sig_.npub_in) {
+      return MDOC_VERIFIER_ATTRIBUTE_NUMBER_MISMATCH;
+    }
+
+    bool ok = hash_v_.verify(pr_hash, pub_hash, tv);
+    bool ok2 = sig_v_.verify(pr_sig, pub_sig, tv);
+
+    return ok && ok2 ? MDOC_VERIFIER_SUCCESS : MDOC_VERIFIER_GENERAL_FAILURE;
+  }
+
+ private:
+  const ZkSpecStruct &zk_spec_;
+  const Circuit<Fp256Base> &c_sig_;
+  const Circuit<f_128> &c_hash_;
+  const f_128 fs_;
+  const ZkVerifier<f_128, RSCache> hash_v_;
+  const ZkVerifier<Fp256Base, RSCache_b> sig_v_;
+};
+
+// The common part of the run_mdoc_prover_*() entry points, after the
+// arguments have been checked for null.  Once the proof is complete,
+// OUTPUT(LEN, &BUF) provides the LEN bytes into which it is written,
+// or returns an error.  *PROOF_LEN is set to the length of the proof
+// even if OUTPUT fails.
+static MdocProverErrorCode prove_mdoc(
+    const MdocCircuit *circuit, const uint8_t *mdoc, size_t mdoc_len,
+    const char *pkx, const char *pky, const uint8_t *transcript,
+    size_t tr_len, const RequestedAttribute *attrs, size_t attrs_len,
+    const char *now, const ZkSpecStruct *zk_spec, Executor *executor,
+    const std::function<MdocProverErrorCode(size_t, uint8_t **)> &output,
+    size_t *proof_len) {
+  if (!hasLigeroParams(*zk_spec)) {
+    log(ERROR, "ZkSpec has no Ligero parameters");
+    return MDOC_PROVER_INVALID_ZK_SPEC_VERSION;
+  }
+
+  Elt pkX, pkY;
+  if (!parsePk(pkx, pky, pkX, pkY)) {
+    log(ERROR, "invalid pkx, pky");
+    return MDOC_PROVER_INVALID_INPUT;
+  }
+
+  if (!sameNamespace(attrs, attrs_len)) {
+    log(ERROR, "attributes must all be in the same namespace");
+    return MDOC_PROVER_INVALID_INPUT;
+  }
+
+  const f_128 Fs;
+
+  const Circuit<Fp256Base> *c_sig = circuit->c_sig.get();
+  const Circuit<f_128> *c_hash = circuit->c_hash.get();
   log(INFO, "circuit created. h[in:%zu q:%zu], s[in:%zu q:%zu]",
       c_hash->ninputs, c_hash->nl, c_sig->ninputs, c_sig->nl);
 
@@ -387,7 +570,7 @@ MdocProverErrorCode run_mdoc_prover(
   DenseFiller<Fp256Base> sig_filler(W_sig);
   DenseFiller<f_128> hash_filler(W_hash);
 
-  SecureRandomEngine rng;
+  BufferedSecureRandomEngine rng;
   ProverState state;
   bool ok = fill_witness(
       sig_filler, hash_filler, mdoc, mdoc_len, pkX, pkY, transcript, tr_len,
@@ -401,21 +584,38 @@ MdocProverErrorCode run_mdoc_prover(
   // Use the transcript from the session to select the random oracle.
   Transcript tp(transcript, tr_len, zk_spec->version);
 
-  const Elt2 omega = p256_2.of_string(kRootX, kRootY);
-  const FftExtConvolutionFactory fft_b(p256_base, p256_2, omega, 1ull << 31);
-  const RSFactory_b rsf_b(fft_b, p256_base);
-  const RSFactory the_reed_solomon_factory(Fs);
+  const MdocReedSolomon &rs = mdoc_reed_solomon();
 
-  ZkProof<f_128> h_zk(*c_hash, kLigeroRate, kLigeroNreq,
+  ZkProof<f_128> h_zk(*c_hash, zk_spec->rateinv, zk_spec->nreq,
                       zk_spec->block_enc_hash);
-  ZkProof<Fp256Base> sig_zk(*c_sig, kLigeroRate, kLigeroNreq,
+  ZkProof<Fp256Base> sig_zk(*c_sig, zk_spec->rateinv, zk_spec->nreq,
                             zk_spec->block_enc_sig);
 
-  ZkProver<f_128, RSFactory> hash_p(*c_hash, Fs, the_reed_solomon_factory);
-  ZkProver<Fp256Base, RSFactory_b> sig_p(*c_sig, p256_base, rsf_b);
-
-  hash_p.commit(h_zk, W_hash, tp, rng);
-  sig_p.commit(sig_zk, W_sig, tp, rng);
+  // The executor runs the two provers side by side where possible, and
+  // the sumcheck and Ligero work within each prover.
+  SerialExecutor serial;
+  Executor *ex = executor != nullptr ? executor : &serial;
+  ZkProver<f_128, RSCache> hash_p(*c_hash, Fs, rs.cache_h, ex);
+  ZkProver<Fp256Base, RSCache_b> sig_p(*c_sig, p256_base, rs.cache_b, ex);
+
+  // The hash and signature proofs meet only at the transcript and at
+  // the MAC key.  Randomness and transcript operations happen on this
+  // thread in the same order as in a serial prover, and the work
+  // between these Fiat-Shamir points runs concurrently: first the
+  // encoding and hashing of the two tableaux, and then, once the MACs
+  // have completed the witnesses, the evaluation of the two circuits.
+  // The proof is thus the same as the one produced serially.
+  hash_p.sample_commitment(h_zk, W_hash, rng);
+  sig_p.sample_commitment(sig_zk, W_sig, rng);
+  ex->run(2, [&](size_t i) {
+    if (i == 0) {
+      hash_p.compute_commitment(h_zk);
+    } else {
+      sig_p.compute_commitment(sig_zk);
+    }
+  });
+  hash_p.write_commitment(h_zk, tp);
+  sig_p.write_commitment(sig_zk, tp);
 
   log(INFO,
       "commit created. h[nl:%zu, ni:%zu], s[nl:%zu, ni:%zu] hc[b:%zu r:%zu] "
@@ -433,6 +633,14 @@ MdocProverErrorCode run_mdoc_prover(
   update_macs(W_sig, W_hash, kSigMacIndex,
               getHashMacIndex(attrs_len, zk_spec->version), macs, av, Fs);
 
+  bool eval_ok[2];
+  ex->run(2, [&](size_t i) {
+    eval_ok[i] = (i == 0) ? hash_p.evaluate(W_hash) : sig_p.evaluate(W_sig);
+  });
+  if (!eval_ok[0] || !eval_ok[1]) {
+    return MDOC_PROVER_GENERAL_FAILURE;
+  }
+
   if (!hash_p.prove(h_zk, W_hash, tp)) {
     return MDOC_PROVER_GENERAL_FAILURE;
   };
@@ -443,25 +651,155 @@ MdocProverErrorCode run_mdoc_prover(
   };
   log(INFO, "ZK signature proof done");
 
-  // Serialize proof to bytes.
+  // Serialize proof to bytes, directly into the output buffer.
   // [6 mac values] [docType] [hash proof] [sig proof]
-  std::vector<uint8_t> buf;
   // This sum will not overflow based on constraints of circuit & proof size.
-  size_t tt = 6 * f_128::kBytes + h_zk.size() + sig_zk.size();
-  buf.reserve(tt);
-  buf.insert(buf.begin(), macs_b, macs_b + 6 * f_128::kBytes);
-  h_zk.write(buf, Fs);
-  sig_zk.write(buf, p256_base);
-  *proof_len = buf.size();
+  size_t tt = 6 * f_128::kBytes + h_zk.serialized_size(Fs) +
+              sig_zk.serialized_size(p256_base);
+  *proof_len = tt;
+  uint8_t *buf = nullptr;
+  MdocProverErrorCode err = output(tt, &buf);
+  if (err != MDOC_PROVER_SUCCESS) {
+    return err;
+  }
+  WriteBuffer wb(buf, tt);
+  wb.next(6 * f_128::kBytes, macs_b);
+  h_zk.write(wb, Fs);
+  sig_zk.write(wb, p256_base);
+  check(wb.remaining() == 0, "proof size mismatch");
   log(INFO, "proof_len: %zu ", *proof_len);
+  return MDOC_PROVER_SUCCESS;
+}
 
-  // Allocate memory and copy proof bytes.
-  *prf = (uint8_t *)malloc(*proof_len);
-  if (!prf) {
-    log(ERROR, "malloc failed");
-    return MDOC_PROVER_MEMORY_ALLOCATION_FAILURE;
+// =========== End of helper functions =====================
+extern "C" {
+/*
+API version that uses 2 circuits over different fields.
+*/
+using MdocSWw = MdocSignatureWitness<P256, Fp256Scalar>;
+
+// Main endpoint for producing a ZK proof for mdoc properties.
+// This implementation uses 2 separate circuits over 2 fields to verify
+// the signature and the hash components of the mdoc.
+// It is the caller's job to free the memory pointed to by prf.
+MdocProverErrorCode run_mdoc_prover(
+    const uint8_t *bcp, size_t bcsz, /* circuit data */
+    const uint8_t *mdoc, size_t mdoc_len, const char *pkx,
+    const char *pky,                          /* string rep of public key */
+    const uint8_t *transcript, size_t tr_len, /* session transcript */
+    const RequestedAttribute *attrs, size_t attrs_len,
+    const char *now, /* time formatted as "2023-11-02T09:00:00Z" */
+    uint8_t **prf, size_t *proof_len, const ZkSpecStruct *zk_spec) {
+  if (bcp == nullptr || mdoc == nullptr || pkx == nullptr || pky == nullptr ||
+      transcript == nullptr || attrs == nullptr || now == nullptr ||
+      prf == nullptr || proof_len == nullptr || zk_spec == nullptr) {
+    return MDOC_PROVER_NULL_INPUT;
+  }
+
+  Elt pkX, pkY;
+  if (!parsePk(pkx, pky, pkX, pkY)) {
+    log(ERROR, "invalid pkx, pky");
+    return MDOC_PROVER_INVALID_INPUT;
   }
-  memcpy(*prf, buf.data(), buf.size());
+
+  if (!sameNamespace(attrs, attrs_len)) {
+    log(ERROR, "attributes must all be in the same namespace");
+    return MDOC_PROVER_INVALID_INPUT;
+  }
+
+  // Parse circuits from cached byte representation.
+  MdocCircuit circuit;
+  MdocProverErrorCode err = parse_circuits(circuit.c_sig, circuit.c_hash, bcp,
+                                           bcsz, enforce_circuit_id_in_prover);
+  if (err != MDOC_PROVER_SUCCESS) {
+    return err;
+  }
+
+  return run_mdoc_prover_with_handle(&circuit, mdoc, mdoc_len, pkx, pky,
+                                     transcript, tr_len, attrs, attrs_len, now,
+                                     prf, proof_len, zk_spec,
+                                     /*executor=*/nullptr);
+}
+
+MdocProverErrorCode run_mdoc_prover_with_handle(
+    const MdocCircuit *circuit, /* parsed circuit */
+    const uint8_t *mdoc, size_t mdoc_len, const char *pkx,
+    const char *pky,                          /* string rep of public key */
+    const uint8_t *transcript, size_t tr_len, /* session transcript */
+    const RequestedAttribute *attrs, size_t attrs_len,
+    const char *now, /* time formatted as "2023-11-02T09:00:00Z" */
+    uint8_t **prf, size_t *proof_len, const ZkSpecStruct *zk_spec,
+    MdocExecutor *executor) {
+  if (circuit == nullptr || mdoc == nullptr || pkx == nullptr ||
+      pky == nullptr || transcript == nullptr || attrs == nullptr ||
+      now == nullptr || prf == nullptr || proof_len == nullptr ||
+      zk_spec == nullptr) {
+    return MDOC_PROVER_NULL_INPUT;
+  }
+
+  return prove_mdoc(
+      circuit, mdoc, mdoc_len, pkx, pky, transcript, tr_len, attrs, attrs_len,
+      now, zk_spec, executor,
+      [&](size_t len, uint8_t **buf) {
+        *buf = (uint8_t *)malloc(len);
+        if (*buf == nullptr) {
+          log(ERROR, "malloc failed");
+          return MDOC_PROVER_MEMORY_ALLOCATION_FAILURE;
+        }
+        *prf = *buf;
+        return MDOC_PROVER_SUCCESS;
+      },
+      proof_len);
+}
+
+MdocProverErrorCode run_mdoc_prover_to_buffer(
+    const MdocCircuit *circuit, /* parsed circuit */
+    const uint8_t *mdoc, size_t mdoc_len, const char *pkx,
+    const char *pky,                          /* string rep of public key */
+    const uint8_t *transcript, size_t tr_len, /* session transcript */
+    const RequestedAttribute *attrs, size_t attrs_len,
+    const char *now, /* time formatted as "2023-11-02T09:00:00Z" */
+    uint8_t *prf, size_t prf_size, size_t *proof_len,
+    const ZkSpecStruct *zk_spec, MdocExecutor *executor) {
+  if (circuit == nullptr || mdoc == nullptr || pkx == nullptr ||
+      pky == nullptr || transcript == nullptr || attrs == nullptr ||
+      now == nullptr || prf == nullptr || proof_len == nullptr ||
+      zk_spec == nullptr) {
+    return MDOC_PROVER_NULL_INPUT;
+  }
+
+  return prove_mdoc(
+      circuit, mdoc, mdoc_len, pkx, pky, transcript, tr_len, attrs, attrs_len,
+      now, zk_spec, executor,
+      [&](size_t len, uint8_t **buf) {
+        if (len > prf_size) {
+          log(ERROR, "proof buffer too small: %zu < %zu", prf_size, len);
+          return MDOC_PROVER_BUFFER_TOO_SMALL;
+        }
+        *buf = prf;
+        return MDOC_PROVER_SUCCESS;
+      },
+      proof_len);
+}
+
+MdocProverErrorCode max_mdoc_proof_size(const MdocCircuit *circuit,
+                                        const ZkSpecStruct *zk_spec,
+                                        size_t *proof_len) {
+  if (circuit == nullptr || zk_spec == nullptr || proof_len == nullptr) {
+    return MDOC_PROVER_NULL_INPUT;
+  }
+  if (!hasLigeroParams(*zk_spec)) {
+    log(ERROR, "ZkSpec has no Ligero parameters");
+    return MDOC_PROVER_INVALID_ZK_SPEC_VERSION;
+  }
+
+  // The same layout as in prove_mdoc(), with the Merkle proofs and the
+  // encoding of the opened columns at their maximum sizes.
+  ZkProof<f_128> h_zk(*circuit->c_hash, zk_spec->rateinv, zk_spec->nreq,
+                      zk_spec->block_enc_hash);
+  ZkProof<Fp256Base> sig_zk(*circuit->c_sig, zk_spec->rateinv, zk_spec->nreq,
+                            zk_spec->block_enc_sig);
+  *proof_len = 6 * f_128::kBytes + h_zk.size() + sig_zk.size();
   return MDOC_PROVER_SUCCESS;
 }
 
@@ -490,128 +828,189 @@ MdocVerifierErrorCode run_mdoc_verifier(
     return MDOC_VERIFIER_INVALID_INPUT;
   }
 
-  const f_128 Fs;
-
   // Sanity check input sizes.
   if (bcsz < 50000 || tr_len < 1 || attrs_len < 1 || proof_len < 20000) {
     return MDOC_VERIFIER_ARGUMENTS_TOO_SMALL;
   }
 
-  const f2_p256 p256_2(p256_base);
-
   // Parse circuits from cached byte representation.
-  size_t len = kCircuitSizeMax;
-  std::vector<uint8_t> bytes(len);
-  size_t full_size = decompress(bytes, bcp, bcsz);
-
   // For now, we are not using the ZKSpec version anywhere and assuming no
   // backwards compatibility. As soon as we have a use case for it, we have to
   // pass the ZkSpecStruct to all required downstream functions.
-  log(INFO, "bytes len: %zu", full_size);
-
-  ReadBuffer rb_circuit(bytes.data(), full_size);
-  CircuitRep<Fp256Base> cr_s(p256_base, P256_ID);
-  auto c_sig = cr_s.from_bytes(rb_circuit, enforce_circuit_id_in_verifier);
-  if (c_sig == nullptr) {
-    log(ERROR, "signature circuit could not be parsed");
+  MdocCircuit circuit;
+  if (parse_circuits(circuit.c_sig, circuit.c_hash, bcp, bcsz,
+                     enforce_circuit_id_in_verifier) != MDOC_PROVER_SUCCESS) {
     return MDOC_VERIFIER_CIRCUIT_PARSING_FAILURE;
   }
 
-  CircuitRep<f_128> cr_h(Fs, GF2_128_ID);
-  auto c_hash = cr_h.from_bytes(rb_circuit, enforce_circuit_id_in_verifier);
+  return run_mdoc_verifier_with_handle(&circuit, pkx, pky, transcript, tr_len,
+                                       attrs, attrs_len, now, zkproof,
+                                       proof_len, docType, zk_spec);
+}
 
-  if (c_hash == nullptr) {
-    log(ERROR, "circuit could not be parsed");
-    return MDOC_VERIFIER_CIRCUIT_PARSING_FAILURE;
+MdocVerifierErrorCode run_mdoc_verifier_with_handle(
+    const MdocCircuit *circuit,               /* parsed circuit */
+    const char *pkx, const char *pky,         /* string rep of public key */
+    const uint8_t *transcript, size_t tr_len, /* session Transcript */
+    const RequestedAttribute *attrs, size_t attrs_len,
+    const char *now, /* time formatted as "2023-11-02T09:00:00Z" */
+    const uint8_t *zkproof, size_t proof_len, const char *docType,
+    const ZkSpecStruct *zk_spec) {
+  if (circuit == nullptr || pkx == nullptr || pky == nullptr ||
+      transcript == nullptr || now == nullptr || attrs == nullptr ||
+      zkproof == nullptr || docType == nullptr || zk_spec == nullptr) {
+    return MDOC_VERIFIER_NULL_INPUT;
   }
-  log(INFO, "circuit created. h[in:%zu], s[in:%zu]", c_hash->ninputs,
-      c_sig->ninputs);
 
-  // Parse proofs
-  ZkProof<f_128> pr_hash(*c_hash, kLigeroRate, kLigeroNreq,
-                         zk_spec->block_enc_hash);
-  ZkProof<Fp256Base> pr_sig(*c_sig, kLigeroRate, kLigeroNreq,
-                            zk_spec->block_enc_sig);
-
-  log(INFO,
-      "proof params: h[nl:%zu, ni:%zu], s[nl:%zu, ni:%zu] hc[b:%zu r:%zu] "
-      "sc[b:%zu r:%zu]",
-      c_hash->nl, c_hash->ninputs, c_sig->nl, c_sig->ninputs,
-      pr_hash.param.block, pr_hash.param.nrow, pr_sig.param.block,
-      pr_sig.param.nrow);
+  if (!hasLigeroParams(*zk_spec)) {
+    log(ERROR, "ZkSpec has no Ligero parameters");
+    return MDOC_VERIFIER_INVALID_ZK_SPEC_VERSION;
+  }
 
-  const std::vector<uint8_t> zbuf(zkproof, zkproof + proof_len);
-  ReadBuffer rb(zbuf);
+  Elt pkX, pkY;
+  if (!parsePk(pkx, pky, pkX, pkY)) {
+    log(ERROR, "invalid pkx, pky");
+    return MDOC_VERIFIER_INVALID_INPUT;
+  }
 
-  // Read macs from proof string.
-  // The sanity check above ensures that the proof is big enough for the MACs.
-  gf2k macs[6];
+  // Allocate on the heap because Android has a small stack.
+  auto verifier = std::make_unique<MdocVerifier>(*circuit, *zk_spec);
+  return verifier->verify(pkX, pkY, transcript, tr_len, attrs, attrs_len, now,
+                          zkproof, proof_len, docType);
+}
 
-  for (size_t i = 0; i < 6; ++i) {
-    macs[i] = Fs.of_bytes_field(rb.next(f_128::kBytes)).value();
+MdocVerifierErrorCode run_mdoc_verifier_batch(
+    const MdocCircuit *circuit,       /* parsed circuit */
+    const char *pkx, const char *pky, /* string rep of public key */
+    const MdocVerifierRequest *requests, size_t n, const char *docType,
+    const ZkSpecStruct *zk_spec, MdocVerifierErrorCode *results,
+    MdocExecutor *executor) {
+  if (circuit == nullptr || pkx == nullptr || pky == nullptr ||
+      (n > 0 && (requests == nullptr || results == nullptr)) ||
+      docType == nullptr || zk_spec == nullptr) {
+    return MDOC_VERIFIER_NULL_INPUT;
   }
 
-  // The proof read methods check proof length internally.
-  if (!pr_hash.read(rb, Fs)) {
-    log(ERROR, "hash proof could not be parsed");
-    return MDOC_VERIFIER_HASH_PARSING_FAILURE;
-  };
-  if (!pr_sig.read(rb, p256_base)) {
-    log(ERROR, "sig proof could not be parsed");
-    return MDOC_VERIFIER_SIGNATURE_PARSING_FAILURE;
-  }
-  if (rb.remaining() != 0) {
-    log(ERROR, "proof bytes contains extra data: %zu bytes", rb.remaining());
-    return MDOC_VERIFIER_SIGNATURE_PARSING_FAILURE;
+  if (!hasLigeroParams(*zk_spec)) {
+    log(ERROR, "ZkSpec has no Ligero parameters");
+    return MDOC_VERIFIER_INVALID_ZK_SPEC_VERSION;
   }
 
-  log(INFO, "proofs read");
-
-  // =============== Verify
+  Elt pkX, pkY;
+  if (!parsePk(pkx, pky, pkX, pkY)) {
+    log(ERROR, "invalid pkx, pky");
+    return MDOC_VERIFIER_INVALID_INPUT;
+  }
 
-  const Elt2 omega = p256_2.of_string(kRootX, kRootY);
-  const FftExtConvolutionFactory fft_b(p256_base, p256_2, omega, 1ull << 31);
-  const RSFactory_b rsf_b(fft_b, p256_base);
-  const RSFactory the_reed_solomon_factory(Fs);
+  auto verifier = std::make_unique<MdocVerifier>(*circuit, *zk_spec);
+
+  // Verifications are independent and read only shared const state, so
+  // they run one per task.
+  SerialExecutor serial;
+  Executor *ex = executor != nullptr ? executor : &serial;
+  ex->run(n, [&](size_t i) {
+    const MdocVerifierRequest &r = requests[i];
+    if (r.transcript == nullptr || r.attrs == nullptr || r.now == nullptr ||
+        r.zkproof == nullptr) {
+      results[i] = MDOC_VERIFIER_NULL_INPUT;
+    } else {
+      results[i] = verifier->verify(pkX, pkY, r.transcript, r.tr_len, r.attrs,
+                                    r.attrs_len, r.now, r.zkproof,
+                                    r.proof_len, docType);
+    }
+  });
 
-  ZkVerifier<f_128, RSFactory> hash_v(*c_hash, the_reed_solomon_factory,
-                                      kLigeroRate, kLigeroNreq,
-                                      zk_spec->block_enc_hash, Fs);
-  ZkVerifier<Fp256Base, RSFactory_b> sig_v(*c_sig, rsf_b, kLigeroRate,
-                                           kLigeroNreq, zk_spec->block_enc_sig,
-                                           p256_base);
+  for (size_t i = 0; i < n; ++i) {
+    if (results[i] != MDOC_VERIFIER_SUCCESS) {
+      return MDOC_VERIFIER_GENERAL_FAILURE;
+    }
+  }
+  return MDOC_VERIFIER_SUCCESS;
+}
 
-  // Use the transcript from the session to select the random oracle.
-  class Transcript tv(transcript, tr_len, zk_spec->version);
+MdocCircuit *create_mdoc_circuit(const uint8_t *bcp, size_t bcsz) {
+  if (bcp == nullptr) {
+    return nullptr;
+  }
+  auto circuit = std::make_unique<MdocCircuit>();
+  if (parse_circuits(circuit->c_sig, circuit->c_hash, bcp, bcsz,
+                     enforce_circuit_id_in_prover ||
+                         enforce_circuit_id_in_verifier) !=
+      MDOC_PROVER_SUCCESS) {
+    return nullptr;
+  }
+  return circuit.release();
+}
 
-  hash_v.recv_commitment(pr_hash, tv);
-  sig_v.recv_commitment(pr_sig, tv);
+void free_mdoc_circuit(MdocCircuit *circuit) { delete circuit; }
 
-  gf2k av = generate_mac_key(tv);
+// The image of a handle is the image of the signature circuit followed, at
+// the next multiple of kImageAlign, by the image of the hash circuit.
+CircuitGenerationErrorCode generate_circuit_image(const MdocCircuit *circuit,
+                                                  uint8_t **image,
+                                                  size_t *image_len) {
+  if (circuit == nullptr || image == nullptr || image_len == nullptr) {
+    return CIRCUIT_GENERATION_NULL_INPUT;
+  }
+  const f_128 Fs;
+  CircuitRep<Fp256Base> cr_s(p256_base, P256_ID);
+  CircuitRep<f_128> cr_h(Fs, GF2_128_ID);
+  constexpr size_t kAlign = CircuitRep<Fp256Base>::kImageAlign;
 
-  // =============== Create public inputs
-  auto pub_hash = Dense<f_128>(1, c_hash->npub_in);
-  auto pub_sig = Dense<Fp256Base>(1, c_sig->npub_in);
-  DenseFiller<f_128> hash_filler(pub_hash);
-  DenseFiller<Fp256Base> sig_filler(pub_sig);
+  std::vector<uint8_t> sig, hash;
+  cr_s.to_image(*circuit->c_sig, sig);
+  cr_h.to_image(*circuit->c_hash, hash);
+  size_t off = ceildiv(sig.size(), kAlign) * kAlign;
+  size_t len = off + hash.size();
 
-  size_t dlen = strlen(docType);
-  if (!fill_public_inputs(sig_filler, hash_filler, pkX, pkY, transcript, tr_len,
-                          attrs, attrs_len, (const uint8_t *)now,
-                          (const uint8_t *)docType, dlen, macs, av, Fs,
-                          zk_spec->version)) {
-    return MDOC_VERIFIER_GENERAL_FAILURE;
+  *image = (uint8_t *)malloc(len);
+  if (*image == nullptr) {
+    log(ERROR, "malloc failed");
+    return CIRCUIT_GENERATION_GENERAL_FAILURE;
   }
+  memset(*image, 0, len);
+  memcpy(*image, sig.data(), sig.size());
+  memcpy(*image + off, hash.data(), hash.size());
+  *image_len = len;
+  return CIRCUIT_GENERATION_SUCCESS;
+}
 
-  if (hash_filler.size() != c_hash->npub_in ||
-      sig_filler.size() != c_sig->npub_in) {
-    return MDOC_VERIFIER_ATTRIBUTE_NUMBER_MISMATCH;
+MdocCircuit *create_mdoc_circuit_from_image(const uint8_t *image,
+                                            size_t image_len,
+                                            int verify_checksum) {
+  if (image == nullptr) {
+    return nullptr;
   }
-
-  bool ok = hash_v.verify(pr_hash, pub_hash, tv);
-  bool ok2 = sig_v.verify(pr_sig, pub_sig, tv);
-
-  return ok && ok2 ? MDOC_VERIFIER_SUCCESS : MDOC_VERIFIER_GENERAL_FAILURE;
+  const f_128 Fs;
+  CircuitRep<Fp256Base> cr_s(p256_base, P256_ID);
+  CircuitRep<f_128> cr_h(Fs, GF2_128_ID);
+  constexpr size_t kAlign = CircuitRep<Fp256Base>::kImageAlign;
+  const bool enforce_circuit_id =
+      enforce_circuit_id_in_prover || enforce_circuit_id_in_verifier;
+
+  auto circuit = std::make_unique<MdocCircuit>();
+  circuit->c_sig =
+      cr_s.from_image(image, image_len, /*owner=*/nullptr, enforce_circuit_id,
+                      verify_checksum != 0);
+  if (circuit->c_sig == nullptr) {
+    log(ERROR, "signature circuit image could not be loaded");
+    return nullptr;
+  }
+
+  size_t off = ceildiv(CircuitRep<Fp256Base>::image_size(image, image_len),
+                       kAlign) *
+               kAlign;
+  if (off > image_len) {
+    return nullptr;
+  }
+  circuit->c_hash = cr_h.from_image(image + off, image_len - off,
+                                    /*owner=*/nullptr, enforce_circuit_id,
+                                    verify_checksum != 0);
+  if (circuit->c_hash == nullptr) {
+    log(ERROR, "hash circuit image could not be loaded");
+    return nullptr;
+  }
+  return circuit.release();
 }
 
 } /* extern "C" */
@@ -19,6 +19,10 @@
 #include <stdint.h>
 
 #ifdef __cplusplus
+namespace proofs {
+class Executor;
+}  // namespace proofs
+
 extern "C" {
 #endif
 
@@ -30,6 +34,9 @@ extern "C" {
 // for example age_over_18. The circuit generation can be run once, and the
 // result cached for subsequent use in the prover and verifier.
 
+// Ligero parameters of the standard ZkSpec profile.  Each ZkSpecStruct
+// carries its own rateinv and nreq, and profiles with another rate
+// choose nreq to keep the same statistical security.
 const size_t kLigeroRate = 4;
 const size_t kLigeroNreq = 128;  // 86+ bits statistical security
 
@@ -54,6 +61,7 @@ typedef enum {
   MDOC_PROVER_GENERAL_FAILURE,
   MDOC_PROVER_MEMORY_ALLOCATION_FAILURE,
   MDOC_PROVER_INVALID_ZK_SPEC_VERSION,
+  MDOC_PROVER_BUFFER_TOO_SMALL,
 } MdocProverErrorCode;
 
 // Return codes for the run_mdoc2_verifier method.
@@ -98,6 +106,10 @@ typedef struct {
   size_t version;
   // The block_enc parameter for the ZK proof.
   size_t block_enc_hash, block_enc_sig;
+  // The inverse rate of the Reed-Solomon code and the number of opened
+  // columns of both Ligero commitments.  A lower rateinv makes the
+  // prover faster at the cost of a larger nreq and thus a larger proof.
+  size_t rateinv, nreq;
 } ZkSpecStruct;
 
 static const char kDefaultDocType[] = "org.iso.18013.5.1.mDL";
@@ -145,6 +157,130 @@ MdocVerifierErrorCode run_mdoc_verifier(
     const uint8_t* zkproof, size_t proof_len, const char* docType,
     const ZkSpecStruct* zk_spec_version);
 
+// Opaque handle to a pair of decompressed and parsed circuits.  A handle is
+// immutable once created, and it can be shared by any number of concurrent
+// calls to run_mdoc_prover_with_handle() and run_mdoc_verifier_with_handle().
+// Applications that prove or verify many times against the same circuit
+// should create one handle per circuit and reuse it, which avoids paying
+// the cost of decompression and parsing on every call.
+typedef struct MdocCircuit MdocCircuit;
+
+// Decompresses and parses the circuit bytes bcp.  Returns nullptr if the
+// circuit cannot be parsed.  The caller owns the handle and must release it
+// with free_mdoc_circuit() after all calls that use it have returned.
+MdocCircuit* create_mdoc_circuit(const uint8_t* bcp, size_t bcsz);
+
+void free_mdoc_circuit(MdocCircuit* circuit);
+
+// Writes the circuits of the handle as one image into a buffer allocated
+// with malloc(), which the caller must free.  The image stores the circuits
+// in their in-memory layout, so that create_mdoc_circuit_from_image() can use
+// it in place without decompression or parsing.  An image is specific to the
+// build that wrote it, and is meant to be cached on the device, e.g. in a
+// file that is later memory-mapped.
+CircuitGenerationErrorCode generate_circuit_image(const MdocCircuit* circuit,
+                                                  uint8_t** image,
+                                                  size_t* image_len);
+
+// Returns a handle whose circuits point into the image of IMAGE_LEN bytes
+// written by generate_circuit_image(), or nullptr if the image is malformed or
+// was written by an incompatible build.  IMAGE must be aligned at least as
+// malloc() aligns memory, which also holds for mmap(), and it must remain
+// valid and unchanged until the handle is released with free_mdoc_circuit().
+// If VERIFY_CHECKSUM is nonzero, the checksums of the image are verified,
+// which reads the whole image once.
+MdocCircuit* create_mdoc_circuit_from_image(const uint8_t* image,
+                                            size_t image_len,
+                                            int verify_checksum);
+
+// Executor on which the prover and the batch verifier run their parallel work.
+// From C++ this is a proofs::Executor owned by the caller, e.g. a
+// proofs::ThreadPool that is shared by all calls in the process.  The library
+// never creates threads on its own: when the executor is NULL, as it must be
+// for callers in C, the work runs serially in the calling thread.  Neither
+// proofs nor verification results depend on the executor.
+#ifdef __cplusplus
+typedef proofs::Executor MdocExecutor;
+#else
+typedef struct MdocExecutor MdocExecutor;
+#endif
+
+// Same as run_mdoc_prover(), but using a circuit handle in place of the
+// compressed circuit bytes.  If EXECUTOR is not NULL, the hash and signature
+// provers run concurrently on it between Fiat-Shamir points.
+MdocProverErrorCode run_mdoc_prover_with_handle(
+    const MdocCircuit* circuit,               /* parsed circuit */
+    const uint8_t* mdoc, size_t mdoc_len,     /* full mdoc */
+    const char* pkx, const char* pky,         /* string rep of public key */
+    const uint8_t* transcript, size_t tr_len, /* session transcript */
+    const RequestedAttribute* attrs, size_t attrs_len,
+    const char* now, /* time formatted as "2023-11-02T09:00:00Z" */
+    uint8_t** prf, size_t* proof_len, const ZkSpecStruct* zk_spec_version,
+    MdocExecutor* executor);
+
+// Sets *PROOF_LEN to an upper bound on the length of the proofs produced
+// with the circuit handle and ZkSpec.  The exact length depends on the
+// random choices of the prover, and is smaller because the Merkle proofs
+// are batched.
+MdocProverErrorCode max_mdoc_proof_size(const MdocCircuit* circuit,
+                                        const ZkSpecStruct* zk_spec_version,
+                                        size_t* proof_len);
+
+// Same as run_mdoc_prover_with_handle(), but writes the proof into the
+// caller's buffer PRF of PRF_SIZE bytes instead of allocating it, so that
+// a buffer of max_mdoc_proof_size() bytes can be reused for many proofs.
+// Sets *PROOF_LEN to the length of the proof.  If the proof does not fit,
+// returns MDOC_PROVER_BUFFER_TOO_SMALL with *PROOF_LEN set to the length
+// that it needs.
+MdocProverErrorCode run_mdoc_prover_to_buffer(
+    const MdocCircuit* circuit,               /* parsed circuit */
+    const uint8_t* mdoc, size_t mdoc_len,     /* full mdoc */
+    const char* pkx, const char* pky,         /* string rep of public key */
+    const uint8_t* transcript, size_t tr_len, /* session transcript */
+    const RequestedAttribute* attrs, size_t attrs_len,
+    const char* now, /* time formatted as "2023-11-02T09:00:00Z" */
+    uint8_t* prf, size_t prf_size, size_t* proof_len,
+    const ZkSpecStruct* zk_spec_version, MdocExecutor* executor);
+
+// Same as run_mdoc_verifier(), but using a circuit handle in place of the
+// compressed circuit bytes.
+MdocVerifierErrorCode run_mdoc_verifier_with_handle(
+    const MdocCircuit* circuit,               /* parsed circuit */
+    const char* pkx, const char* pky,         /* string rep of public key */
+    const uint8_t* transcript, size_t tr_len, /* session transcript */
+    const RequestedAttribute* attrs, size_t attrs_len,
+    const char* now, /* time formatted as "2023-11-02T09:00:00Z" */
+    const uint8_t* zkproof, size_t proof_len, const char* docType,
+    const ZkSpecStruct* zk_spec_version);
+
+// One proof to be verified by run_mdoc_verifier_batch(), together with the
+// inputs that differ from proof to proof.
+typedef struct {
+  const uint8_t* transcript; /* session transcript */
+  size_t tr_len;
+  const RequestedAttribute* attrs;
+  size_t attrs_len;
+  const char* now; /* time formatted as "2023-11-02T09:00:00Z" */
+  const uint8_t* zkproof;
+  size_t proof_len;
+} MdocVerifierRequest;
+
+// Verifies the N proofs in REQUESTS against the same circuit, issuer public
+// key, docType and ZkSpec.  The work that depends only on the circuit and the
+// ZkSpec is done once for the whole batch, and the proofs are verified
+// concurrently on EXECUTOR, or one after the other if EXECUTOR is NULL.  The
+// outcome of verifying requests[i] is stored in results[i], and is the code
+// that run_mdoc_verifier_with_handle() would return for it.  Returns
+// MDOC_VERIFIER_SUCCESS if all N proofs verify, MDOC_VERIFIER_GENERAL_FAILURE
+// if any of them fails, or an error about the shared arguments, in which case
+// RESULTS is not written.
+MdocVerifierErrorCode run_mdoc_verifier_batch(
+    const MdocCircuit* circuit,       /* parsed circuit */
+    const char* pkx, const char* pky, /* string rep of public key */
+    const MdocVerifierRequest* requests, size_t n, const char* docType,
+    const ZkSpecStruct* zk_spec_version, MdocVerifierErrorCode* results,
+    MdocExecutor* executor);
+
 // Produces a compressed version of the circuit bytes for the specified number
 // of attributes. The generator only supports the latest version of the ZKSpec
 // for a number of attributes. Attempt to generate older circuits will result in
@@ -160,7 +296,7 @@ CircuitGenerationErrorCode generate_circuit(const ZkSpecStruct* zk_spec_version,
 int circuit_id(uint8_t id[/*kSHA256DigestSize*/], const uint8_t* bcp,
                size_t bcsz, const ZkSpecStruct* zk_spec);
 
-enum { kNumZkSpecs = 16 };
+enum { kNumZkSpecs = 24 };
 // This is a hardcoded list of all the ZK specifications supported by this
 // library. Every time a new breaking change is introduced in either the circuit
 // format or its interpretation, a new version must be added here.
@@ -20,11 +20,13 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <vector>
 
 #include "circuits/mdoc/mdoc_examples.h"
 #include "circuits/mdoc/mdoc_test_attributes.h"
 #include "random/secure_random_engine.h"
 #include "util/log.h"
+#include "util/thread_pool.h"
 #include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
@@ -144,6 +146,218 @@ TEST_F(MdocZKTest, one_claim) {
   }
 }
 
+TEST_F(MdocZKTest, circuit_handle) {
+  EXPECT_EQ(create_mdoc_circuit(nullptr, circuit_len1_), nullptr);
+  EXPECT_EQ(create_mdoc_circuit(circuit1_, 10), nullptr);
+
+  // Parse the circuit once and reuse it for several proofs, which run
+  // serially and on a caller-owned pool respectively.
+  MdocCircuit* circuit = create_mdoc_circuit(circuit1_, circuit_len1_);
+  ASSERT_NE(circuit, nullptr);
+  ThreadPool pool(2);
+  Executor* executors[] = {nullptr, &pool};
+
+  const Claims tests[] = {
+      {"+18-mdoc[0]", {test::age_over_18}, &mdoc_tests[0]},
+      {"height_175-mdoc[3]", {test::height_175}, &mdoc_tests[3]},
+  };
+  for (size_t i = 0; i < 2; ++i) {
+    const Claims& t = tests[i];
+    const MdocTests* test = t.mdoc;
+    uint8_t* zkproof;
+    size_t proof_len;
+    EXPECT_EQ(run_mdoc_prover_with_handle(
+                  circuit, test->mdoc, test->mdoc_size, test->pkx.as_pointer,
+                  test->pky.as_pointer, test->transcript,
+                  test->transcript_size, t.claims, 1, (const char*)test->now,
+                  &zkproof, &proof_len, &kZkSpecs[0], executors[i]),
+              MDOC_PROVER_SUCCESS);
+
+    // Proofs produced with a handle verify with the byte-based API and
+    // vice versa.
+    EXPECT_EQ(run_mdoc_verifier(circuit1_, circuit_len1_, test->pkx.as_pointer,
+                                test->pky.as_pointer, test->transcript,
+                                test->transcript_size, t.claims, 1,
+                                (const char*)test->now, zkproof, proof_len,
+                                test->doc_type, &kZkSpecs[0]),
+              MDOC_VERIFIER_SUCCESS);
+    EXPECT_EQ(run_mdoc_verifier_with_handle(
+                  circuit, test->pkx.as_pointer, test->pky.as_pointer,
+                  test->transcript, test->transcript_size, t.claims, 1,
+                  (const char*)test->now, zkproof, proof_len, test->doc_type,
+                  &kZkSpecs[0]),
+              MDOC_VERIFIER_SUCCESS);
+    free(zkproof);
+  }
+
+  EXPECT_EQ(run_mdoc_verifier_with_handle(
+                nullptr, mdoc_tests[0].pkx.as_pointer,
+                mdoc_tests[0].pky.as_pointer, mdoc_tests[0].transcript,
+                mdoc_tests[0].transcript_size, tests[0].claims, 1,
+                (const char*)mdoc_tests[0].now, mdoc_tests[0].mdoc,
+                mdoc_tests[0].mdoc_size, mdoc_tests[0].doc_type, &kZkSpecs[0]),
+            MDOC_VERIFIER_NULL_INPUT);
+
+  free_mdoc_circuit(circuit);
+}
+
+TEST_F(MdocZKTest, proof_to_buffer) {
+  MdocCircuit* circuit = create_mdoc_circuit(circuit1_, circuit_len1_);
+  ASSERT_NE(circuit, nullptr);
+  size_t max_len;
+  EXPECT_EQ(max_mdoc_proof_size(nullptr, &kZkSpecs[0], &max_len),
+            MDOC_PROVER_NULL_INPUT);
+  ASSERT_EQ(max_mdoc_proof_size(circuit, &kZkSpecs[0], &max_len),
+            MDOC_PROVER_SUCCESS);
+
+  // One buffer of the maximum size holds any proof.
+  const MdocTests* test = &mdoc_tests[0];
+  const RequestedAttribute claims[] = {test::age_over_18};
+  std::vector<uint8_t> buf(max_len);
+  for (size_t i = 0; i < 2; ++i) {
+    size_t proof_len;
+    EXPECT_EQ(run_mdoc_prover_to_buffer(
+                  circuit, test->mdoc, test->mdoc_size, test->pkx.as_pointer,
+                  test->pky.as_pointer, test->transcript, test->transcript_size,
+                  claims, 1, (const char*)test->now, buf.data(), buf.size(),
+                  &proof_len, &kZkSpecs[0], /*executor=*/nullptr),
+              MDOC_PROVER_SUCCESS);
+    EXPECT_LE(proof_len, max_len);
+    EXPECT_EQ(run_mdoc_verifier_with_handle(
+                  circuit, test->pkx.as_pointer, test->pky.as_pointer,
+                  test->transcript, test->transcript_size, claims, 1,
+                  (const char*)test->now, buf.data(), proof_len,
+                  test->doc_type, &kZkSpecs[0]),
+              MDOC_VERIFIER_SUCCESS);
+  }
+
+  // A buffer that is too small reports the length that the proof needs.
+  size_t proof_len = 0;
+  EXPECT_EQ(run_mdoc_prover_to_buffer(
+                circuit, test->mdoc, test->mdoc_size, test->pkx.as_pointer,
+                test->pky.as_pointer, test->transcript, test->transcript_size,
+                claims, 1, (const char*)test->now, buf.data(), 1000,
+                &proof_len, &kZkSpecs[0], /*executor=*/nullptr),
+            MDOC_PROVER_BUFFER_TOO_SMALL);
+  EXPECT_GT(proof_len, 1000u);
+  EXPECT_LE(proof_len, max_len);
+
+  free_mdoc_circuit(circuit);
+}
+
+TEST_F(MdocZKTest, circuit_image) {
+  MdocCircuit* circuit = create_mdoc_circuit(circuit1_, circuit_len1_);
+  ASSERT_NE(circuit, nullptr);
+  uint8_t* image;
+  size_t image_len;
+  EXPECT_EQ(generate_circuit_image(circuit, &image, &image_len),
+            CIRCUIT_GENERATION_SUCCESS);
+  free_mdoc_circuit(circuit);
+
+  EXPECT_EQ(create_mdoc_circuit_from_image(image, image_len - 1, 1), nullptr);
+  image[image_len - 1] ^= 1;
+  EXPECT_EQ(create_mdoc_circuit_from_image(image, image_len, 1), nullptr);
+  image[image_len - 1] ^= 1;
+
+  // A handle loaded from the image proves and verifies like one parsed
+  // from the compressed bytes.
+  MdocCircuit* mapped = create_mdoc_circuit_from_image(image, image_len, 1);
+  ASSERT_NE(mapped, nullptr);
+  const MdocTests* test = &mdoc_tests[0];
+  const RequestedAttribute attrs[] = {test::age_over_18};
+  uint8_t* zkproof;
+  size_t proof_len;
+  EXPECT_EQ(run_mdoc_prover_with_handle(
+                mapped, test->mdoc, test->mdoc_size, test->pkx.as_pointer,
+                test->pky.as_pointer, test->transcript, test->transcript_size,
+                attrs, 1, (const char*)test->now, &zkproof, &proof_len,
+                &kZkSpecs[0], /*executor=*/nullptr),
+            MDOC_PROVER_SUCCESS);
+  EXPECT_EQ(run_mdoc_verifier(circuit1_, circuit_len1_, test->pkx.as_pointer,
+                              test->pky.as_pointer, test->transcript,
+                              test->transcript_size, attrs, 1,
+                              (const char*)test->now, zkproof, proof_len,
+                              test->doc_type, &kZkSpecs[0]),
+            MDOC_VERIFIER_SUCCESS);
+  EXPECT_EQ(run_mdoc_verifier_with_handle(
+                mapped, test->pkx.as_pointer, test->pky.as_pointer,
+                test->transcript, test->transcript_size, attrs, 1,
+                (const char*)test->now, zkproof, proof_len, test->doc_type,
+                &kZkSpecs[0]),
+            MDOC_VERIFIER_SUCCESS);
+  free(zkproof);
+  free_mdoc_circuit(mapped);
+  free(image);
+}
+
+TEST_F(MdocZKTest, verifier_batch) {
+  MdocCircuit* circuit = create_mdoc_circuit(circuit1_, circuit_len1_);
+  ASSERT_NE(circuit, nullptr);
+  ThreadPool pool(3);
+
+  const MdocTests* test = &mdoc_tests[0];
+  const RequestedAttribute attrs[] = {test::age_over_18};
+
+  // Two proofs of the same claim, each one verified twice, and a
+  // truncated and a corrupted proof.
+  constexpr size_t kNumProofs = 2;
+  uint8_t* zkproof[kNumProofs];
+  size_t proof_len[kNumProofs];
+  for (size_t i = 0; i < kNumProofs; ++i) {
+    EXPECT_EQ(run_mdoc_prover_with_handle(
+                  circuit, test->mdoc, test->mdoc_size, test->pkx.as_pointer,
+                  test->pky.as_pointer, test->transcript,
+                  test->transcript_size, attrs, 1, (const char*)test->now,
+                  &zkproof[i], &proof_len[i], &kZkSpecs[0],
+                  /*executor=*/nullptr),
+              MDOC_PROVER_SUCCESS);
+  }
+  std::vector<uint8_t> corrupted(zkproof[1], zkproof[1] + proof_len[1]);
+  corrupted[proof_len[1] / 2] ^= 1;
+
+  MdocVerifierRequest requests[6];
+  for (size_t i = 0; i < 6; ++i) {
+    requests[i] = {test->transcript,      test->transcript_size,
+                   attrs,                 1,
+                   (const char*)test->now, zkproof[i % kNumProofs],
+                   proof_len[i % kNumProofs]};
+  }
+  requests[4].proof_len -= 1;
+  requests[5].zkproof = corrupted.data();
+
+  // The results are the same with and without a pool.
+  for (Executor* executor : {static_cast<Executor*>(&pool),
+                             static_cast<Executor*>(nullptr)}) {
+    MdocVerifierErrorCode results[6];
+    EXPECT_EQ(run_mdoc_verifier_batch(circuit, test->pkx.as_pointer,
+                                      test->pky.as_pointer, requests, 6,
+                                      test->doc_type, &kZkSpecs[0], results,
+                                      executor),
+              MDOC_VERIFIER_GENERAL_FAILURE);
+    for (size_t i = 0; i < 4; ++i) {
+      EXPECT_EQ(results[i], MDOC_VERIFIER_SUCCESS);
+    }
+    EXPECT_NE(results[4], MDOC_VERIFIER_SUCCESS);
+    EXPECT_NE(results[5], MDOC_VERIFIER_SUCCESS);
+
+    EXPECT_EQ(run_mdoc_verifier_batch(circuit, test->pkx.as_pointer,
+                                      test->pky.as_pointer, requests, 4,
+                                      test->doc_type, &kZkSpecs[0], results,
+                                      executor),
+              MDOC_VERIFIER_SUCCESS);
+    EXPECT_EQ(run_mdoc_verifier_batch(nullptr, test->pkx.as_pointer,
+                                      test->pky.as_pointer, requests, 4,
+                                      test->doc_type, &kZkSpecs[0], results,
+                                      executor),
+              MDOC_VERIFIER_NULL_INPUT);
+  }
+
+  for (size_t i = 0; i < kNumProofs; ++i) {
+    free(zkproof[i]);
+  }
+  free_mdoc_circuit(circuit);
+}
+
 TEST_F(MdocZKTest, long_attribute) {
   uint8_t* zkproof;
   size_t proof_len;
@@ -275,6 +489,66 @@ TEST_F(MdocZKTest, wrong_witness) {
   }
 }
 
+// Profiles of a circuit with other Ligero parameters prove and verify,
+// and a proof under one profile does not verify under another.
+TEST_F(MdocZKTest, profiles) {
+  const ZkSpecStruct& standard = kZkSpecs[0];
+  const MdocTests* test = &mdoc_tests[0];
+  const RequestedAttribute attrs[] = {test::age_over_18};
+
+  for (const char* system :
+       {"longfellow-libzk-v1-fast-prover", "longfellow-libzk-v1-small-proof"}) {
+    const ZkSpecStruct* zk_spec = find_zk_spec(system, standard.circuit_hash);
+    ASSERT_NE(zk_spec, nullptr);
+    log(INFO, "========== Test profile %s", system);
+
+    uint8_t* zkproof;
+    size_t proof_len;
+    EXPECT_EQ(run_mdoc_prover(circuit1_, circuit_len1_, test->mdoc,
+                              test->mdoc_size, test->pkx.as_pointer,
+                              test->pky.as_pointer, test->transcript,
+                              test->transcript_size, attrs, 1,
+                              (const char*)test->now, &zkproof, &proof_len,
+                              zk_spec),
+              MDOC_PROVER_SUCCESS);
+
+    EXPECT_EQ(run_mdoc_verifier(circuit1_, circuit_len1_, test->pkx.as_pointer,
+                                test->pky.as_pointer, test->transcript,
+                                test->transcript_size, attrs, 1,
+                                (const char*)test->now, zkproof, proof_len,
+                                test->doc_type, zk_spec),
+              MDOC_VERIFIER_SUCCESS);
+    EXPECT_NE(run_mdoc_verifier(circuit1_, circuit_len1_, test->pkx.as_pointer,
+                                test->pky.as_pointer, test->transcript,
+                                test->transcript_size, attrs, 1,
+                                (const char*)test->now, zkproof, proof_len,
+                                test->doc_type, &standard),
+              MDOC_VERIFIER_SUCCESS);
+    free(zkproof);
+  }
+
+  // A ZkSpec without Ligero parameters is rejected.
+  ZkSpecStruct no_params = standard;
+  no_params.rateinv = 0;
+  no_params.nreq = 0;
+  uint8_t* zkproof = nullptr;
+  size_t proof_len = 0;
+  EXPECT_EQ(run_mdoc_prover(circuit1_, circuit_len1_, test->mdoc,
+                            test->mdoc_size, test->pkx.as_pointer,
+                            test->pky.as_pointer, test->transcript,
+                            test->transcript_size, attrs, 1,
+                            (const char*)test->now, &zkproof, &proof_len,
+                            &no_params),
+            MDOC_PROVER_INVALID_ZK_SPEC_VERSION);
+  uint8_t proof[30000] = {0};
+  EXPECT_EQ(run_mdoc_verifier(circuit1_, circuit_len1_, test->pkx.as_pointer,
+                              test->pky.as_pointer, test->transcript,
+                              test->transcript_size, attrs, 1,
+                              (const char*)test->now, proof, sizeof(proof),
+                              test->doc_type, &no_params),
+            MDOC_VERIFIER_INVALID_ZK_SPEC_VERSION);
+}
+
 TEST_F(MdocZKTest, bad_arguments) {
   constexpr int num_attrs = 1;
   const ZkSpecStruct& zk_spec_1 = kZkSpecs[0];
@@ -40,63 +40,100 @@ extern "C" {
 //     values.
 //   - block_enc_sig. block_enc parameter for the ZK proof of the signature
 //     component.
+//   - rateinv, nreq. Inverse rate of the Reed-Solomon code and number of
+//     opened columns of both Ligero commitments.
 // }
+//
+// Entries that share a circuit with other Ligero parameters are profiles
+// of that circuit, distinguished by their system name.  All profiles aim
+// for the same statistical security as kLigeroNreq = 128 queries at
+// kLigeroRate = 4, that is, nreq * log2(2 * rateinv / (rateinv + 1)) >= 86.8.
 
 const ZkSpecStruct kZkSpecs[kNumZkSpecs] = {
     // Circuits produced on 2025-10-10
     {"longfellow-libzk-v1",
      "137e5a75ce72735a37c8a72da1a8a0a5df8d13365c2ae3d2c2bd6a0e7197c7c6", 1, 6,
-     4096, 2945},
+     4096, 2945, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "b4bb6f01b7043f4f51d8302a30b36e3d4d2d0efc3c24557ab9212ad524a9764e", 2, 6,
-     4025, 2945},
+     4025, 2945, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "b2211223b954b34a1081e3fbf71b8ea2de28efc888b4be510f532d6ba76c2010", 3, 6,
-     4121, 2945},
+     4121, 2945, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "c70b5f44a1365c53847eb8948ad5b4fdc224251a2bc02d958c84c862823c49d6", 4, 6,
-     4283, 2945},
+     4283, 2945, kLigeroRate, kLigeroNreq},
+    // Fast-prover profile of the 2025-10-10 circuits: rate 1/2 roughly
+    // halves the Ligero time of the signature proof, for a proof about
+    // 45% larger.  Suited to server-side proving.
+    {"longfellow-libzk-v1-fast-prover",
+     "137e5a75ce72735a37c8a72da1a8a0a5df8d13365c2ae3d2c2bd6a0e7197c7c6", 1, 6,
+     3651, 1979, 2, 210},
+    {"longfellow-libzk-v1-fast-prover",
+     "b4bb6f01b7043f4f51d8302a30b36e3d4d2d0efc3c24557ab9212ad524a9764e", 2, 6,
+     3695, 1979, 2, 210},
+    {"longfellow-libzk-v1-fast-prover",
+     "b2211223b954b34a1081e3fbf71b8ea2de28efc888b4be510f532d6ba76c2010", 3, 6,
+     3815, 1979, 2, 210},
+    {"longfellow-libzk-v1-fast-prover",
+     "c70b5f44a1365c53847eb8948ad5b4fdc224251a2bc02d958c84c862823c49d6", 4, 6,
+     3903, 1979, 2, 210},
+    // Small-proof profile of the 2025-10-10 circuits: rate 1/8 saves
+    // about 13% of the proof, for roughly twice the Ligero prover time.
+    // Suited to slow links.
+    {"longfellow-libzk-v1-small-proof",
+     "137e5a75ce72735a37c8a72da1a8a0a5df8d13365c2ae3d2c2bd6a0e7197c7c6", 1, 6,
+     5119, 4379, 8, 105},
+    {"longfellow-libzk-v1-small-proof",
+     "b4bb6f01b7043f4f51d8302a30b36e3d4d2d0efc3c24557ab9212ad524a9764e", 2, 6,
+     5119, 4379, 8, 105},
+    {"longfellow-libzk-v1-small-proof",
+     "b2211223b954b34a1081e3fbf71b8ea2de28efc888b4be510f532d6ba76c2010", 3, 6,
+     5119, 4379, 8, 105},
+    {"longfellow-libzk-v1-small-proof",
+     "c70b5f44a1365c53847eb8948ad5b4fdc224251a2bc02d958c84c862823c49d6", 4, 6,
+     5119, 4379, 8, 105},
     // Circuits produced on 2025-08-21
     {"longfellow-libzk-v1",
      "f88a39e561ec0be02bb3dfe38fb609ad154e98decbbe632887d850fc612fea6f", 1, 5,
-     4096, 2945},
+     4096, 2945, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "f51b7248b364462854d306326abded169854697d752d3bb6d9a9446ff7605ddb", 2, 5,
-     4025, 2945},
+     4025, 2945, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "c27195e03e22c9ab4efe9e1dabd2c33aa8b2429cc4e86410c6f12542d3c5e0a1", 3, 5,
-     4121, 2945},
+     4121, 2945, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "fa5fadfb2a916d3b71144e9b412eff78f71fd6a6d4607eac10de66b195868b7a", 4, 5,
-     4283, 2945},
+     4283, 2945, kLigeroRate, kLigeroNreq},
 
     // Circuits produced on 2025-07-22.
     {"longfellow-libzk-v1",
      "89288b9aa69d2120d211618fcca8345deb4f85d2e710c220cc9c059bbee4c91f", 1, 4,
-     4096, 4096},
+     4096, 4096, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "d260f7ef1bc82a25ad174d61a9611ba4a6e0c8f2f8520d2b6ea1549c79abcd55", 2, 4,
-     4096, 4096},
+     4096, 4096, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "77aa19bdb547b68a30deb37b94d3a506222a455806afcddda88d591493e9a689", 3, 4,
-     4096, 4096},
+     4096, 4096, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "31bc7c86c71871dad73619e7da7c5a379221602a3f28ea991b05da1ef656d13c", 4, 4,
-     4096, 4096},
+     4096, 4096, kLigeroRate, kLigeroNreq},
 
     // Circuits produced on 2025-06-13
     {"longfellow-libzk-v1",
      "bd3168ea0a9096b4f7b9b61d1c210dac1b7126a9ec40b8bc770d4d485efce4e9", 1, 3,
-     4096, 4096},
+     4096, 4096, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "40b2b68088f1d4c93a42edf01330fed8cac471cdae2b192b198b4d4fc41c9083", 2, 3,
-     4096, 4096},
+     4096, 4096, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "99a5da3739df68c87c7a380cc904bb275dbd4f1b916c3d297ba9d15ee86dd585", 3, 3,
-     4096, 4096},
+     4096, 4096, kLigeroRate, kLigeroNreq},
     {"longfellow-libzk-v1",
      "5249dac202b61e03361a2857867297ee7b1d96a8a4c477d15a4560bde29f704f", 4, 3,
-     4096, 4096},
+     4096, 4096, kLigeroRate, kLigeroNreq},
 };
 
 const ZkSpecStruct *find_zk_spec(const char *system_name,
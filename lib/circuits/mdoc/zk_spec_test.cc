@@ -14,6 +14,7 @@
 
 #include <sys/types.h>
 
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -54,6 +55,33 @@ TEST(ZkSpecTest, ReturnNullptrIfNoMatchingZkSpecFound) {
   EXPECT_EQ(zk_spec, nullptr);
 }
 
+TEST(ZkSpecTest, FindProfiles) {
+  const ZkSpecStruct& standard = kZkSpecs[0];
+  for (const char* system :
+       {"longfellow-libzk-v1-fast-prover", "longfellow-libzk-v1-small-proof"}) {
+    const ZkSpecStruct* zk_spec = find_zk_spec(system, standard.circuit_hash);
+    ASSERT_NE(zk_spec, nullptr);
+    EXPECT_STREQ(zk_spec->system, system);
+    EXPECT_EQ(zk_spec->num_attributes, standard.num_attributes);
+    EXPECT_EQ(zk_spec->version, standard.version);
+    EXPECT_NE(zk_spec->rateinv, standard.rateinv);
+  }
+}
+
+// Every profile must be at least as sound as the standard Ligero
+// parameters.
+TEST(ZkSpecTest, LigeroSoundness) {
+  auto bits = [](size_t rateinv, size_t nreq) {
+    return nreq * std::log2(2.0 * rateinv / (rateinv + 1));
+  };
+  const double want = bits(kLigeroRate, kLigeroNreq);
+  for (size_t k = 0; k < kNumZkSpecs; ++k) {
+    const ZkSpecStruct& zk_spec = kZkSpecs[k];
+    EXPECT_GE(bits(zk_spec.rateinv, zk_spec.nreq), want)
+        << zk_spec.system << " " << zk_spec.circuit_hash;
+  }
+}
+
 void test_circuit_hash(size_t num_attributes) {
   // Find the latest version of the circuit for the given number of attributes.
   const ZkSpecStruct* zk_spec = nullptr;
@@ -216,6 +216,19 @@ class GF2_128 {
   void neg(Elt& a) const { /* noop */ }
   void invert(Elt& a) const { a = invertf(a); }
 
+  // Lazy reduction of sums of products.  An Accum holds the unreduced
+  // 256-bit carry-less sum, which reduce_accum() reduces once.  A
+  // value-initialized Accum is zero.
+  struct Accum {
+    N t[3];
+  };
+  void mac(Accum& s, const Elt& x, const Elt& y) const {
+    gf2_128_mul_accum(s.t, x.n, y.n);
+  }
+  Elt reduce_accum(const Accum& s) const {
+    return Elt{gf2_128_reduce_accum(s.t)};
+  }
+
   Elt zero() const { return Elt{}; }
   Elt one() const { return kone_; }
   Elt mone() const { return kone_; }
@@ -139,6 +139,21 @@ TEST(GF2_128, Mul) {
   }
 }
 
+TEST(GF2_128, Accum) {
+  Bogorng<Field> rng(&F);
+  ref_gf2_128 one = {1, 0};
+  Field::Accum s{};
+  Elt want = F.zero();
+  for (size_t i = 0; i < 129; ++i) {
+    // include the monomials that exercise every reduction path
+    Elt x = of_ref(ref_gf2_128_shl(one, i));
+    Elt y = rng.next();
+    F.mac(s, x, y);
+    F.add(want, F.mulf(x, y));
+    EXPECT_EQ(F.reduce_accum(s), want);
+  }
+}
+
 TEST(GF2_128, PolyEvaluationPoint) {
   constexpr size_t N = Field::kNPolyEvaluationPoints;
   for (size_t i = 0; i < N; i++) {
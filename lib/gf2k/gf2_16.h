@@ -0,0 +1,176 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_GF2K_GF2_16_H_
+#define PRIVACY_PROOFS_ZK_LIB_GF2K_GF2_16_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "util/panic.h"
+
+namespace proofs {
+
+// The subfield GF(2^16) of a binary field BigField with
+// kSubFieldBits = 16, such as GF2_128<4>, in compact form.
+//
+// An element is represented by its 16 coordinates with respect to the
+// basis BigField::beta(i) = g^i of the subfield, where g is the
+// generator of the subfield.  Thus of_scalar(u) here and in BigField
+// denote the same element, and algorithms such as the LCH14 FFT, whose
+// constants are all of the form of_scalar(u), compute the same
+// function in both fields when the inputs lie in the subfield.
+//
+// Multiplication is table-driven via discrete logarithms base g, and
+// widen() maps an element back to BigField with two table lookups.
+template <class BigField>
+class GF2_16 {
+  using BigElt = typename BigField::Elt;
+
+ public:
+  static constexpr size_t kBits = 16;
+  static constexpr size_t kBytes = 2;
+  static constexpr size_t kSubFieldBits = kBits;
+  static constexpr size_t kSubFieldBytes = kBytes;
+  static constexpr bool kCharacteristicTwo = true;
+
+  struct Elt {
+    uint16_t n;
+
+    Elt() : n(0) {}
+    explicit Elt(uint16_t n_) : n(n_) {}
+
+    bool operator==(const Elt& y) const { return n == y.n; }
+    bool operator!=(const Elt& y) const { return !operator==(y); }
+  };
+
+  explicit GF2_16(const BigField& F)
+      : f_(F), exp_(2 * kOrder), log_(kOrder + 1) {
+    static_assert(BigField::kCharacteristicTwo);
+    static_assert(BigField::kSubFieldBits == kBits);
+
+    // g^16 in the basis {g^i}, which is also the minimal polynomial
+    // of g, less x^16.
+    uint8_t ab[kBytes];
+    F.to_bytes_subfield(ab, F.mulf(F.beta(kBits - 1), F.g()));
+    uint32_t g16 = ab[0] | (uint32_t(ab[1]) << 8);
+
+    // exp_[k] = g^k, computed by repeated multiplication by g, which
+    // in the basis {g^i} is a shift followed by a reduction.
+    uint32_t e = 1;
+    for (size_t k = 0; k < kOrder; ++k) {
+      check(k == 0 || e != 1, "g is not a generator of the subfield");
+      exp_[k] = exp_[k + kOrder] = static_cast<uint16_t>(e);
+      log_[e] = static_cast<uint16_t>(k);
+      e <<= 1;
+      if (e >> kBits) {
+        e = (e & 0xFFFFu) ^ g16;
+      }
+    }
+    check(e == 1, "g is not a generator of the subfield");
+
+    for (size_t u = 0; u < 256; ++u) {
+      lo_[u] = F.of_scalar(u);
+      hi_[u] = F.of_scalar(u << 8);
+    }
+  }
+
+  GF2_16(const GF2_16&) = delete;
+  GF2_16& operator=(const GF2_16&) = delete;
+
+  Elt of_scalar(uint64_t u) const {
+    check((u >> kBits) == 0, "of_scalar(u), too many bits");
+    return Elt(static_cast<uint16_t>(u));
+  }
+
+  std::optional<Elt> of_bytes_subfield(
+      const uint8_t ab[/* kSubFieldBytes */]) const {
+    return Elt(static_cast<uint16_t>(ab[0] | (ab[1] << 8)));
+  }
+
+  // The element of BigField represented by X.
+  BigElt widen(const Elt& x) const {
+    return f_.addf(lo_[x.n & 0xFFu], hi_[x.n >> 8]);
+  }
+
+  // The compact form of X, which must lie in the subfield.
+  Elt narrow(const BigElt& x) const {
+    static_assert(BigField::kSubFieldBytes == kBytes,
+                  "BigField must have a 16-bit subfield");
+    uint8_t ab[kBytes];
+    f_.to_bytes_subfield(ab, x);
+    return of_bytes_subfield(ab).value();
+  }
+
+  // functional interface
+  Elt addf(const Elt& x, const Elt& y) const { return Elt(x.n ^ y.n); }
+  Elt subf(const Elt& x, const Elt& y) const { return Elt(x.n ^ y.n); }
+  Elt mulf(const Elt& x, const Elt& y) const {
+    if (x.n == 0 || y.n == 0) {
+      return zero();
+    }
+    return Elt(exp_[log_[x.n] + log_[y.n]]);
+  }
+  Elt negf(const Elt& x) const { return x; }
+  Elt invertf(const Elt& x) const {
+    check(x.n != 0, "invertf(0)");
+    return Elt(exp_[kOrder - log_[x.n]]);
+  }
+
+  // two-operands interface
+  void add(Elt& a, const Elt& y) const { a = addf(a, y); }
+  void sub(Elt& a, const Elt& y) const { a = subf(a, y); }
+  void mul(Elt& a, const Elt& y) const { a = mulf(a, y); }
+  void neg(Elt& a) const { /* noop */ }
+  void invert(Elt& a) const { a = invertf(a); }
+
+  Elt zero() const { return Elt(0); }
+  Elt one() const { return Elt(1); }
+  Elt beta(size_t i) const {
+    check(i < kSubFieldBits, "i < kSubFieldBits");
+    return Elt(static_cast<uint16_t>(1u << i));
+  }
+
+ private:
+  static constexpr size_t kOrder = (size_t(1) << kBits) - 1;
+
+  const BigField& f_;
+
+  // exp_[k] = g^k for 0 <= k < 2 * kOrder, so that the sum of two
+  // logarithms needs no reduction.  log_[0] is unused.
+  std::vector<uint16_t> exp_;
+  std::vector<uint16_t> log_;
+
+  // widen(u) = lo_[u & 0xFF] + hi_[u >> 8]
+  std::array<BigElt, 256> lo_;
+  std::array<BigElt, 256> hi_;
+};
+
+// True if GF2_16<Field> is defined, that is, if Field is a binary
+// field with a subfield of 16 bits.
+template <class Field, class = void>
+struct HasGF2_16Subfield : std::false_type {};
+
+template <class Field>
+struct HasGF2_16Subfield<Field, std::enable_if_t<Field::kCharacteristicTwo &&
+                                                 Field::kSubFieldBits == 16>>
+    : std::true_type {};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_GF2K_GF2_16_H_
@@ -0,0 +1,93 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gf2k/gf2_16.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gf2k/gf2_128.h"
+#include "gf2k/lch14_reed_solomon.h"
+#include "gtest/gtest.h"
+
+namespace proofs {
+namespace {
+
+using Field = GF2_128<4>;
+using Elt = Field::Elt;
+using SubField = GF2_16<Field>;
+using SubElt = SubField::Elt;
+const Field F;
+const SubField F16(F);
+
+// deterministic pseudo-random 16-bit values
+uint16_t next16(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return static_cast<uint16_t>(state >> 16);
+}
+
+TEST(GF2_16, Widen) {
+  for (uint32_t u = 0; u < (1u << 16); ++u) {
+    SubElt x = F16.of_scalar(u);
+    Elt X = F16.widen(x);
+    EXPECT_EQ(X, F.of_scalar(u));
+    EXPECT_EQ(F16.narrow(X), x);
+  }
+}
+
+TEST(GF2_16, Arithmetic) {
+  uint32_t state = 42;
+  for (size_t i = 0; i < 100000; ++i) {
+    SubElt x = F16.of_scalar(next16(state));
+    SubElt y = F16.of_scalar(next16(state));
+    Elt X = F16.widen(x), Y = F16.widen(y);
+    EXPECT_EQ(F16.widen(F16.addf(x, y)), F.addf(X, Y));
+    EXPECT_EQ(F16.widen(F16.mulf(x, y)), F.mulf(X, Y));
+    if (x != F16.zero()) {
+      EXPECT_EQ(F16.mulf(x, F16.invertf(x)), F16.one());
+    }
+  }
+  for (size_t i = 0; i < SubField::kSubFieldBits; ++i) {
+    EXPECT_EQ(F16.widen(F16.beta(i)), F.beta(i));
+  }
+}
+
+// Encoding a subfield row in compact form must produce the compact
+// form of the encoding in the big field.
+TEST(GF2_16, ReedSolomon) {
+  LCH14ReedSolomonFactory<Field> rs_factory(F);
+  LCH14ReedSolomonFactory<SubField> rs16_factory(F16);
+  uint32_t state = 7;
+  for (size_t m : {8, 9, 64, 99, 1024, 4000}) {
+    for (size_t n : {size_t(1), m / 4, m / 2 + 1, m - 1}) {
+      auto rs = rs_factory.make(n, m);
+      auto rs16 = rs16_factory.make(n, m);
+      std::vector<Elt> Y(m);
+      std::vector<SubElt> Y16(m);
+      for (size_t i = 0; i < n; ++i) {
+        Y16[i] = F16.of_scalar(next16(state));
+        Y[i] = F16.widen(Y16[i]);
+      }
+      rs->interpolate(&Y[0]);
+      rs16->interpolate(&Y16[0]);
+      for (size_t i = 0; i < m; ++i) {
+        EXPECT_EQ(F16.widen(Y16[i]), Y[i]);
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace proofs
@@ -18,10 +18,13 @@
 #include <stdio.h>
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <vector>
 
+#include "algebra/utility.h"
 #include "gf2k/lch14.h"
+#include "util/panic.h"
 
 namespace proofs {
 
@@ -47,16 +50,136 @@ class LCH14ReedSolomon {
   // Y[i] is expected to be defined for 0 <= i < N, and this
   // routine fills it for 0 <= i < M
   void interpolate(Elt y[/*m*/]) const {
-    // determine the FFT size
+    std::vector<Elt> C(fft_size());
+    interpolate(y, &C[0]);
+  }
+
+  // Equivalent to interpolate(&y[r * stride]) for 0 <= r < NROWS, but
+  // all rows share one scratch array of coefficients.
+  void interpolate_many(size_t nrows, Elt y[/*nrows:stride*/],
+                        size_t stride) const {
+    std::vector<Elt> C(fft_size());
+    for (size_t r = 0; r < nrows; ++r) {
+      interpolate(&y[r * stride], &C[0]);
+    }
+  }
+
+  // Approximate cost of interpolate(), in units of one multiply-add in
+  // Field, for choosing between interpolate() and lagrange_weights():
+  // one transform of size fft_size() for each of the M / fft_size()
+  // cosets, as measured by BM_LigeroReqColumns in ligero/ligero_test.cc.
+  size_t interpolate_cost() const { return m_ * fft_log(); }
+
+  // Coefficients of the interpolation at a few points: sets
+  // L[i * n + j] to the coefficient of Y[j] in Y'[IDX[i]], where Y' is
+  // the array that interpolate(Y) would produce.
+  //
+  // With nodes x_j = F.of_scalar(j), the coefficient is the Lagrange
+  // basis polynomial l_j(x_k) = l(x_k) v_j / (x_k - x_j), where
+  // l(X) = PROD_{j} (X - x_j) and v_j = 1 / PROD_{i != j} (x_j - x_i).
+  // Because of_scalar() is linear over GF(2), x_k - x_j = x_{k ^ j}.
+  void lagrange_weights(size_t nidx, Elt L[/*nidx, n*/],
+                        const size_t idx[/*nidx*/]) const {
+    const Field& F = f_;
+    std::vector<Elt> v(n_);
+    node_weights(&v[0]);
+
+    std::vector<Elt> d(n_);
+    for (size_t i = 0; i < nidx; ++i) {
+      size_t k = idx[i];
+      check(k < m_, "k < m_");
+      Elt* Li = &L[i * n_];
+      if (k < n_) {
+        for (size_t j = 0; j < n_; ++j) {
+          Li[j] = F.zero();
+        }
+        Li[k] = F.one();
+      } else {
+        Elt lk = F.one();
+        for (size_t j = 0; j < n_; ++j) {
+          d[j] = F.of_scalar(k ^ j);
+          F.mul(lk, d[j]);
+        }
+        AlgebraUtil<Field>::batch_invert(n_, Li, 1, &d[0], 1, F);
+        for (size_t j = 0; j < n_; ++j) {
+          F.mul(Li[j], F.mulf(lk, v[j]));
+        }
+      }
+    }
+  }
+
+ private:
+  // V[j] = 1 / PROD_{i != j, i < n} (x_j - x_i) for 0 <= j < N.
+  //
+  // Split [0, N) into aligned dyadic blocks [c, c + 2^b), one for each
+  // bit b set in N.  Within a block, the product over the block is
+  // D_b = PROD_{0 < u < 2^b} x_u independently of j.  Outside, it is
+  // the subspace polynomial W_b(X) = PROD_{u < 2^b} (X - x_u) evaluated
+  // at x_{c ^ j}, and W_b is linear, so this is the sum of the
+  // W_b(beta_t) over the bits t set in c ^ j.  This avoids the
+  // quadratic cost of the naive products.
+  void node_weights(Elt v[/*n*/]) const {
+    const Field& F = f_;
+    constexpr size_t kBits = Field::kSubFieldBits;
+    size_t l = fft_log();
+
+    // W[b][t] = W_b(beta_t), D[b] = D_b, for 0 <= b <= l
+    std::vector<std::array<Elt, kBits>> W(l + 1);
+    std::vector<Elt> D(l + 1);
+    for (size_t t = 0; t < kBits; ++t) {
+      W[0][t] = F.beta(t);
+    }
+    D[0] = F.one();
+    for (size_t b = 0; b < l; ++b) {
+      // W_{b+1}(X) = W_b(X) (W_b(X) + W_b(beta_b))
+      for (size_t t = 0; t < kBits; ++t) {
+        W[b + 1][t] = F.mulf(W[b][t], F.addf(W[b][t], W[b][b]));
+      }
+      // D_{b+1} = D_b PROD_{u < 2^b} x_{2^b + u} = D_b W_b(beta_b)
+      D[b + 1] = F.mulf(D[b], W[b][b]);
+    }
+
+    std::vector<Elt> prod(n_, F.one());
+    size_t c = 0;
+    for (size_t b = l + 1; b-- > 0;) {
+      size_t s = size_t(1) << b;
+      if (n_ & s) {
+        for (size_t j = 0; j < n_; ++j) {
+          if (j >= c && j < c + s) {
+            F.mul(prod[j], D[b]);
+          } else {
+            Elt wb = F.zero();
+            for (size_t u = c ^ j, t = 0; u != 0; u >>= 1, ++t) {
+              if (u & 1) {
+                F.add(wb, W[b][t]);
+              }
+            }
+            F.mul(prod[j], wb);
+          }
+        }
+        c += s;
+      }
+    }
+
+    AlgebraUtil<Field>::batch_invert(n_, v, 1, &prod[0], 1, F);
+  }
+
+  // the smallest power of two 1 << l >= n_
+  size_t fft_log() const {
     size_t l = 0;
-    size_t fftn = 1;
-    while (fftn < n_) {
-      fftn <<= 1;
+    while ((size_t(1) << l) < n_) {
       ++l;
     }
+    return l;
+  }
+  size_t fft_size() const { return size_t(1) << fft_log(); }
 
-    // "coefficients" in the LCH14 novel polynomial basis
-    std::vector<Elt> C(fftn);
+  // C[] is scratch space for fft_size() "coefficients" in the LCH14
+  // novel polynomial basis.
+  void interpolate(Elt y[/*m*/], Elt C[/*fftn*/]) const {
+    // determine the FFT size
+    size_t l = fft_log();
+    size_t fftn = size_t(1) << l;
 
     // compute the "coefficients" under the assumption
     // that we know n_ evaluations and that the higher-order
@@ -67,7 +190,7 @@ class LCH14ReedSolomon {
     for (size_t i = n_; i < fftn; ++i) {
       C[i] = f_.zero();
     }
-    fft_.BidirectionalFFT(l, /*k=*/n_, &C[0]);
+    fft_.BidirectionalFFT(l, /*k=*/n_, C);
 
     // fill in the missing evaluations in the first coset, since we
     // already have the missing evaluations in C[[n_, (1<<l))]
@@ -92,7 +215,7 @@ class LCH14ReedSolomon {
         fft_.FFT(l, b, &y[b]);
       } else {
         // Partial fit.  Transform C and copy the output.
-        fft_.FFT(l, b, &C[0]);
+        fft_.FFT(l, b, C);
         for (size_t i = 0; i + b < m_; ++i) {
           y[i + b] = C[i];
         }
@@ -102,7 +225,6 @@ class LCH14ReedSolomon {
     }
   }
 
- private:
   const Field& f_;
   size_t n_;
   size_t m_;
@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <vector>
 
+#include "algebra/blas.h"
 #include "algebra/bogorng.h"
 #include "gf2k/gf2_128.h"
 #include "benchmark/benchmark.h"
@@ -66,6 +67,50 @@ TEST(LCH14, ReedSolomon) {
     }
   }
 }
+
+TEST(LCH14, InterpolateMany) {
+  constexpr size_t n = 37, m = 150, nrows = 5, stride = m + 3;
+  LCH14ReedSolomonFactory<Field> rs_factory(F);
+  auto rs = rs_factory.make(n, m);
+  Bogorng<Field> rng(&F);
+
+  std::vector<Elt> Y(nrows * stride), Z(nrows * stride);
+  for (size_t r = 0; r < nrows; ++r) {
+    for (size_t i = 0; i < n; ++i) {
+      Y[r * stride + i] = Z[r * stride + i] = rng.next();
+    }
+  }
+
+  rs->interpolate_many(nrows, &Y[0], stride);
+  for (size_t r = 0; r < nrows; ++r) {
+    rs->interpolate(&Z[r * stride]);
+  }
+  EXPECT_EQ(Y, Z);
+}
+
+TEST(LCH14, LagrangeWeights) {
+  Bogorng<Field> rng(&F);
+  for (size_t n : {1, 2, 7, 16, 37}) {
+    size_t m = 150;
+    LCH14ReedSolomonFactory<Field> rs_factory(F);
+    auto rs = rs_factory.make(n, m);
+
+    std::vector<Elt> Y(m);
+    for (size_t i = 0; i < n; ++i) {
+      Y[i] = rng.next();
+    }
+
+    const size_t idx[] = {0, n - 1, n, n + 1, 64, 100, m - 1};
+    constexpr size_t nidx = sizeof(idx) / sizeof(idx[0]);
+    std::vector<Elt> L(nidx * n);
+    rs->lagrange_weights(nidx, &L[0], idx);
+
+    rs->interpolate(&Y[0]);
+    for (size_t i = 0; i < nidx; ++i) {
+      EXPECT_EQ(Blas<Field>::dot(n, &L[i * n], 1, &Y[0], 1, F), Y[idx[i]]);
+    }
+  }
+}
 }  // namespace
 
 namespace bench {
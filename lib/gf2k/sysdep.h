@@ -64,6 +64,15 @@ static inline gf2_128_elt_t gf2_128_mul(gf2_128_elt_t x, gf2_128_elt_t y) {
   t0 = gf2_128_reduce(t0, t1);
   return t0;
 }
+
+// t[0] + x^64 * t[1] + x^128 * t[2] += x * y, without reduction
+static inline void gf2_128_mul_accum(gf2_128_elt_t t[3], gf2_128_elt_t x,
+                                     gf2_128_elt_t y) {
+  t[0] = gf2_128_add(t[0], _mm_clmulepi64_si128(x, y, 0x00));
+  t[1] = gf2_128_add(t[1], _mm_clmulepi64_si128(x, y, 0x01));
+  t[1] = gf2_128_add(t[1], _mm_clmulepi64_si128(x, y, 0x10));
+  t[2] = gf2_128_add(t[2], _mm_clmulepi64_si128(x, y, 0x11));
+}
 }  // namespace proofs
 #elif defined(__aarch64__)
 //
@@ -120,6 +129,16 @@ static inline gf2_128_elt_t gf2_128_mul(gf2_128_elt_t x, gf2_128_elt_t y) {
   t0 = gf2_128_reduce(t0, t1);
   return t0;
 }
+
+// t[0] + x^64 * t[1] + x^128 * t[2] += x * y, without reduction
+static inline void gf2_128_mul_accum(gf2_128_elt_t t[3], gf2_128_elt_t x,
+                                     gf2_128_elt_t y) {
+  gf2_128_elt_t swx = vextq_p64(x, x, 1);
+  t[0] = vaddq_p64(t[0], vmull_low(x, y));
+  t[1] = vaddq_p64(t[1], vmull_high(swx, y));
+  t[1] = vaddq_p64(t[1], vmull_low(swx, y));
+  t[2] = vaddq_p64(t[2], vmull_high(x, y));
+}
 }  // namespace proofs
 
 #elif defined(__arm__) || defined(__aarch64__)
@@ -245,9 +264,26 @@ static inline gf2_128_elt_t gf2_128_mul(gf2_128_elt_t x, gf2_128_elt_t y) {
   return t0;
 }
 
+// t[0] + x^64 * t[1] + x^128 * t[2] += x * y, without reduction
+static inline void gf2_128_mul_accum(gf2_128_elt_t t[3], gf2_128_elt_t x,
+                                     gf2_128_elt_t y) {
+  gf2_128_elt_t swx = vextq_p64_1_emul(x, x);
+  t[0] = vaddq_p64(t[0], vmull_low(x, y));
+  t[1] = vaddq_p64(t[1], vmull_high(swx, y));
+  t[1] = vaddq_p64(t[1], vmull_low(swx, y));
+  t[2] = vaddq_p64(t[2], vmull_high(x, y));
+}
+
 }  // namespace proofs
 #else
 #error "unimplemented gf2k/sysdep.h"
 #endif
 
+namespace proofs {
+// Reduce the sum of products accumulated by gf2_128_mul_accum().
+static inline gf2_128_elt_t gf2_128_reduce_accum(const gf2_128_elt_t t[3]) {
+  return gf2_128_reduce(t[0], gf2_128_reduce(t[1], t[2]));
+}
+}  // namespace proofs
+
 #endif  // PRIVACY_PROOFS_ZK_LIB_GF2K_SYSDEP_H_
@@ -0,0 +1,314 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_LIGERO_LIGERO_COST_H_
+#define PRIVACY_PROOFS_ZK_LIB_LIGERO_LIGERO_COST_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "algebra/blas.h"
+#include "ligero/ligero_param.h"
+#include "util/crypto.h"
+#include "util/panic.h"
+
+namespace proofs {
+
+// A model of the single-threaded running time of the Ligero prover
+// and verifier as a function of the layout chosen by
+// LigeroParam::layout().  LigeroParam::layout() only estimates the
+// proof size, and the block_enc that minimizes it can be noticeably
+// slower to prove than a neighbor that yields a slightly larger proof,
+// e.g. because it crosses a power of two in the FFT size.
+//
+// The coefficients are fitted by calibrate_ligero_cost() from
+// microbenchmarks on the target machine.  Only the terms that depend
+// on the layout are modeled, i.e. encoding, column hashing, and the
+// low-degree, dot and quadratic passes.  Work that does not depend on
+// block_enc, such as sumcheck or the construction of the
+// inner-product vector, is omitted, so that the model is meant to
+// compare layouts and not to predict the end-to-end latency.
+struct LigeroCostModel {
+  // Pairs (M, T) sorted by M, where T is the time in ns to encode one
+  // row of (M + 1) / (2 + RATEINV) elements into M elements.
+  std::vector<std::pair<size_t, double>> enc_ns;
+
+  // Pairs (M, T) sorted by M, where T is the time in ns to extend one
+  // row of (M + 1) / 2 elements into M elements, as the prover does
+  // for every row of A in the dot pass.
+  std::vector<std::pair<size_t, double>> ext_ns;
+
+  double hash_ns_per_byte = 0;  // SHA-256 throughput
+  double mac_ns = 0;            // one field multiply-accumulate
+  double weight_ns = 0;         // one Lagrange weight in the verifier
+
+  // Time to encode one row into M elements, interpolated linearly
+  // between the calibrated sizes and proportionally outside them.
+  double encode_ns(size_t m) const { return lookup(enc_ns, m); }
+
+  // Time to extend one row into M elements, likewise.
+  double extend_ns(size_t m) const { return lookup(ext_ns, m); }
+
+ private:
+  static double lookup(const std::vector<std::pair<size_t, double>>& t,
+                       size_t m) {
+    check(!t.empty(), "uncalibrated LigeroCostModel");
+    if (m <= t.front().first) {
+      return t.front().second * m / t.front().first;
+    }
+    for (size_t i = 1; i < t.size(); ++i) {
+      const auto& [m1, t1] = t[i];
+      if (m <= m1) {
+        const auto& [m0, t0] = t[i - 1];
+        return t0 + (t1 - t0) * (m - m0) / (m1 - m0);
+      }
+    }
+    return t.back().second * m / t.back().first;
+  }
+};
+
+// One point in the space of layouts.  PROOF_BYTES is the estimate of
+// LigeroParam::layout(), and is SIZE_MAX if BLOCK_ENC is infeasible.
+struct LigeroCost {
+  size_t block_enc;
+  size_t proof_bytes;
+  double prover_ms;
+  double verifier_ms;
+
+  // True if THIS is no worse than Y in every coordinate, and
+  // better in at least one.
+  bool dominates(const LigeroCost& y) const {
+    return proof_bytes <= y.proof_bytes && prover_ms <= y.prover_ms &&
+           verifier_ms <= y.verifier_ms &&
+           (proof_bytes < y.proof_bytes || prover_ms < y.prover_ms ||
+            verifier_ms < y.verifier_ms);
+  }
+};
+
+// Cost of the layout of P with the given block_enc under the model M.
+// P is taken by value because layout() overwrites the computed
+// parameters.
+template <class Field>
+LigeroCost ligero_cost(LigeroParam<Field> p, size_t block_enc,
+                       const LigeroCostModel& m) {
+  LigeroCost c{block_enc, p.layout(block_enc), 0, 0};
+  if (c.proof_bytes == SIZE_MAX) {
+    return c;
+  }
+
+  const double nrow = p.nrow, nwqrow = p.nwqrow, nq3 = p.nqtriples;
+  const double block = p.block, dblock = p.dblock, w = p.w;
+  const double ncol = p.block_ext, nreq = p.nreq;
+  const double kBytes = Field::kBytes;
+
+  // A SHA-256 of two digests processes two 64-byte blocks.
+  constexpr double kNodeBytes = 128;
+
+  // Prover: encode all rows, hash the columns and build the Merkle
+  // tree, then the low-degree, dot and quadratic passes.  The dot
+  // pass also extends one row of A from BLOCK to DBLOCK per row.
+  double prover_ns = nrow * m.encode_ns(p.block_enc);
+  prover_ns += (ncol * nrow * kBytes + ncol * kNodeBytes) * m.hash_ns_per_byte;
+  prover_ns += nwqrow * block * m.mac_ns;
+  prover_ns += nwqrow * (m.extend_ns(p.dblock) + dblock * m.mac_ns);
+  prover_ns += 2 * nq3 * dblock * m.mac_ns;
+
+  // Verifier: hash the opened columns and the Merkle paths, compute
+  // the Lagrange weights of the opened columns, and evaluate the
+  // three checks at the opened columns.  The dot check dominates,
+  // since it evaluates every row of A at the opened columns, either
+  // through the weights or through a full encoding, whichever is
+  // cheaper.
+  double verifier_ns = (nreq * nrow * kBytes +
+                        nreq * p.mc_pathlen / 2 * kNodeBytes) *
+                       m.hash_ns_per_byte;
+  verifier_ns += nreq * (block + dblock) * m.weight_ns;
+  verifier_ns += nwqrow * (std::min(nreq * w * m.mac_ns,
+                                    m.encode_ns(p.block_enc)) +
+                           2 * nreq * m.mac_ns);
+  verifier_ns += 2 * nreq * nq3 * m.mac_ns;
+  verifier_ns += nreq * (block + 2 * dblock) * m.mac_ns;
+
+  c.prover_ms = prover_ns * 1e-6;
+  c.verifier_ms = verifier_ns * 1e-6;
+  return c;
+}
+
+// The points of PTS that are not dominated by any other point, in
+// order of increasing proof size.  Infeasible points are dropped.
+inline std::vector<LigeroCost> ligero_pareto_frontier(
+    std::vector<LigeroCost> pts) {
+  std::sort(pts.begin(), pts.end(),
+            [](const LigeroCost& x, const LigeroCost& y) {
+              if (x.proof_bytes != y.proof_bytes) {
+                return x.proof_bytes < y.proof_bytes;
+              }
+              if (x.prover_ms != y.prover_ms) {
+                return x.prover_ms < y.prover_ms;
+              }
+              return x.verifier_ms < y.verifier_ms;
+            });
+
+  // After sorting, a point can only be dominated by an earlier one,
+  // and if it is dominated by an earlier point then it is also
+  // dominated by an earlier point on the frontier.
+  std::vector<LigeroCost> frontier;
+  for (const LigeroCost& x : pts) {
+    if (x.proof_bytes == SIZE_MAX) {
+      break;
+    }
+    bool dominated = false;
+    for (const LigeroCost& f : frontier) {
+      if (f.dominates(x) ||
+          (f.proof_bytes == x.proof_bytes && f.prover_ms == x.prover_ms &&
+           f.verifier_ms == x.verifier_ms)) {
+        dominated = true;
+        break;
+      }
+    }
+    if (!dominated) {
+      frontier.push_back(x);
+    }
+  }
+  return frontier;
+}
+
+// The point of FRONTIER with the smallest proof among those whose
+// prover time is at most PROVER_BUDGET_MS, or the point with the
+// fastest prover if no point meets the budget.  FRONTIER must be
+// nonempty.
+inline const LigeroCost& ligero_choose(
+    const std::vector<LigeroCost>& frontier, double prover_budget_ms) {
+  check(!frontier.empty(), "empty frontier");
+  const LigeroCost* fastest = &frontier[0];
+  for (const LigeroCost& f : frontier) {
+    // FRONTIER is sorted by proof size.
+    if (f.prover_ms <= prover_budget_ms) {
+      return f;
+    }
+    if (f.prover_ms < fastest->prover_ms) {
+      fastest = &f;
+    }
+  }
+  return *fastest;
+}
+
+// Fit a LigeroCostModel by timing, on this machine, the encoding of
+// rows into each of the sizes in ENC_SIZES with the given RATEINV and
+// the extension of rows of the same BLOCK to DBLOCK, together with
+// SHA-256, field multiply-accumulates and Lagrange weights.  Since the encoding cost is piecewise constant in the FFT
+// size for some interpolators, ENC_SIZES should be dense enough to
+// resolve the steps, e.g. a few sizes per power of two.
+template <class Field, class InterpolatorFactory>
+LigeroCostModel calibrate_ligero_cost(const std::vector<size_t>& enc_sizes,
+                                      size_t rateinv,
+                                      const InterpolatorFactory& interpolator,
+                                      const Field& F) {
+  using Elt = typename Field::Elt;
+  using clock = std::chrono::steady_clock;
+
+  // Repeat F until at least kMinNs have elapsed, and return the time
+  // per repetition.
+  constexpr double kMinNs = 2e7;
+  auto time_ns = [&](auto f) {
+    size_t reps = 0;
+    auto t0 = clock::now();
+    double ns = 0;
+    do {
+      f();
+      ++reps;
+      ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+    } while (ns < kMinNs);
+    return ns / reps;
+  };
+
+  LigeroCostModel m;
+
+  {
+    constexpr size_t kRows = 4;
+    constexpr size_t kIdx = 16;
+    double weight_ns = 0;
+    std::vector<size_t> sizes = enc_sizes;
+    std::sort(sizes.begin(), sizes.end());
+    for (size_t e : sizes) {
+      size_t n = (e + 1) / (2 + rateinv);
+      check(n > 0, "enc_sizes too small");
+      const auto interp = interpolator.make(n, e);
+      std::vector<Elt> y(kRows * e);
+      for (size_t i = 0; i < y.size(); ++i) {
+        y[i] = F.of_scalar(i % 65521 + 1);
+      }
+      double ns = time_ns([&] { interp->interpolate_many(kRows, &y[0], e); });
+      m.enc_ns.push_back({e, ns / kRows});
+
+      std::vector<size_t> idx(kIdx);
+      for (size_t k = 0; k < kIdx; ++k) {
+        idx[k] = e - 1 - k;
+      }
+      std::vector<Elt> L(kIdx * n);
+      ns = time_ns([&] { interp->lagrange_weights(kIdx, &L[0], &idx[0]); });
+      weight_ns += ns / (kIdx * n);
+
+      // The extension of rows of A from BLOCK = N to DBLOCK.
+      size_t d = 2 * n - 1;
+      const auto interpd = interpolator.make(n, d);
+      ns = time_ns([&] { interpd->interpolate_many(kRows, &y[0], d); });
+      m.ext_ns.push_back({d, ns / kRows});
+    }
+    m.weight_ns = weight_ns / sizes.size();
+  }
+
+  {
+    std::vector<uint8_t> buf(1 << 20);
+    for (size_t i = 0; i < buf.size(); ++i) {
+      buf[i] = static_cast<uint8_t>(i);
+    }
+    double ns = time_ns([&] {
+      SHA256 sha;
+      sha.Update(&buf[0], buf.size());
+      uint8_t digest[kSHA256DigestSize];
+      sha.DigestData(digest);
+    });
+    m.hash_ns_per_byte = ns / buf.size();
+  }
+
+  {
+    constexpr size_t kN = 1 << 14;
+    std::vector<Elt> x(kN), y(kN);
+    for (size_t i = 0; i < kN; ++i) {
+      x[i] = F.of_scalar(i + 1);
+      y[i] = F.of_scalar(kN - i);
+    }
+    Elt sink = F.zero();
+    double ns = time_ns(
+        [&] { F.add(sink, Blas<Field>::dot(kN, &x[0], 1, &y[0], 1, F)); });
+    // Keep the dot products from being optimized away.
+    uint8_t keep[Field::kBytes];
+    F.to_bytes_field(keep, sink);
+    volatile uint8_t keep0 = keep[0];
+    (void)keep0;
+    m.mac_ns = ns / kN;
+  }
+
+  return m;
+}
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_LIGERO_LIGERO_COST_H_
@@ -0,0 +1,178 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ligero/ligero_cost.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gf2k/gf2_128.h"
+#include "gf2k/lch14_reed_solomon.h"
+#include "ligero/ligero_param.h"
+#include "gtest/gtest.h"
+
+namespace proofs {
+namespace {
+
+using Field = GF2_128<>;
+const Field F;
+
+// A model whose encoding and extension costs double at every power of
+// two, as for an FFT whose size is the next power of two.
+LigeroCostModel step_model() {
+  LigeroCostModel m;
+  for (size_t k = 6; k <= 17; ++k) {
+    size_t e = size_t(1) << k;
+    m.enc_ns.push_back({e, 30.0 * e * k});
+    m.enc_ns.push_back({e + 1, 60.0 * e * (k + 1)});
+    m.ext_ns.push_back({e, 20.0 * e * k});
+    m.ext_ns.push_back({e + 1, 40.0 * e * (k + 1)});
+  }
+  m.hash_ns_per_byte = 2;
+  m.mac_ns = 5;
+  m.weight_ns = 20;
+  return m;
+}
+
+TEST(LigeroCost, ProofBytes) {
+  LigeroParam<Field> p(50000, 5000, /*rateinv=*/4, /*nreq=*/128);
+  const LigeroCostModel m = step_model();
+  for (size_t e : {size_t(2000), p.block_enc, size_t(50000)}) {
+    LigeroCost c = ligero_cost(p, e, m);
+    EXPECT_EQ(c.block_enc, e);
+    EXPECT_EQ(c.proof_bytes, p.layout(e));
+    EXPECT_GT(c.prover_ms, 0);
+    EXPECT_GT(c.verifier_ms, 0);
+  }
+  // BLOCK < 2 * NREQ
+  EXPECT_EQ(ligero_cost(p, 1000, m).proof_bytes, SIZE_MAX);
+}
+
+TEST(LigeroCost, EncodeInterpolation) {
+  LigeroCostModel m;
+  m.enc_ns = {{100, 1000}, {200, 3000}};
+  EXPECT_EQ(m.encode_ns(50), 500);
+  EXPECT_EQ(m.encode_ns(100), 1000);
+  EXPECT_EQ(m.encode_ns(150), 2000);
+  EXPECT_EQ(m.encode_ns(400), 6000);
+
+  m.ext_ns = {{100, 500}};
+  EXPECT_EQ(m.extend_ns(50), 250);
+  EXPECT_EQ(m.extend_ns(200), 1000);
+  EXPECT_EQ(m.encode_ns(200), 3000);
+}
+
+// The extension of the rows of A to DBLOCK is priced by ext_ns, and
+// only affects the prover.
+TEST(LigeroCost, Extension) {
+  LigeroParam<Field> p(50000, 5000, /*rateinv=*/4, /*nreq=*/128);
+  LigeroCostModel m = step_model();
+  LigeroCost c0 = ligero_cost(p, p.block_enc, m);
+  for (auto& [d, t] : m.ext_ns) {
+    t *= 2;
+  }
+  LigeroCost c1 = ligero_cost(p, p.block_enc, m);
+  EXPECT_GT(c1.prover_ms, c0.prover_ms);
+  EXPECT_EQ(c1.verifier_ms, c0.verifier_ms);
+  EXPECT_EQ(c1.proof_bytes, c0.proof_bytes);
+}
+
+TEST(LigeroCost, Frontier) {
+  std::vector<LigeroCost> pts = {
+      {1, 100, 10, 5},       // on the frontier
+      {2, 100, 10, 5},       // duplicate of 1
+      {3, 110, 12, 4},       // on the frontier, faster verifier
+      {4, 120, 11, 6},       // dominated by 1
+      {5, 130, 8, 6},        // on the frontier, faster prover
+      {6, SIZE_MAX, 1, 1},   // infeasible
+      {7, 90, 20, 20},       // on the frontier, smallest proof
+      {8, 140, 8, 6},        // dominated by 5
+  };
+  std::vector<LigeroCost> f = ligero_pareto_frontier(pts);
+  ASSERT_EQ(f.size(), 4u);
+  EXPECT_EQ(f[0].block_enc, 7u);
+  EXPECT_EQ(f[1].block_enc, 1u);
+  EXPECT_EQ(f[2].block_enc, 3u);
+  EXPECT_EQ(f[3].block_enc, 5u);
+
+  EXPECT_EQ(ligero_choose(f, 1e9).block_enc, 7u);
+  EXPECT_EQ(ligero_choose(f, 10).block_enc, 1u);
+  EXPECT_EQ(ligero_choose(f, 9).block_enc, 5u);
+  EXPECT_EQ(ligero_choose(f, 1).block_enc, 5u);
+}
+
+// The frontier over all block_enc contains the smallest proof, and
+// every other layout is dominated by some point on the frontier.
+TEST(LigeroCost, FrontierOfLayouts) {
+  LigeroParam<Field> p(50000, 5000, /*rateinv=*/4, /*nreq=*/128);
+  const LigeroCostModel m = step_model();
+
+  std::vector<LigeroCost> pts;
+  for (size_t e = 100; e <= (1 << 14); ++e) {
+    pts.push_back(ligero_cost(p, e, m));
+  }
+  std::vector<LigeroCost> f = ligero_pareto_frontier(pts);
+  ASSERT_FALSE(f.empty());
+
+  size_t min_proof_size = SIZE_MAX;
+  for (const LigeroCost& c : pts) {
+    min_proof_size = std::min(min_proof_size, c.proof_bytes);
+  }
+  EXPECT_EQ(f[0].proof_bytes, min_proof_size);
+
+  for (size_t i = 1; i < f.size(); ++i) {
+    EXPECT_LE(f[i - 1].proof_bytes, f[i].proof_bytes);
+    EXPECT_FALSE(f[i - 1].dominates(f[i]));
+  }
+  for (const LigeroCost& c : pts) {
+    if (c.proof_bytes == SIZE_MAX) continue;
+    bool covered = false;
+    for (const LigeroCost& x : f) {
+      covered = covered || x.block_enc == c.block_enc || x.dominates(c) ||
+                (x.proof_bytes == c.proof_bytes && x.prover_ms == c.prover_ms &&
+                 x.verifier_ms == c.verifier_ms);
+    }
+    EXPECT_TRUE(covered) << c.block_enc;
+  }
+}
+
+TEST(LigeroCost, Calibrate) {
+  LCH14ReedSolomonFactory<Field> rs_factory(F);
+  LigeroCostModel m =
+      calibrate_ligero_cost({256, 1024}, /*rateinv=*/4, rs_factory, F);
+  ASSERT_EQ(m.enc_ns.size(), 2u);
+  EXPECT_EQ(m.enc_ns[0].first, 256u);
+  EXPECT_EQ(m.enc_ns[1].first, 1024u);
+  EXPECT_GT(m.enc_ns[0].second, 0);
+  EXPECT_GT(m.enc_ns[1].second, 0);
+  // DBLOCK = 2 * BLOCK - 1 for BLOCK = (256 + 1) / 6 and (1024 + 1) / 6
+  ASSERT_EQ(m.ext_ns.size(), 2u);
+  EXPECT_EQ(m.ext_ns[0].first, 83u);
+  EXPECT_EQ(m.ext_ns[1].first, 339u);
+  EXPECT_GT(m.ext_ns[0].second, 0);
+  EXPECT_GT(m.ext_ns[1].second, 0);
+  EXPECT_GT(m.hash_ns_per_byte, 0);
+  EXPECT_GT(m.mac_ns, 0);
+  EXPECT_GT(m.weight_ns, 0);
+
+  LigeroParam<Field> p(50000, 5000, /*rateinv=*/4, /*nreq=*/128);
+  LigeroCost c = ligero_cost(p, p.block_enc, m);
+  EXPECT_GT(c.prover_ms, 0);
+  EXPECT_GT(c.verifier_ms, 0);
+}
+
+}  // namespace
+}  // namespace proofs
@@ -173,7 +173,8 @@ struct LigeroParam {
               size_t be)
       : nw(nw), nq(nq), rateinv(rateinv), nreq(nreq), block_enc(be) {
     r = nreq;
-    check(layout(block_enc) < SIZE_MAX, "block_enc too large");
+    check(layout(block_enc) < SIZE_MAX,
+          "block_enc infeasible for rateinv and nreq");
     sanity();
   }
 
@@ -243,6 +244,13 @@ struct LigeroParam {
     block_ext = block_enc - dblock;
     // now 0 <= BLOCK_EXT < MAX_SIZE
 
+    // The verifier opens NREQ distinct columns of the extension.  With
+    // a low rate and a large NREQ, a short BLOCK_EXT may not have
+    // enough of them.
+    if (nreq == 0 || block_ext < nreq) {
+      return SIZE_MAX;
+    }
+
     nwrow = ceildiv(nw, w);
     nqtriples = ceildiv(nq, w);
 
@@ -388,11 +396,32 @@ class LigeroCommon {
     Blas<Field>::clear(p.nwqrow * p.w, A, 1, F);
 
     // random linear combinations of the linear constraints
-    for (size_t l = 0; l < nllterm; ++l) {
-      const auto &term = llterm[l];
-      proofs::check(term.w < p.nw, "term.w < p.nw");
-      proofs::check(term.c < nl, "term.c < nl");
-      F.add(A[term.w], F.mulf(term.k, alphal[term.c]));
+    for (size_t l = 0; l < nllterm;) {
+      size_t w = llterm[l].w;
+      proofs::check(w < p.nw, "term.w < p.nw");
+
+      // Terms [L, E) refer to the same witness.
+      size_t e = l + 1;
+      while (e < nllterm && llterm[e].w == w) {
+        ++e;
+      }
+
+      if constexpr (HasAccum<Field>::value) {
+        if (e > l + 1) {
+          // Accumulate the run without reduction, and reduce it once.
+          typename Field::Accum acc{};
+          for (; l < e; ++l) {
+            proofs::check(llterm[l].c < nl, "term.c < nl");
+            F.mac(acc, llterm[l].k, alphal[llterm[l].c]);
+          }
+          F.add(A[w], F.reduce_accum(acc));
+          continue;
+        }
+      }
+      for (; l < e; ++l) {
+        proofs::check(llterm[l].c < nl, "term.c < nl");
+        F.add(A[w], F.mulf(llterm[l].k, alphal[llterm[l].c]));
+      }
     }
 
     // routing terms for quadratic constraints
@@ -428,12 +457,60 @@ class LigeroCommon {
 
   static void column_hash(size_t n, const Elt x[/*n:incx*/], size_t incx,
                           SHA256 &sha, const Field &F) {
-    for (size_t i = 0; i < n; ++i) {
-      uint8_t buf[Field::kBytes];
-      F.to_bytes_field(buf, x[i * incx]);
-      sha.Update(buf, sizeof(buf));
+    // Serialize a few elements at a time to amortize the cost of
+    // SHA256::Update().  The hash only depends on the byte stream.
+    uint8_t buf[kHashRows * Field::kBytes];
+    for (size_t i0 = 0; i0 < n; i0 += kHashRows) {
+      size_t nr = std::min(kHashRows, n - i0);
+      for (size_t i = 0; i < nr; ++i) {
+        F.to_bytes_field(&buf[i * Field::kBytes], x[(i0 + i) * incx]);
+      }
+      sha.Update(buf, nr * Field::kBytes);
     }
   }
+
+  // Equivalent to column_hash(n, &x[j], ldx, sha[j], F) for all
+  // 0 <= j < NCOL, but traversing X in row order.  X is processed in
+  // tiles of kHashCols columns by kHashRows rows, so that the
+  // strided column accesses hit the cache.
+  static void column_hash_many(size_t n, const Elt x[/*n, ldx*/], size_t ldx,
+                               size_t ncol, SHA256 sha[/*ncol*/],
+                               const Field &F) {
+    column_hash_many(n, x, ldx, ncol, sha,
+                     [&](uint8_t buf[], const Elt &xi) {
+                       F.to_bytes_field(buf, xi);
+                     });
+  }
+
+  // Same as above, for an array X of another representation of the
+  // elements of Field, of which TO_BYTES(BUF, X) produces the bytes
+  // that F.to_bytes_field() would produce.
+  template <class T, class ToBytes>
+  static void column_hash_many(size_t n, const T x[/*n, ldx*/], size_t ldx,
+                               size_t ncol, SHA256 sha[/*ncol*/],
+                               const ToBytes &to_bytes) {
+    std::vector<uint8_t> buf(kHashCols * kHashRows * Field::kBytes);
+    for (size_t j0 = 0; j0 < ncol; j0 += kHashCols) {
+      size_t nc = std::min(kHashCols, ncol - j0);
+      for (size_t i0 = 0; i0 < n; i0 += kHashRows) {
+        size_t nr = std::min(kHashRows, n - i0);
+        for (size_t i = 0; i < nr; ++i) {
+          const T *xi = &x[(i0 + i) * ldx + j0];
+          for (size_t j = 0; j < nc; ++j) {
+            to_bytes(&buf[(j * kHashRows + i) * Field::kBytes], xi[j]);
+          }
+        }
+        for (size_t j = 0; j < nc; ++j) {
+          sha[j0 + j].Update(&buf[j * kHashRows * Field::kBytes],
+                             nr * Field::kBytes);
+        }
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t kHashRows = 16;
+  static constexpr size_t kHashCols = 32;
 };
 
 // A struct representing the hash of llterms.  It is really the
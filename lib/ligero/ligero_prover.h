@@ -19,15 +19,20 @@
 
 #include <algorithm>
 #include <array>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "algebra/blas.h"
+#include "gf2k/gf2_16.h"
+#include "gf2k/lch14_reed_solomon.h"
 #include "ligero/ligero_param.h"
 #include "ligero/ligero_transcript.h"
 #include "merkle/merkle_commitment.h"
 #include "random/random.h"
 #include "random/transcript.h"
 #include "util/crypto.h"
+#include "util/executor.h"
 #include "util/panic.h"
 
 namespace proofs {
@@ -35,9 +40,75 @@ template <class Field, class InterpolatorFactory>
 class LigeroProver {
   using Elt = typename Field::Elt;
 
+  // Whether witness rows in the subfield can be stored in compact form.
+  static constexpr bool kCompactSubfield = HasGF2_16Subfield<Field>::value;
+
+  // GF2_16<Field> is only instantiated for fields that have such a
+  // subfield.  Otherwise there are no compact rows, and all code that
+  // touches them is discarded by if constexpr (kCompactSubfield).
+  struct NoSubField {
+    struct Elt {};
+  };
+  using SubField =
+      std::conditional_t<kCompactSubfield, GF2_16<Field>, NoSubField>;
+  using SubElt = typename SubField::Elt;
+
  public:
-  explicit LigeroProver(const LigeroParam<Field> &p)
-      : p_(p), mc_(p.block_enc - p.dblock), tableau_(p.nrow * p.block_enc) {}
+  // EXECUTOR, if not null, is used to encode the rows of the tableau
+  // and to hash its columns in parallel.  The proof does not depend on
+  // the choice of executor.
+  //
+  // STREAM_ROWS selects a low-memory mode when nonzero.  By default
+  // the prover keeps the whole encoded tableau of NROW x BLOCK_ENC
+  // elements.  In low-memory mode, it keeps only the first DBLOCK
+  // columns of each row, which hold the randomness, the witnesses, and
+  // everything else that the y_ldt/y_dot/y_quad sums need.  The
+  // remaining columns are recomputed STREAM_ROWS rows at a time, once
+  // for hashing the Merkle leaves and once for the opened columns.
+  // Peak memory is thus about NROW x DBLOCK + STREAM_ROWS x BLOCK_ENC
+  // elements, at the cost of encoding every row twice.  The proof does
+  // not depend on STREAM_ROWS.
+  //
+  // Over GF2_128<4>, witness rows that lie entirely in the GF(2^16)
+  // subfield stay there when encoded, because all constants of the
+  // LCH14 encoder are in the subfield.  The prover stores such rows in
+  // the 2-byte form of GF2_16 and encodes them with GF2_16 arithmetic,
+  // and it widens their elements to the full field only to hash them
+  // or to combine them with other rows.  In low-memory mode, the
+  // compact rows keep their first DBLOCK columns in 2-byte form too,
+  // and they are widened when copied into the window of rows being
+  // encoded.  This assumes that INTERPOLATOR is an LCH14 encoder, the
+  // only one for binary fields.  The proof is the same as with full
+  // rows.
+  explicit LigeroProver(const LigeroParam<Field> &p,
+                        Executor *executor = nullptr, size_t stream_rows = 0)
+      : p_(p),
+        mc_(p.block_enc - p.dblock),
+        stream_rows_(stream_rows),
+        ld_(stream_rows == 0 ? p.block_enc : p.dblock),
+        nsub_(0),
+        ex_(executor != nullptr ? executor : &serial_),
+        precomputed_(false) {}
+
+  LigeroProver(const LigeroProver &) = delete;
+  LigeroProver &operator=(const LigeroProver &) = delete;
+
+  // A prover may be reused for any number of proofs.  Each call to
+  // commit() or sample() starts a new proof, which overwrites the
+  // tableau and the Merkle tree of the previous one in place.  The
+  // tableau is allocated by the first proof.
+  const LigeroParam<Field> &param() const { return p_; }
+
+  // Bytes of tableau storage held by the prover, including the window
+  // of STREAM_ROWS encoded rows that low-memory mode allocates while
+  // hashing and opening columns.  This is the peak memory of the
+  // tableau during a proof, not counting the Merkle tree, and it is
+  // valid after the first call to sample() or precompute().
+  size_t peak_bytes() const {
+    return tableau_.capacity() * sizeof(Elt) +
+           sub_.capacity() * sizeof(SubElt) +
+           stream_rows_ * p_.block_enc * sizeof(Elt);
+  }
 
   // The SUBFIELD_BOUNDARY parameter is kind of a hack.
   //
@@ -60,22 +131,163 @@ class LigeroProver {
               const LigeroQuadraticConstraint lqc[/*nq*/],
               const InterpolatorFactory &interpolator, RandomEngine &rng,
               const Field &F) {
+    sample(W, subfield_boundary, lqc, rng, F);
+    compute_commitment(commitment, interpolator, F);
+
+    // P -> V
+    LigeroTranscript<Field>::write_commitment(commitment, ts);
+  }
+
+  // commit() without the transcript, split into the part that
+  // consumes randomness and the expensive part that does not.
+  // SAMPLE() lays out the tableau and draws the Merkle nonces;
+  // COMPUTE_COMMITMENT() encodes the rows and hashes the columns.
+  // Between the two, the prover does not touch RNG or any shared
+  // state, so that several provers can run COMPUTE_COMMITMENT()
+  // concurrently after sampling in a fixed order.
+  //
+  // If precompute() was called, SAMPLE() consumes no randomness and
+  // only lays out the rows that precompute() could not, and
+  // COMPUTE_COMMITMENT() only encodes those rows and finishes the
+  // column hashes.
+  void sample(const Elt W[/*p_.nw*/], const size_t subfield_boundary,
+              const LigeroQuadraticConstraint lqc[/*nq*/], RandomEngine &rng,
+              const Field &F) {
     // Paranoid check on the SUBFIELD_BOUNDARY correctness condition
     for (size_t i = 0; i < subfield_boundary; ++i) {
       check(F.in_subfield(W[i]), "element not in subfield");
     }
 
-    layout(W, subfield_boundary, lqc, interpolator, rng, F);
+    if (precomputed_) {
+      check(subfield_boundary == pre_subfield_boundary_,
+            "SUBFIELD_BOUNDARY differs from precompute()");
+      for (size_t i = 0; i < p_.nwrow; ++i) {
+        if (is_dynamic_row(i + p_.iw)) {
+          set_witness_rows(i, i + 1, W, F);
+        } else {
+          check(same_witness_row(i, W), "witness differs from precompute()");
+        }
+      }
+      if (is_dynamic_row(p_.iq)) {
+        set_quadratic_rows(W, lqc, F);
+      }
+      return;
+    }
+
+    // Sample all randomness first, in the same order as a row-by-row
+    // layout would, and then encode all rows at once.
+    allocate_rows(subfield_boundary, F);
+    layout_blinding_rows(rng, F);
+    sample_witness_prefixes(subfield_boundary, rng, F);
+    set_witness_rows(0, p_.nwrow, W, F);
+    sample_quadratic_prefixes(rng, F);
+    set_quadratic_rows(W, lqc, F);
+    mc_.sample_nonces(rng);
+  }
 
-    // Merkle commitment
-    auto updhash = [&](size_t j, SHA256 &sha) {
-      LigeroCommon<Field>::column_hash(p_.nrow, &tableau_at(0, j + p_.dblock),
-                                       p_.block_enc, sha, F);
-    };
-    commitment.root = mc_.commit(updhash, rng);
+  // Offline half of sample() and compute_commitment().
+  //
+  // Much of the tableau does not depend on the statement being
+  // proven: the blinding rows, the random prefixes of the witness and
+  // quadratic rows, the Merkle nonces, and the rows of witnesses that
+  // are known ahead of time.  PRECOMPUTE() draws all the randomness of
+  // the next commitment, lays out and encodes every row that does not
+  // depend on W[DYN_BEGIN, DYN_END), and appends the longest prefix of
+  // such rows to the column hashes.  The quadratic rows count as
+  // static only if no constraint in LQC refers to W[DYN_BEGIN,
+  // DYN_END).  The caller may leave W[DYN_BEGIN, DYN_END) undefined.
+  //
+  // The next sample() and compute_commitment() then complete the
+  // commitment.  They must be given the same SUBFIELD_BOUNDARY and
+  // LQC, and a W that agrees with this one outside of [DYN_BEGIN,
+  // DYN_END).  The commitment is distributed as if produced by
+  // sample() alone, but the randomness is drawn in a different order.
+  // A precomputation serves one commitment only.
+  void precompute(const Elt W[/*p_.nw*/], size_t dyn_begin, size_t dyn_end,
+                  const size_t subfield_boundary,
+                  const LigeroQuadraticConstraint lqc[/*nq*/],
+                  const InterpolatorFactory &interpolator, RandomEngine &rng,
+                  const Field &F) {
+    check(dyn_begin <= dyn_end && dyn_end <= p_.nw,
+          "invalid dynamic witness range");
+
+    // Rows [DYN_ROW_BEGIN_, DYN_ROW_END_) hold dynamic witnesses.
+    if (dyn_begin < dyn_end) {
+      dyn_row_begin_ = p_.iw + dyn_begin / p_.w;
+      dyn_row_end_ = p_.iw + (dyn_end + p_.w - 1) / p_.w;
+    } else {
+      dyn_row_begin_ = dyn_row_end_ = p_.iq;
+    }
+    dyn_quad_ = false;
+    for (size_t j = 0; j < p_.nq; ++j) {
+      for (size_t k : {lqc[j].x, lqc[j].y, lqc[j].z}) {
+        dyn_quad_ = dyn_quad_ || (dyn_begin <= k && k < dyn_end);
+      }
+    }
+    if (dyn_row_begin_ < dyn_row_end_) {
+      npre_ = dyn_row_begin_;
+    } else {
+      npre_ = dyn_quad_ ? p_.iq : p_.nrow;
+    }
 
-    // P -> V
-    LigeroTranscript<Field>::write_commitment(commitment, ts);
+    allocate_rows(subfield_boundary, F);
+    layout_blinding_rows(rng, F);
+    sample_witness_prefixes(subfield_boundary, rng, F);
+    sample_quadratic_prefixes(rng, F);
+    mc_.sample_nonces(rng);
+
+    for (size_t i = 0; i < p_.nwrow; ++i) {
+      if (!is_dynamic_row(i + p_.iw)) {
+        set_witness_rows(i, i + 1, W, F);
+      }
+    }
+    if (!dyn_quad_) {
+      set_quadratic_rows(W, lqc, F);
+    }
+
+    const auto interp = interpolator.make(p_.block, p_.block_enc);
+    const auto interpd = interpolator.make(p_.dblock, p_.block_enc);
+    if (stream_rows_ == 0) {
+      encode_range(0, dyn_row_begin_, interp, interpd);
+      encode_range(dyn_row_end_, dyn_quad_ ? p_.iq : p_.nrow, interp, interpd);
+    }
+    pre_sha_ = mc_.begin_leaves();
+    append_rows(0, npre_, pre_sha_, interp, interpd, F);
+
+    pre_subfield_boundary_ = subfield_boundary;
+    precomputed_ = true;
+  }
+
+  void compute_commitment(LigeroCommitment<Field> &commitment,
+                          const InterpolatorFactory &interpolator,
+                          const Field &F) {
+    const auto interp = interpolator.make(p_.block, p_.block_enc);
+    const auto interpd = interpolator.make(p_.dblock, p_.block_enc);
+
+    if (precomputed_) {
+      if (stream_rows_ == 0) {
+        encode_range(dyn_row_begin_, dyn_row_end_, interp, interpd);
+        if (dyn_quad_) {
+          encode_range(p_.iq, p_.nrow, interp, interpd);
+        }
+      }
+      append_rows(npre_, p_.nrow, pre_sha_, interp, interpd, F);
+      commitment.root = mc_.commit_leaves(pre_sha_, *ex_);
+      pre_sha_.clear();
+      precomputed_ = false;
+    } else if (stream_rows_ == 0) {
+      encode_range(0, p_.nrow, interp, interpd);
+
+      // Merkle commitment
+      auto updhash = [&](size_t b, size_t e, SHA256 sha[]) {
+        hash_columns(0, p_.nrow, b, e, sha, F);
+      };
+      commitment.root = mc_.commit_sampled(updhash, *ex_);
+    } else {
+      std::vector<SHA256> sha = mc_.begin_leaves();
+      append_rows(0, p_.nrow, sha, interp, interpd, F);
+      commitment.root = mc_.commit_leaves(sha, *ex_);
+    }
   }
 
   // HASH_OF_LLTERM is a hash of LLTERM provided by the caller.  We
@@ -137,104 +349,158 @@ class LigeroProver {
       // V -> P
       LigeroTranscript<Field>::gen_idx(&idx[0], p_, ts, F);
 
-      compute_req(proof, &idx[0]);
+      compute_req(proof, &idx[0], interpolator);
 
       mc_.open(proof.merkle, &idx[0], p_.nreq);
     }
   }
 
  private:
+  // Only the first DBLOCK columns exist in low-memory mode.  Rows
+  // [IW, IW + NSUB_) are stored compactly in SUB_, and all other rows
+  // in TABLEAU_.
   Elt &tableau_at(size_t i, size_t j) {
-    size_t ld = p_.block_enc;
-    return tableau_[i * ld + j];
+    return tableau_[(i < p_.iw ? i : i - nsub_) * ld_ + j];
+  }
+  SubElt &sub_at(size_t i, size_t j) { return sub_[(i - p_.iw) * ld_ + j]; }
+  bool is_compact_row(size_t i) const {
+    return p_.iw <= i && i < p_.iw + nsub_;
+  }
+
+  // Decide which witness rows are stored compactly, and size the
+  // tableau accordingly.
+  void allocate_rows(size_t subfield_boundary, const Field &F) {
+    nsub_ = 0;
+    if constexpr (kCompactSubfield) {
+      nsub_ = std::min(subfield_boundary / p_.w, p_.nwrow);
+      if (nsub_ > 0 && f16_ == nullptr) {
+        f16_ = std::make_unique<SubField>(F);
+      }
+    }
+    tableau_.resize((p_.nrow - nsub_) * ld_);
+    sub_.resize(nsub_ * ld_);
+  }
+
+  // Row I of the tableau, or its first N elements, in full form.
+  // Compact rows are widened into TMP.
+  const Elt *full_row(size_t i, size_t n, std::vector<Elt> &tmp) {
+    if constexpr (kCompactSubfield) {
+      if (is_compact_row(i)) {
+        for (size_t j = 0; j < n; ++j) {
+          tmp[j] = f16_->widen(sub_at(i, j));
+        }
+        return &tmp[0];
+      }
+    }
+    return &tableau_at(i, 0);
+  }
+
+  // Element J of row I of the tableau in full form.
+  Elt full_at(size_t i, size_t j) {
+    if constexpr (kCompactSubfield) {
+      if (is_compact_row(i)) {
+        return f16_->widen(sub_at(i, j));
+      }
+    }
+    return tableau_at(i, j);
   }
 
   // fill t_[i, [0,n)] with random elements
   // If the base_only flag is true, then the random element is chosen from
   // the base field if F is a field extension.
   void random_row(size_t i, size_t n, RandomEngine &rng, const Field &F) {
-    for (size_t j = 0; j < n; ++j) {
-      tableau_at(i, j) = rng.elt(F);
-    }
+    rng.elt(&tableau_at(i, 0), n, F);
   }
 
   void random_subfield_row(size_t i, size_t n, RandomEngine &rng,
                            const Field &F) {
-    for (size_t j = 0; j < n; ++j) {
-      tableau_at(i, j) = rng.subfield_elt(F);
-    }
+    rng.subfield_elt(&tableau_at(i, 0), n, F);
   }
 
-  // generate the ILDT and IDOT blinding rows
-  void layout_blinding_rows(const InterpolatorFactory &interpolator,
-                            RandomEngine &rng, const Field &F) {
-    {
-      // blinds of size [BLOCK]
-      const auto interp = interpolator.make(p_.block, p_.block_enc);
-
-      // low-degree blinding row
-      random_row(p_.ildt, p_.block, rng, F);
-      interp->interpolate(&tableau_at(p_.ildt, 0));
-    }
-
-    {
-      // blinds of size [DBLOCK]
-      const auto interp = interpolator.make(p_.dblock, p_.block_enc);
-
-      // dot-product blinding row constrained to SUM(W) = 0. First
-      // randomize the dblock:
-      random_row(p_.idot, p_.dblock, rng, F);
+  // generate the ILDT and IDOT blinding rows, except for the
+  // encoding which is done by encode_rows().
+  void layout_blinding_rows(RandomEngine &rng, const Field &F) {
+    // low-degree blinding row of size [BLOCK]
+    random_row(p_.ildt, p_.block, rng, F);
 
-      // Then constrain to sum(W) = 0
-      Elt sum = Blas<Field>::dot1(p_.w, &tableau_at(p_.idot, p_.r), 1, F);
-      F.sub(tableau_at(p_.idot, p_.r), sum);
+    // blinds of size [DBLOCK]
 
-      interp->interpolate(&tableau_at(p_.idot, 0));
+    // dot-product blinding row constrained to SUM(W) = 0. First
+    // randomize the dblock:
+    random_row(p_.idot, p_.dblock, rng, F);
 
-      // quadratic-test blinding row constrained to W = 0.  First
-      // randomize the entire dblock:
-      random_row(p_.iquad, p_.dblock, rng, F);
+    // Then constrain to sum(W) = 0
+    Elt sum = Blas<Field>::dot1(p_.w, &tableau_at(p_.idot, p_.r), 1, F);
+    F.sub(tableau_at(p_.idot, p_.r), sum);
 
-      // Then constrain to W = 0
-      Blas<Field>::clear(p_.w, &tableau_at(p_.iquad, p_.r), 1, F);
+    // quadratic-test blinding row constrained to W = 0.  First
+    // randomize the entire dblock:
+    random_row(p_.iquad, p_.dblock, rng, F);
 
-      interp->interpolate(&tableau_at(p_.iquad, 0));
-    }
+    // Then constrain to W = 0
+    Blas<Field>::clear(p_.w, &tableau_at(p_.iquad, p_.r), 1, F);
   }
 
-  void layout_witness_rows(const Elt W[/*nw*/], size_t subfield_boundary,
-                           const InterpolatorFactory &interpolator,
-                           RandomEngine &rng, const Field &F) {
-    const auto interp = interpolator.make(p_.block, p_.block_enc);
-
-    // witness row EXTEND([RANDOM[R], WITNESS[W]], BLOCK)
+  // witness row EXTEND([RANDOM[R], WITNESS[W]], BLOCK).  The random
+  // prefixes of all rows are drawn first, and the witnesses are
+  // filled in by set_witness_rows().
+  void sample_witness_prefixes(size_t subfield_boundary, RandomEngine &rng,
+                               const Field &F) {
     for (size_t i = 0; i < p_.nwrow; ++i) {
       // TRUE if the entire row is in the subfield
       bool subfield_only = ((i + 1) * p_.w <= subfield_boundary);
 
+      if constexpr (kCompactSubfield) {
+        if (is_compact_row(i + p_.iw)) {
+          // Same randomness as random_subfield_row(), in compact form.
+          rng.subfield_elt(&sub_at(i + p_.iw, 0), p_.r, *f16_);
+          continue;
+        }
+      }
       if (subfield_only) {
         random_subfield_row(i + p_.iw, p_.r, rng, F);
       } else {
         random_row(i + p_.iw, p_.r, rng, F);
       }
+    }
+  }
+
+  // Fill in the witnesses of witness rows [B, E), counting from IW.
+  void set_witness_rows(size_t b, size_t e, const Elt W[/*nw*/],
+                        const Field &F) {
+    for (size_t i = b; i < e; ++i) {
+      size_t max_col = std::min(p_.w, p_.nw - i * p_.w);
+      if constexpr (kCompactSubfield) {
+        if (is_compact_row(i + p_.iw)) {
+          // Same as below, in compact form.
+          for (size_t j = 0; j < p_.w; ++j) {
+            sub_at(i + p_.iw, p_.r + j) =
+                j < max_col ? f16_->narrow(W[i * p_.w + j]) : f16_->zero();
+          }
+          continue;
+        }
+      }
 
       // Set the WITNESS columns to zero first, and then
       // overwrite with the witnesses that actually exist
       Blas<Field>::clear(p_.w, &tableau_at(i + p_.iw, p_.r), 1, F);
-      size_t max_col = std::min(p_.w, p_.nw - i * p_.w);
       Blas<Field>::copy(max_col, &tableau_at(i + p_.iw, p_.r), 1, &W[i * p_.w],
                         1);
-      interp->interpolate(&tableau_at(i + p_.iw, 0));
     }
   }
 
-  void layout_quadratic_rows(const Elt W[/*nw*/],
-                             const LigeroQuadraticConstraint lqc[/*nq*/],
-                             const InterpolatorFactory &interpolator,
-                             RandomEngine &rng, const Field &F) {
-    const auto interp = interpolator.make(p_.block, p_.block_enc);
+  // True if witness row I, counting from IW, holds W.
+  bool same_witness_row(size_t i, const Elt W[/*nw*/]) {
+    size_t max_col = std::min(p_.w, p_.nw - i * p_.w);
+    for (size_t j = 0; j < max_col; ++j) {
+      if (full_at(i + p_.iw, p_.r + j) != W[i * p_.w + j]) {
+        return false;
+      }
+    }
+    return true;
+  }
 
-    // copy the multiplicand witnesses into the quadratic rows
+  void sample_quadratic_prefixes(RandomEngine &rng, const Field &F) {
     size_t iqx = p_.iq;
     size_t iqy = iqx + p_.nqtriples;
     size_t iqz = iqy + p_.nqtriples;
@@ -243,7 +509,18 @@ class LigeroProver {
       random_row(iqx + i, p_.r, rng, F);
       random_row(iqy + i, p_.r, rng, F);
       random_row(iqz + i, p_.r, rng, F);
+    }
+  }
 
+  void set_quadratic_rows(const Elt W[/*nw*/],
+                          const LigeroQuadraticConstraint lqc[/*nq*/],
+                          const Field &F) {
+    // copy the multiplicand witnesses into the quadratic rows
+    size_t iqx = p_.iq;
+    size_t iqy = iqx + p_.nqtriples;
+    size_t iqz = iqy + p_.nqtriples;
+
+    for (size_t i = 0; i < p_.nqtriples; ++i) {
       // clear everything first, then overwrite the witnesses that
       // actually exist
       Blas<Field>::clear(p_.w, &tableau_at(iqx + i, p_.r), 1, F);
@@ -258,19 +535,160 @@ class LigeroProver {
         tableau_at(iqy + i, j + p_.r) = W[l->y];
         tableau_at(iqz + i, j + p_.r) = W[l->z];
       }
-      interp->interpolate(&tableau_at(iqx + i, 0));
-      interp->interpolate(&tableau_at(iqy + i, 0));
-      interp->interpolate(&tableau_at(iqz + i, 0));
     }
   }
 
-  void layout(const Elt W[/*nw*/], size_t subfield_boundary,
-              const LigeroQuadraticConstraint lqc[/*nq*/],
-              const InterpolatorFactory &interpolator, RandomEngine &rng,
-              const Field &F) {
-    layout_blinding_rows(interpolator, rng, F);
-    layout_witness_rows(W, subfield_boundary, interpolator, rng, F);
-    layout_quadratic_rows(W, lqc, interpolator, rng, F);
+  // Extend rows [B, E) of the tableau to BLOCK_ENC, where row I is
+  // stored at T[(I - B) * BLOCK_ENC].  All rows are encoded from their
+  // first BLOCK elements, except for the IDOT and IQUAD blinding rows
+  // which are encoded from DBLOCK elements.
+  //
+  // Rows are independent, so they are handed out to the executor in
+  // contiguous chunks, and each run of rows with the same encoding
+  // goes through interpolate_many().  Encoding consumes no randomness,
+  // and thus the tableau is the same as in the serial order.
+  template <class Interpolator>
+  void encode_rows(size_t b, size_t e, Elt T[/*e - b, block_enc*/],
+                   const Interpolator &interp, const Interpolator &interpd) {
+    auto row = [&](size_t i) { return &T[(i - b) * p_.block_enc]; };
+
+    ex_->parallel_for(e - b, 1, [&](size_t i, size_t end) {
+      i += b;
+      end += b;
+      while (i < end) {
+        if (i == p_.idot || i == p_.iquad) {
+          interpd->interpolate_many(1, row(i), p_.block_enc);
+          ++i;
+        } else {
+          size_t j = i + 1;
+          while (j < end && j != p_.idot && j != p_.iquad) {
+            ++j;
+          }
+          interp->interpolate_many(j - i, row(i), p_.block_enc);
+          i = j;
+        }
+      }
+    });
+  }
+
+  // True if row I depends on the witnesses that precompute() left out.
+  bool is_dynamic_row(size_t i) const {
+    return (dyn_row_begin_ <= i && i < dyn_row_end_) ||
+           (dyn_quad_ && i >= p_.iq);
+  }
+
+  // Append rows [B, E) of the tableau to the column hashes SHA.  In
+  // low-memory mode, the rows are encoded here, one window at a time;
+  // otherwise they must have been encoded already.  The hash only
+  // depends on the byte stream of each column, and so the leaves are
+  // the same as if all rows were hashed at once.
+  template <class Interpolator>
+  void append_rows(size_t b, size_t e, std::vector<SHA256> &sha,
+                   const Interpolator &interp, const Interpolator &interpd,
+                   const Field &F) {
+    size_t ncol = p_.block_enc - p_.dblock;
+    if (stream_rows_ == 0) {
+      ex_->parallel_for(ncol, kColumnsPerTask, [&](size_t cb, size_t ce) {
+        hash_columns(b, e, cb, ce, &sha[cb], F);
+      });
+    } else {
+      std::vector<Elt> win(stream_rows_ * p_.block_enc);
+      for (size_t wb = b; wb < e; wb += stream_rows_) {
+        size_t we = std::min(wb + stream_rows_, e);
+        encode_window(wb, we, &win[0], interp, interpd);
+        ex_->parallel_for(ncol, kColumnsPerTask, [&](size_t cb, size_t ce) {
+          LigeroCommon<Field>::column_hash_many(we - wb, &win[cb + p_.dblock],
+                                                p_.block_enc, ce - cb,
+                                                &sha[cb], F);
+        });
+      }
+    }
+  }
+
+  // Encode rows [B, E) of the full tableau in place, the compact rows
+  // in the subfield and the others via encode_rows().
+  template <class Interpolator>
+  void encode_range(size_t b, size_t e, const Interpolator &interp,
+                    const Interpolator &interpd) {
+    size_t b1 = std::clamp(p_.iw, b, e);
+    size_t e1 = std::clamp(p_.iw + nsub_, b, e);
+    if (b < b1) {
+      encode_rows(b, b1, &tableau_at(b, 0), interp, interpd);
+    }
+    if constexpr (kCompactSubfield) {
+      if (b1 < e1) {
+        const LCH14ReedSolomon<SubField> interp16(p_.block, p_.block_enc,
+                                                  *f16_);
+        ex_->parallel_for(e1 - b1, 1, [&](size_t i, size_t end) {
+          interp16.interpolate_many(end - i, &sub_at(b1 + i, 0), p_.block_enc);
+        });
+      }
+    }
+    if (e1 < e) {
+      encode_rows(e1, e, &tableau_at(e1, 0), interp, interpd);
+    }
+  }
+
+  // Append the encoded columns [CB, CE) of rows [B, E) of the full
+  // tableau to SHA[0, CE - CB).  The bytes of compact elements are
+  // those of their full form.
+  void hash_columns(size_t b, size_t e, size_t cb, size_t ce, SHA256 sha[],
+                    const Field &F) {
+    size_t b1 = std::clamp(p_.iw, b, e);
+    size_t e1 = std::clamp(p_.iw + nsub_, b, e);
+    if (b < b1) {
+      LigeroCommon<Field>::column_hash_many(b1 - b,
+                                            &tableau_at(b, cb + p_.dblock),
+                                            p_.block_enc, ce - cb, sha, F);
+    }
+    if constexpr (kCompactSubfield) {
+      if (b1 < e1) {
+        LigeroCommon<Field>::column_hash_many(
+            e1 - b1, &sub_at(b1, cb + p_.dblock), p_.block_enc, ce - cb, sha,
+            [&](uint8_t buf[], const SubElt &x) {
+              F.to_bytes_field(buf, f16_->widen(x));
+            });
+      }
+    }
+    if (e1 < e) {
+      LigeroCommon<Field>::column_hash_many(e - e1,
+                                            &tableau_at(e1, cb + p_.dblock),
+                                            p_.block_enc, ce - cb, sha, F);
+    }
+  }
+
+  // Low-memory mode: encode rows [B, E) from the first DBLOCK columns
+  // kept in the tableau into WIN, and store the encoded columns
+  // [BLOCK, DBLOCK) back into the tableau.  Compact rows are widened
+  // into WIN and narrowed back.
+  template <class Interpolator>
+  void encode_window(size_t b, size_t e, Elt win[/*e - b, block_enc*/],
+                     const Interpolator &interp, const Interpolator &interpd) {
+    for (size_t i = b; i < e; ++i) {
+      Elt *row = &win[(i - b) * p_.block_enc];
+      if constexpr (kCompactSubfield) {
+        if (is_compact_row(i)) {
+          for (size_t j = 0; j < p_.dblock; ++j) {
+            row[j] = f16_->widen(sub_at(i, j));
+          }
+          continue;
+        }
+      }
+      Blas<Field>::copy(p_.dblock, row, 1, &tableau_at(i, 0), 1);
+    }
+    encode_rows(b, e, win, interp, interpd);
+    for (size_t i = b; i < e; ++i) {
+      const Elt *row = &win[(i - b) * p_.block_enc];
+      if constexpr (kCompactSubfield) {
+        if (is_compact_row(i)) {
+          for (size_t j = p_.block; j < p_.dblock; ++j) {
+            sub_at(i, j) = f16_->narrow(row[j]);
+          }
+          continue;
+        }
+      }
+      Blas<Field>::copy(p_.dblock, &tableau_at(i, 0), 1, row, 1);
+    }
   }
 
   void low_degree_proof(Elt y[/*block*/], const Elt u_ldt[/*nwqrow*/],
@@ -279,10 +697,12 @@ class LigeroProver {
     Blas<Field>::copy(p_.block, y, 1, &tableau_at(p_.ildt, 0), 1);
 
     // all witness and quadratic rows with coefficient u_ldt[]
+    BlasAccumulator<Field> sum(p_.block, F);
+    std::vector<Elt> tmp(nsub_ > 0 ? p_.block : 0);
     for (size_t i = 0; i < p_.nwqrow; ++i) {
-      Blas<Field>::axpy(p_.block, y, 1, u_ldt[i], &tableau_at(i + p_.iw, 0), 1,
-                        F);
+      sum.axpy(u_ldt[i], full_row(i + p_.iw, p_.block, tmp));
     }
+    sum.add_to(y);
   }
 
   void dot_proof(Elt y[/*dblock*/], const Elt A[/*nwqrow, w*/],
@@ -293,14 +713,16 @@ class LigeroProver {
     Blas<Field>::copy(p_.dblock, y, 1, &tableau_at(p_.idot, 0), 1);
 
     std::vector<Elt> Aext(p_.dblock);
+    std::vector<Elt> tmp(nsub_ > 0 ? p_.dblock : 0);
+    BlasAccumulator<Field> sum(p_.dblock, F);
     for (size_t i = 0; i < p_.nwqrow; ++i) {
       LigeroCommon<Field>::layout_Aext(&Aext[0], p_, i, &A[0], F);
       interpA->interpolate(&Aext[0]);
 
       // Accumulate y += A \otimes W.
-      Blas<Field>::vaxpy(p_.dblock, &y[0], 1, &Aext[0], 1,
-                         &tableau_at(i + p_.iw, 0), 1, F);
+      sum.vaxpy(&Aext[0], full_row(i + p_.iw, p_.dblock, tmp));
     }
+    sum.add_to(y);
   }
 
   void quadratic_proof(Elt y0[/*r*/], Elt y2[/*dblock - block*/],
@@ -315,6 +737,7 @@ class LigeroProver {
     size_t iqy = iqx + p_.nqtriples;
     size_t iqz = iqy + p_.nqtriples;
 
+    BlasAccumulator<Field> sum(p_.dblock, F);
     for (size_t i = 0; i < p_.nqtriples; ++i) {
       // y += u_quad[i] * (z[i] - x[i] * y[i])
 
@@ -326,8 +749,9 @@ class LigeroProver {
                          &tableau_at(iqy + i, 0), 1, F);
 
       // y += u_quad[i] * tmp
-      Blas<Field>::axpy(p_.dblock, &y[0], 1, u_quad[i], &tmp[0], 1, F);
+      sum.axpy(u_quad[i], &tmp[0]);
     }
+    sum.add_to(&y[0]);
 
     // sanity check: the W part of Y is zero
     bool ok = Blas<Field>::equal0(p_.w, &y[p_.r], 1, F);
@@ -338,16 +762,59 @@ class LigeroProver {
     Blas<Field>::copy(p_.dblock - p_.block, y2, 1, &y[p_.block], 1);
   }
 
-  void compute_req(LigeroProof<Field> &proof, const size_t idx[/*nreq*/]) {
-    for (size_t i = 0; i < p_.nrow; ++i) {
-      Blas<Field>::gather(p_.nreq, &proof.req_at(i, 0),
-                          &tableau_at(i, p_.dblock), idx);
+  void compute_req(LigeroProof<Field> &proof, const size_t idx[/*nreq*/],
+                   const InterpolatorFactory &interpolator) {
+    if (stream_rows_ == 0) {
+      for (size_t i = 0; i < p_.nrow; ++i) {
+        if constexpr (kCompactSubfield) {
+          if (is_compact_row(i)) {
+            for (size_t k = 0; k < p_.nreq; ++k) {
+              proof.req_at(i, k) = f16_->widen(sub_at(i, p_.dblock + idx[k]));
+            }
+            continue;
+          }
+        }
+        Blas<Field>::gather(p_.nreq, &proof.req_at(i, 0),
+                            &tableau_at(i, p_.dblock), idx);
+      }
+    } else {
+      // Recompute the encoded rows, one window at a time.
+      const auto interp = interpolator.make(p_.block, p_.block_enc);
+      const auto interpd = interpolator.make(p_.dblock, p_.block_enc);
+      std::vector<Elt> win(stream_rows_ * p_.block_enc);
+      for (size_t b = 0; b < p_.nrow; b += stream_rows_) {
+        size_t e = std::min(b + stream_rows_, p_.nrow);
+        encode_window(b, e, &win[0], interp, interpd);
+        for (size_t i = b; i < e; ++i) {
+          Blas<Field>::gather(p_.nreq, &proof.req_at(i, 0),
+                              &win[(i - b) * p_.block_enc + p_.dblock], idx);
+        }
+      }
     }
   }
 
+  // Minimum number of columns hashed by one task in append_rows().
+  static constexpr size_t kColumnsPerTask = 16;
+
   const LigeroParam<Field> p_; /* safer to make copy */
   MerkleCommitment mc_;
-  std::vector<Elt> tableau_ /*[nrow, block_enc]*/;
+  size_t stream_rows_;
+  size_t ld_;  // leading dimension of tableau_, BLOCK_ENC or DBLOCK
+  size_t nsub_;  // number of compact rows
+  std::vector<Elt> tableau_ /*[nrow - nsub_, ld_]*/;
+  std::vector<SubElt> sub_ /*[nsub_, ld_]*/;
+  std::unique_ptr<SubField> f16_;
+  SerialExecutor serial_;
+  Executor *ex_;
+
+  // State of precompute(), valid while PRECOMPUTED_ is true.  Rows
+  // [0, NPRE_) are already in PRE_SHA_.
+  bool precomputed_;
+  size_t pre_subfield_boundary_;
+  size_t dyn_row_begin_, dyn_row_end_;
+  bool dyn_quad_;
+  size_t npre_;
+  std::vector<SHA256> pre_sha_;
 };
 }  // namespace proofs
 
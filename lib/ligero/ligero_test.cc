@@ -14,6 +14,7 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <vector>
@@ -21,8 +22,11 @@
 #include "algebra/blas.h"
 #include "algebra/convolution.h"
 #include "algebra/fp.h"
+#include "algebra/fp2.h"
 #include "algebra/reed_solomon.h"
+#include "ec/p256.h"
 #include "gf2k/gf2_128.h"
+#include "gf2k/gf2_16.h"
 #include "gf2k/lch14_reed_solomon.h"
 #include "ligero/ligero_param.h"
 #include "ligero/ligero_prover.h"
@@ -30,6 +34,8 @@
 #include "random/secure_random_engine.h"
 #include "random/transcript.h"
 #include "util/log.h"
+#include "util/thread_pool.h"
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
 namespace proofs {
@@ -65,18 +71,21 @@ void ligero_test(const ReedSolomonFactory &rs_factory, const Field &F) {
     W[lqc[i].z] = F.mulf(W[lqc[i].x], W[lqc[i].y]);
   }
 
-  // Generate NL linear constraints.
+  // Generate NL linear constraints.  Every third witness appears in
+  // a second, adjacent term.
   std::vector<LigeroLinearConstraint<Field>> llterm;
   std::vector<Elt> b(nl);
   Blas<Field>::clear(nl, &b[0], 1, F);
   for (size_t w = 0; w < nw; ++w) {
-    LigeroLinearConstraint<Field> term = {
-        w % nl,  // c
-        w,       // w
-        A[w],    // k
-    };
-    llterm.push_back(term);
-    F.add(b[term.c], F.mulf(W[w], term.k));
+    for (size_t k = 0; k < (w % 3 == 0 ? 2 : 1); ++k) {
+      LigeroLinearConstraint<Field> term = {
+          (w + k) % nl,                        // c
+          w,                                   // w
+          F.addf(A[w], F.of_scalar_field(k)),  // k
+      };
+      llterm.push_back(term);
+      F.add(b[term.c], F.mulf(W[w], term.k));
+    }
   }
 
   LigeroCommitment<Field> commitment;
@@ -110,6 +119,261 @@ void ligero_test(const ReedSolomonFactory &rs_factory, const Field &F) {
   }
 }
 
+// Check that the prover produces the same commitment and proof
+// with and without a thread pool, and in low-memory mode, given the
+// same random stream, and that low-memory mode stays within its
+// memory bound.
+template <class Field, class ReedSolomonFactory>
+void ligero_parallel_test(const ReedSolomonFactory &rs_factory,
+                          const Field &F) {
+  using Elt = typename Field::Elt;
+  static const constexpr size_t nw = 3000;
+  static const constexpr size_t nq = 300;
+  static const constexpr size_t nreq = 16;
+  static const constexpr size_t nl = 3;
+  LigeroParam<Field> param(nw, nq, /*rateinv=*/4, nreq);
+
+  std::vector<Elt> W(nw);
+  for (size_t i = 0; i < nw; ++i) {
+    W[i] = F.of_scalar_field(random());
+  }
+  std::vector<LigeroQuadraticConstraint> lqc(nq);
+  for (size_t i = 0; i < nq; ++i) {
+    lqc[i].z = 2 * i + 1;
+    lqc[i].x = 2 * ((random() % nw) / 2);
+    lqc[i].y = 2 * ((random() % nw) / 2);
+    W[lqc[i].z] = F.mulf(W[lqc[i].x], W[lqc[i].y]);
+  }
+  std::vector<LigeroLinearConstraint<Field>> llterm;
+  for (size_t w = 0; w < nw; ++w) {
+    llterm.push_back({w % nl, w, F.of_scalar_field(random())});
+  }
+  const LigeroHash hash_of_llterm{0xde, 0xad, 0xbe, 0xef};
+
+  auto run = [&](Executor *ex, size_t stream_rows,
+                 LigeroCommitment<Field> &commitment,
+                 LigeroProof<Field> &proof) {
+    // The transcript doubles as a deterministic random engine.
+    Transcript rng((uint8_t *)"rng", 3);
+    LigeroProver<Field, ReedSolomonFactory> prover(param, ex, stream_rows);
+    Transcript ts((uint8_t *)"test", 4);
+    prover.commit(commitment, ts, &W[0], /*subfield_boundary=*/0, &lqc[0],
+                  rs_factory, rng, F);
+    prover.prove(proof, ts, nl, llterm.size(), &llterm[0], hash_of_llterm,
+                 &lqc[0], rs_factory, F);
+    return prover.peak_bytes();
+  };
+
+  LigeroCommitment<Field> com0;
+  LigeroProof<Field> proof0(&param);
+  ThreadPool pool(4);
+  size_t full_bytes = run(nullptr, /*stream_rows=*/0, com0, proof0);
+  EXPECT_GE(full_bytes, param.nrow * param.block_enc * sizeof(Elt));
+
+  // a window of 7 rows need not align with NROW, IDOT, or IQUAD
+  for (size_t stream_rows : {0, 7}) {
+    LigeroCommitment<Field> com1;
+    LigeroProof<Field> proof1(&param);
+    size_t bytes = run(&pool, stream_rows, com1, proof1);
+    if (stream_rows > 0) {
+      // NROW x DBLOCK + STREAM_ROWS x BLOCK_ENC elements
+      EXPECT_LE(bytes, (param.nrow * param.dblock +
+                        stream_rows * param.block_enc) * sizeof(Elt));
+      EXPECT_LT(bytes, full_bytes);
+    }
+
+    EXPECT_EQ(com0.root, com1.root);
+    EXPECT_EQ(proof0.y_ldt, proof1.y_ldt);
+    EXPECT_EQ(proof0.y_dot, proof1.y_dot);
+    EXPECT_EQ(proof0.y_quad_0, proof1.y_quad_0);
+    EXPECT_EQ(proof0.y_quad_2, proof1.y_quad_2);
+    EXPECT_EQ(proof0.req, proof1.req);
+    EXPECT_EQ(proof0.merkle.path, proof1.merkle.path);
+  }
+}
+
+// Check that a commitment completed from precompute() verifies, in
+// all modes, and that the online phase does not depend on the
+// witnesses it is not given offline.
+template <class Field, class ReedSolomonFactory>
+void ligero_precompute_test(const ReedSolomonFactory &rs_factory,
+                            const Field &F) {
+  using Elt = typename Field::Elt;
+  static const constexpr size_t nw = 3000;
+  static const constexpr size_t nq = 300;
+  static const constexpr size_t nreq = 16;
+  static const constexpr size_t nl = 3;
+  LigeroParam<Field> param(nw, nq, /*rateinv=*/4, nreq);
+
+  std::vector<Elt> W(nw);
+  for (size_t i = 0; i < nw; ++i) {
+    W[i] = F.of_scalar_field(random());
+  }
+
+  // The quadratic constraints only refer to the first half of W, so
+  // that they are static unless the dynamic range reaches into it.
+  std::vector<LigeroQuadraticConstraint> lqc(nq);
+  for (size_t i = 0; i < nq; ++i) {
+    lqc[i].z = 2 * i + 1;
+    lqc[i].x = 2 * ((random() % (nw / 2)) / 2);
+    lqc[i].y = 2 * ((random() % (nw / 2)) / 2);
+    W[lqc[i].z] = F.mulf(W[lqc[i].x], W[lqc[i].y]);
+  }
+  std::vector<LigeroLinearConstraint<Field>> llterm;
+  std::vector<Elt> b(nl);
+  Blas<Field>::clear(nl, &b[0], 1, F);
+  for (size_t w = 0; w < nw; ++w) {
+    LigeroLinearConstraint<Field> term = {w % nl, w,
+                                          F.of_scalar_field(random())};
+    llterm.push_back(term);
+    F.add(b[term.c], F.mulf(W[w], term.k));
+  }
+  const LigeroHash hash_of_llterm{0xde, 0xad, 0xbe, 0xef};
+
+  ThreadPool pool(4);
+  LigeroCommitment<Field> com0;
+
+  // dynamic witness ranges: none, unaligned in the static half,
+  // overlapping the quadratic constraints, and everything
+  size_t ranges[][2] = {{0, 0}, {1700, 2900}, {5, 1900}, {0, nw}};
+  for (const auto &range : ranges) {
+    // Garbage in the dynamic range offline.
+    std::vector<Elt> Woff = W;
+    for (size_t i = range[0]; i < range[1]; ++i) {
+      Woff[i] = F.of_scalar_field(random());
+    }
+
+    for (size_t stream_rows : {0, 7}) {
+      // The prover is reused to check that the precomputation is
+      // consumed by the first commitment.
+      LigeroProver<Field, ReedSolomonFactory> prover(param, &pool,
+                                                     stream_rows);
+      for (size_t round = 0; round < 2; ++round) {
+        Transcript rng((uint8_t *)"rng", 3);
+        LigeroCommitment<Field> com;
+        LigeroProof<Field> proof(&param);
+        Transcript ts((uint8_t *)"test", 4);
+        if (round == 0) {
+          prover.precompute(&Woff[0], range[0], range[1],
+                            /*subfield_boundary=*/0, &lqc[0], rs_factory,
+                            rng, F);
+        }
+        prover.commit(com, ts, &W[0], /*subfield_boundary=*/0, &lqc[0],
+                      rs_factory, rng, F);
+        prover.prove(proof, ts, nl, llterm.size(), &llterm[0],
+                     hash_of_llterm, &lqc[0], rs_factory, F);
+
+        // Given the same random stream, the commitment does not depend
+        // on the dynamic range or the mode.
+        if (round == 0) {
+          if (range[0] == 0 && range[1] == 0 && stream_rows == 0) {
+            com0 = com;
+          }
+          EXPECT_EQ(com0.root, com.root);
+        }
+
+        using Verifier = LigeroVerifier<Field, ReedSolomonFactory>;
+        Transcript tv((uint8_t *)"test", 4);
+        Verifier::receive_commitment(com, tv);
+        const char *why = "";
+        EXPECT_TRUE(Verifier::verify(&why, param, com, proof, tv, nl,
+                                     llterm.size(), &llterm[0], hash_of_llterm,
+                                     &b[0], &lqc[0], rs_factory, F));
+      }
+    }
+  }
+}
+
+// Over GF2_128, the prover stores the witness rows below
+// SUBFIELD_BOUNDARY in compact form, also in low-memory mode.  Check
+// that the default and low-memory modes produce the same commitment
+// and proof, also when completing a precomputation, that the proof
+// verifies, and that low-memory mode keeps the compact rows in 2-byte
+// form.
+template <class Field, class ReedSolomonFactory>
+void ligero_subfield_test(const ReedSolomonFactory &rs_factory,
+                          const Field &F) {
+  using Elt = typename Field::Elt;
+  static const constexpr size_t nw = 3000;
+  static const constexpr size_t nq = 300;
+  static const constexpr size_t nreq = 16;
+  static const constexpr size_t nl = 3;
+  static const constexpr size_t subfield_boundary = 2000;
+  LigeroParam<Field> param(nw, nq, /*rateinv=*/4, nreq);
+
+  std::vector<Elt> W(nw);
+  for (size_t i = 0; i < nw; ++i) {
+    W[i] = (i < subfield_boundary) ? F.of_scalar(random() & 0xFFFF)
+                                   : F.of_scalar_field(random());
+  }
+
+  // Quadratic constraints on the full-field witnesses only.
+  std::vector<LigeroQuadraticConstraint> lqc(nq);
+  for (size_t i = 0; i < nq; ++i) {
+    lqc[i].z = subfield_boundary + 2 * i + 1;
+    lqc[i].x = subfield_boundary + 2 * (random() % 400);
+    lqc[i].y = subfield_boundary + 2 * (random() % 400);
+    W[lqc[i].z] = F.mulf(W[lqc[i].x], W[lqc[i].y]);
+  }
+  std::vector<LigeroLinearConstraint<Field>> llterm;
+  std::vector<Elt> b(nl);
+  Blas<Field>::clear(nl, &b[0], 1, F);
+  for (size_t w = 0; w < nw; ++w) {
+    LigeroLinearConstraint<Field> term = {w % nl, w,
+                                          F.of_scalar_field(random())};
+    llterm.push_back(term);
+    F.add(b[term.c], F.mulf(W[w], term.k));
+  }
+  const LigeroHash hash_of_llterm{0xde, 0xad, 0xbe, 0xef};
+
+  // NROW x DBLOCK + STREAM_ROWS x BLOCK_ENC elements, where the
+  // NSUB compact rows take 2 bytes per element.
+  size_t nsub = std::min(subfield_boundary / param.w, param.nwrow);
+  ASSERT_GT(nsub, 0u);
+  size_t stream_bytes =
+      ((param.nrow - nsub) * param.dblock + 7 * param.block_enc) *
+          sizeof(Elt) +
+      nsub * param.dblock * sizeof(typename GF2_16<Field>::Elt);
+
+  ThreadPool pool(4);
+  for (bool precompute : {false, true}) {
+    LigeroCommitment<Field> com[2];
+    LigeroProof<Field> proof0(&param), proof1(&param);
+    LigeroProof<Field> *proof[2] = {&proof0, &proof1};
+    size_t bytes[2];
+    for (size_t k = 0; k < 2; ++k) {
+      Transcript rng((uint8_t *)"rng", 3);
+      LigeroProver<Field, ReedSolomonFactory> prover(param, &pool,
+                                                     /*stream_rows=*/k * 7);
+      if (precompute) {
+        prover.precompute(&W[0], 500, 1500, subfield_boundary, &lqc[0],
+                          rs_factory, rng, F);
+      }
+      Transcript ts((uint8_t *)"test", 4);
+      prover.commit(com[k], ts, &W[0], subfield_boundary, &lqc[0], rs_factory,
+                    rng, F);
+      prover.prove(*proof[k], ts, nl, llterm.size(), &llterm[0],
+                   hash_of_llterm, &lqc[0], rs_factory, F);
+      bytes[k] = prover.peak_bytes();
+    }
+    EXPECT_LE(bytes[1], stream_bytes);
+    EXPECT_LT(bytes[1], bytes[0]);
+    EXPECT_EQ(com[0].root, com[1].root);
+    EXPECT_EQ(proof0.y_ldt, proof1.y_ldt);
+    EXPECT_EQ(proof0.y_dot, proof1.y_dot);
+    EXPECT_EQ(proof0.req, proof1.req);
+    EXPECT_EQ(proof0.merkle.path, proof1.merkle.path);
+
+    using Verifier = LigeroVerifier<Field, ReedSolomonFactory>;
+    Transcript tv((uint8_t *)"test", 4);
+    Verifier::receive_commitment(com[0], tv);
+    const char *why = "";
+    EXPECT_TRUE(Verifier::verify(&why, param, com[0], proof0, tv, nl,
+                                 llterm.size(), &llterm[0], hash_of_llterm,
+                                 &b[0], &lqc[0], rs_factory, F));
+  }
+}
+
 TEST(Ligero, Fp) {
   using Field = Fp<1>;
   using ConvolutionFactory = FFTConvolutionFactory<Field>;
@@ -121,6 +385,8 @@ TEST(Ligero, Fp) {
   const ReedSolomonFactory rs_factory(conv_factory, F);
 
   ligero_test(rs_factory, F);
+  ligero_parallel_test(rs_factory, F);
+  ligero_precompute_test(rs_factory, F);
 }
 
 TEST(Ligero, GF2_128) {
@@ -130,7 +396,101 @@ TEST(Ligero, GF2_128) {
   const ReedSolomonFactory rs_factory(F);
 
   ligero_test(rs_factory, F);
+  ligero_parallel_test(rs_factory, F);
+  ligero_precompute_test(rs_factory, F);
+  ligero_subfield_test(rs_factory, F);
 }
 
 }  // namespace
+
+namespace bench {
+// Cost per row of the two ways in which the verifier's dot_check
+// evaluates an encoded row at the NREQ opened columns: a full
+// interpolation followed by a gather, or NREQ dot products of length W
+// with precomputed Lagrange coefficients.  The "cost" counter is the
+// estimate that dot_check compares, in multiply-adds.  Arguments are
+// BLOCK_ENC and whether to use the Lagrange coefficients.
+template <class Field, class InterpolatorFactory>
+void req_columns_bench(benchmark::State &state,
+                       const InterpolatorFactory &interpolator,
+                       const Field &F) {
+  using Elt = typename Field::Elt;
+  LigeroParam<Field> p(1000000, 1000, /*rateinv=*/4, /*nreq=*/128);
+  if (p.layout(state.range(0)) == SIZE_MAX) {
+    state.SkipWithError("infeasible BLOCK_ENC");
+    return;
+  }
+  bool use_weights = state.range(1) != 0;
+
+  std::vector<Elt> A(p.w);
+  for (size_t j = 0; j < p.w; ++j) {
+    A[j] = F.of_scalar(3 * j + 1);
+  }
+  std::vector<size_t> idx(p.nreq), col(p.nreq);
+  for (size_t k = 0; k < p.nreq; ++k) {
+    idx[k] = (37 * k) % (p.block_enc - p.dblock);
+    col[k] = p.dblock + idx[k];
+  }
+  const auto interpA = interpolator.make(p.block, p.block_enc);
+  std::vector<Elt> Lb(p.nreq * p.block);
+  interpA->lagrange_weights(p.nreq, &Lb[0], &col[0]);
+  std::vector<Elt> Aext(p.block_enc), Areq(p.nreq);
+
+  for (auto _ : state) {
+    if (use_weights) {
+      for (size_t k = 0; k < p.nreq; ++k) {
+        Areq[k] = Blas<Field>::dot(p.w, &Lb[k * p.block + p.r], 1, &A[0], 1,
+                                   F);
+      }
+    } else {
+      LigeroCommon<Field>::layout_Aext(&Aext[0], p, 0, &A[0], F);
+      interpA->interpolate(&Aext[0]);
+      Blas<Field>::gather(p.nreq, &Areq[0], &Aext[p.dblock], &idx[0]);
+    }
+    benchmark::DoNotOptimize(Areq);
+  }
+  state.counters["cost"] =
+      use_weights ? p.nreq * p.w : interpA->interpolate_cost();
+}
+
+void BM_LigeroReqColumns_gf128(benchmark::State &state) {
+  using Field = GF2_128<>;
+  static const Field F;
+  const LCH14ReedSolomonFactory<Field> rs_factory(F);
+  req_columns_bench(state, rs_factory, F);
+}
+
+void BM_LigeroReqColumns_fp64(benchmark::State &state) {
+  using Field = Fp<1>;
+  using ConvolutionFactory = FFTConvolutionFactory<Field>;
+  static const Field F("18446744069414584321");
+  const ConvolutionFactory conv_factory(F, F.of_scalar(1753635133440165772ull),
+                                        1ull << 32);
+  const ReedSolomonFactory<Field, ConvolutionFactory> rs_factory(conv_factory,
+                                                                 F);
+  req_columns_bench(state, rs_factory, F);
+}
+
+void BM_LigeroReqColumns_p256(benchmark::State &state) {
+  using Field2 = Fp2<Fp256Base>;
+  using ConvolutionFactory = FFTExtConvolutionFactory<Fp256Base, Field2>;
+  static const Field2 F2(p256_base);
+  const ConvolutionFactory conv_factory(
+      p256_base, F2,
+      F2.of_string("11264922414641028187350045760969025837301884043048940872"
+                   "9223714171582664680802",
+                   "84087994358540907695740461427818660560182168997182378749"
+                   "313018254450460212908"),
+      1ull << 31);
+  const ReedSolomonFactory<Fp256Base, ConvolutionFactory> rs_factory(
+      conv_factory, p256_base);
+  req_columns_bench(state, rs_factory, p256_base);
+}
+
+BENCHMARK(BM_LigeroReqColumns_gf128)
+    ->ArgsProduct({{2048, 4096, 8192, 16384}, {0, 1}});
+BENCHMARK(BM_LigeroReqColumns_fp64)
+    ->ArgsProduct({{2048, 4096, 8192, 16384}, {0, 1}});
+BENCHMARK(BM_LigeroReqColumns_p256)->ArgsProduct({{2048, 4096, 8192}, {0, 1}});
+}  // namespace bench
 }  // namespace proofs
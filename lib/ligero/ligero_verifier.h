@@ -88,7 +88,15 @@ class LigeroVerifier {
       return false;
     }
 
-    if (!low_degree_check(p, proof, &idx[0], &u_ldt[0], interpolator, F)) {
+    // Lagrange coefficients of the opened columns as a function of the
+    // first BLOCK or DBLOCK columns of a row, computed once and shared
+    // by all checks below.
+    std::vector<Elt> Lb(p.nreq * p.block);
+    std::vector<Elt> Ld(p.nreq * p.dblock);
+    req_weights(&Lb[0], p, p.block, &idx[0], interpolator);
+    req_weights(&Ld[0], p, p.dblock, &idx[0], interpolator);
+
+    if (!low_degree_check(p, proof, &u_ldt[0], &Lb[0], F)) {
       *why = "low_degree_check failed";
       return false;
     }
@@ -100,7 +108,8 @@ class LigeroVerifier {
       LigeroCommon<Field>::inner_product_vector(&A[0], p, nl, nllterm, llterm,
                                                 &alphal[0], lqc, &alphaq[0], F);
 
-      if (!dot_check(p, proof, &idx[0], &A[0], interpolator, F)) {
+      if (!dot_check(p, proof, &A[0], &idx[0], &Lb[0], &Ld[0], interpolator,
+                     F)) {
         *why = "dot_check failed";
         return false;
       }
@@ -114,7 +123,7 @@ class LigeroVerifier {
       }
     }
 
-    if (!quadratic_check(p, proof, &idx[0], &u_quad[0], interpolator, F)) {
+    if (!quadratic_check(p, proof, &u_quad[0], &Ld[0], F)) {
       *why = "quadratic_check failed";
       return false;
     }
@@ -124,17 +133,27 @@ class LigeroVerifier {
   }
 
  private:
+  // L[k * ylen + j] = coefficient of y[j] in the interpolation of
+  // y[0, ylen) at column p.dblock + idx[k]
+  static void req_weights(Elt L[/*nreq, ylen*/], const LigeroParam<Field>& p,
+                          size_t ylen, const size_t idx[/*nreq*/],
+                          const InterpolatorFactory& interpolator) {
+    std::vector<size_t> col(p.nreq);
+    for (size_t k = 0; k < p.nreq; ++k) {
+      col[k] = p.dblock + idx[k];
+    }
+    const auto interpy = interpolator.make(ylen, p.block_enc);
+    interpy->lagrange_weights(p.nreq, L, &col[0]);
+  }
+
   static void interpolate_req_columns(Elt yp[/*nreq*/],
                                       const LigeroParam<Field>& p, size_t ylen,
                                       const Elt y[/*ylen*/],
-                                      const size_t idx[/*nreq*/],
-                                      const InterpolatorFactory& interpolator,
+                                      const Elt L[/*nreq, ylen*/],
                                       const Field& F) {
-    const auto interpy = interpolator.make(ylen, p.block_enc);
-    std::vector<Elt> yext(p.block_enc);
-    Blas<Field>::copy(ylen, &yext[0], 1, y, 1);
-    interpy->interpolate(&yext[0]);
-    Blas<Field>::gather(p.nreq, &yp[0], &yext[p.dblock], idx);
+    for (size_t k = 0; k < p.nreq; ++k) {
+      yp[k] = Blas<Field>::dot(ylen, &L[k * ylen], 1, y, 1, F);
+    }
   }
 
   static bool merkle_check(const LigeroParam<Field>& p,
@@ -153,24 +172,22 @@ class LigeroVerifier {
 
   static bool low_degree_check(const LigeroParam<Field>& p,
                                const LigeroProof<Field>& proof,
-                               const size_t idx[/*nreq*/],
                                const Elt u_ldt[/*nrow*/],
-                               const InterpolatorFactory& interpolator,
-                               const Field& F) {
+                               const Elt Lb[/*nreq, block*/], const Field& F) {
     std::vector<Elt> yc(p.nreq);
 
     // the ILDT blinding row with coefficient 1
     Blas<Field>::copy(p.nreq, &yc[0], 1, &proof.req_at(p.ildt, 0), 1);
 
     // all remaining rows with coefficient u_ldt[]
+    BlasAccumulator<Field> sum(p.nreq, F);
     for (size_t i = 0; i < p.nwqrow; ++i) {
-      Blas<Field>::axpy(p.nreq, &yc[0], 1, u_ldt[i], &proof.req_at(i + p.iw, 0),
-                        1, F);
+      sum.axpy(u_ldt[i], &proof.req_at(i + p.iw, 0));
     }
+    sum.add_to(&yc[0]);
 
     std::vector<Elt> yp(p.nreq);
-    interpolate_req_columns(&yp[0], p, p.block, &proof.y_ldt[0], idx,
-                            interpolator, F);
+    interpolate_req_columns(&yp[0], p, p.block, &proof.y_ldt[0], Lb, F);
 
     if (!Blas<Field>::equal(p.nreq, &yp[0], 1, &yc[0], 1, F)) {
       return false;
@@ -181,7 +198,10 @@ class LigeroVerifier {
 
   static bool dot_check(const LigeroParam<Field>& p,
                         const LigeroProof<Field>& proof,
-                        const size_t idx[/*nreq*/], const Elt A[/*nwqrow, w*/],
+                        const Elt A[/*nwqrow, w*/],
+                        const size_t idx[/*nreq*/],
+                        const Elt Lb[/*nreq, block*/],
+                        const Elt Ld[/*nreq, dblock*/],
                         const InterpolatorFactory& interpolator,
                         const Field& F) {
     std::vector<Elt> yc(p.nreq);
@@ -190,25 +210,39 @@ class LigeroVerifier {
     Blas<Field>::copy(p.nreq, &yc[0], 1, &proof.req_at(p.idot, 0), 1);
 
     {
-      const auto interpA = interpolator.make(p.block, p.block_enc);
-
-      std::vector<Elt> Aext(p.block_enc);
       std::vector<Elt> Areq(p.nreq);
 
+      // Areq = interpolation of layout_Aext() at the opened columns,
+      // either as NREQ dot products of length W with the Lagrange
+      // coefficients, or as a full interpolation of the row followed
+      // by a gather, whichever the interpolator estimates to be cheaper
+      // for this field and shape.
+      const auto interpA = interpolator.make(p.block, p.block_enc);
+      const bool use_weights = p.nreq * p.w <= interpA->interpolate_cost();
+      std::vector<Elt> Aext(use_weights ? 0 : p.block_enc);
+
+      BlasAccumulator<Field> sum(p.nreq, F);
       for (size_t i = 0; i < p.nwqrow; ++i) {
-        LigeroCommon<Field>::layout_Aext(&Aext[0], p, i, &A[0], F);
-        interpA->interpolate(&Aext[0]);
-        Blas<Field>::gather(p.nreq, &Areq[0], &Aext[p.dblock], idx);
+        if (use_weights) {
+          // The first R columns of Aext are zero and do not contribute.
+          for (size_t k = 0; k < p.nreq; ++k) {
+            Areq[k] = Blas<Field>::dot(p.w, &Lb[k * p.block + p.r], 1,
+                                       &A[i * p.w], 1, F);
+          }
+        } else {
+          LigeroCommon<Field>::layout_Aext(&Aext[0], p, i, &A[0], F);
+          interpA->interpolate(&Aext[0]);
+          Blas<Field>::gather(p.nreq, &Areq[0], &Aext[p.dblock], idx);
+        }
 
         // Accumulate z += A[j] \otimes W[j].
-        Blas<Field>::vaxpy(p.nreq, &yc[0], 1, &Areq[0], 1,
-                           &proof.req_at(i + p.iw, 0), 1, F);
+        sum.vaxpy(&Areq[0], &proof.req_at(i + p.iw, 0));
       }
+      sum.add_to(&yc[0]);
     }
 
     std::vector<Elt> yp(p.nreq);
-    interpolate_req_columns(&yp[0], p, p.dblock, &proof.y_dot[0], idx,
-                            interpolator, F);
+    interpolate_req_columns(&yp[0], p, p.dblock, &proof.y_dot[0], Ld, F);
 
     if (!Blas<Field>::equal(p.nreq, &yp[0], 1, &yc[0], 1, F)) {
       return false;
@@ -218,9 +252,8 @@ class LigeroVerifier {
 
   static bool quadratic_check(const LigeroParam<Field>& p,
                               const LigeroProof<Field>& proof,
-                              const size_t idx[/*nreq*/],
                               const Elt u_quad[/*nqtriples*/],
-                              const InterpolatorFactory& interpolator,
+                              const Elt Ld[/*nreq, dblock*/],
                               const Field& F) {
     std::vector<Elt> yc(p.nreq);
 
@@ -234,6 +267,7 @@ class LigeroVerifier {
       size_t iqz = iqy + p.nqtriples;
 
       // all quadratic triples with coefficient u_ldt[]
+      BlasAccumulator<Field> sum(p.nreq, F);
       for (size_t i = 0; i < p.nqtriples; ++i) {
         // yc += u_quad[i] * (z[i] - x[i] * y[i])
 
@@ -245,8 +279,9 @@ class LigeroVerifier {
                            &proof.req_at(iqy + i, 0), 1, F);
 
         // yc += u_quad[i] * tmp
-        Blas<Field>::axpy(p.nreq, &yc[0], 1, u_quad[i], &tmp[0], 1, F);
+        sum.axpy(u_quad[i], &tmp[0]);
       }
+      sum.add_to(&yc[0]);
     }
 
     // reconstruct y_quad from the two parts in the proof
@@ -258,8 +293,7 @@ class LigeroVerifier {
 
     // interpolate y_quad at the opened columns
     std::vector<Elt> yp(p.nreq);
-    interpolate_req_columns(&yp[0], p, p.dblock, &yquad[0], idx, interpolator,
-                            F);
+    interpolate_req_columns(&yp[0], p, p.dblock, &yquad[0], Ld, F);
 
     if (!Blas<Field>::equal(p.nreq, &yp[0], 1, &yc[0], 1, F)) {
       return false;
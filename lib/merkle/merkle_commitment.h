@@ -25,6 +25,7 @@
 #include "merkle/merkle_tree.h"
 #include "random/random.h"
 #include "util/crypto.h"
+#include "util/executor.h"
 
 namespace proofs {
 
@@ -47,20 +48,86 @@ class MerkleCommitment {
  public:
   explicit MerkleCommitment(size_t n) : n_(n), mt_(n), nonce_(n) {}
 
+  // UPDHASH(i, sha) appends the contents of leaf I to SHA.
   Digest commit(const std::function<void(size_t, SHA256 &)> &updhash,
                 RandomEngine &rng) {
+    SerialExecutor serial;
+    return commit_many(
+        [&](size_t b, size_t e, SHA256 sha[]) {
+          for (size_t i = b; i < e; ++i) {
+            updhash(i, sha[i - b]);
+          }
+        },
+        rng, serial);
+  }
+
+  // Batched version of commit().  UPDHASH_MANY(b, e, sha) appends the
+  // contents of leaves [B, E) to SHA[0, E - B), which allows the
+  // caller to produce many leaves in one pass over its data.
+  // Batches of leaves, and the inner nodes of the tree, are computed
+  // in parallel via EX.  The result does not depend on EX.
+  Digest commit_many(
+      const std::function<void(size_t, size_t, SHA256[])> &updhash_many,
+      RandomEngine &rng, Executor &ex) {
+    sample_nonces(rng);
+    return commit_sampled(updhash_many, ex);
+  }
+
+  // The two halves of commit_many().  SAMPLE_NONCES() consumes all
+  // the randomness of the commitment, in leaf order, and
+  // COMMIT_SAMPLED() does all the hashing without consuming any.
+  // Callers may thus sample several commitments in a fixed order and
+  // then hash them concurrently.
+  void sample_nonces(RandomEngine &rng) {
     for (size_t i = 0; i < n_; ++i) {
-      SHA256 sha;
       rng.bytes(nonce_[i].bytes, MerkleNonce::kLength);
-      sha.Update(nonce_[i].bytes, MerkleNonce::kLength);
-      updhash(i, sha);
+    }
+  }
 
-      Digest dig;
-      sha.DigestData(dig.data);
-      mt_.set_leaf(i, dig);
+  Digest commit_sampled(
+      const std::function<void(size_t, size_t, SHA256[])> &updhash_many,
+      Executor &ex) {
+    ex.parallel_for(n_, kLeavesPerTask, [&](size_t b, size_t e) {
+      std::vector<SHA256> sha(e - b);
+      for (size_t i = b; i < e; ++i) {
+        sha[i - b].Update(nonce_[i].bytes, MerkleNonce::kLength);
+      }
+
+      updhash_many(b, e, &sha[0]);
+
+      for (size_t i = b; i < e; ++i) {
+        Digest dig;
+        sha[i - b].DigestData(dig.data);
+        mt_.set_leaf(i, dig);
+      }
+    });
+
+    return mt_.build_tree(ex);
+  }
+
+  // Streaming version of commit_sampled(), for callers that cannot
+  // produce a leaf in one go.  BEGIN_LEAVES() returns one hash per
+  // leaf, already holding the nonce, to which the caller appends the
+  // contents of the leaves in as many passes as it wants.
+  // COMMIT_LEAVES() finishes the leaves and builds the tree.
+  std::vector<SHA256> begin_leaves() const {
+    std::vector<SHA256> sha(n_);
+    for (size_t i = 0; i < n_; ++i) {
+      sha[i].Update(nonce_[i].bytes, MerkleNonce::kLength);
     }
+    return sha;
+  }
+
+  Digest commit_leaves(std::vector<SHA256> &sha, Executor &ex) {
+    ex.parallel_for(n_, kLeavesPerTask, [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; ++i) {
+        Digest dig;
+        sha[i].DigestData(dig.data);
+        mt_.set_leaf(i, dig);
+      }
+    });
 
-    return mt_.build_tree();
+    return mt_.build_tree(ex);
   }
 
   void open(MerkleProof &proof, const size_t pos[/*np*/], size_t np) {
@@ -73,6 +140,9 @@ class MerkleCommitment {
   }
 
  private:
+  // Minimum number of leaves hashed by one task of commit_many().
+  static constexpr size_t kLeavesPerTask = 16;
+
   size_t n_;
   MerkleTree mt_;
   std::vector<MerkleNonce> nonce_;
@@ -18,10 +18,13 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <cstring>
+#include <utility>
 #include <vector>
 
 #include "util/crypto.h"
+#include "util/executor.h"
 #include "util/panic.h"
 
 namespace proofs {
@@ -97,6 +100,75 @@ inline std::vector<bool> compressed_merkle_proof_tree(size_t n,
   return tree;
 }
 
+// Walk the nodes on the paths from the leaves in POS to the root in
+// decreasing index order, which is the order in which the compressed
+// proof lists the missing siblings.  This visits the same nodes as
+// compressed_merkle_proof_tree(), but keeps only the frontier of
+// pending nodes, as two lists sorted by decreasing index: the leaves,
+// and the parents produced so far, which are produced in decreasing
+// order.  Time and memory are thus O(NP log N) instead of O(N).
+//
+// LEAF(ip) returns the value of the leaf at POS[ip].  For each inner
+// node I on the paths, JOIN(I, L, R) returns the value of I given the
+// values L and R of its children, where the child not on the paths,
+// if any, is passed as nullptr.  Return the value of the root.
+template <class T, class Leaf, class Join>
+T merkle_walk_compressed(size_t n, const size_t pos[/*np*/], size_t np,
+                         const Leaf& leaf, const Join& join) {
+  check(np > 0, "A Merkle proof with 0 leaves is not defined.");
+
+  std::vector<size_t> order(np);
+  for (size_t ip = 0; ip < np; ++ip) {
+    check(pos[ip] < n, "Invalid position for leaf in Merkle tree");
+    order[ip] = ip;
+  }
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return pos[a] > pos[b]; });
+  for (size_t ip = 1; ip < np; ++ip) {
+    check(pos[order[ip - 1]] != pos[order[ip]],
+          "duplicate position in merkle tree requested");
+  }
+
+  size_t il = 0;
+  std::vector<std::pair<size_t, T>> inner;
+  size_t iq = 0;
+
+  // Largest pending node, or 0 if none.
+  auto top = [&]() -> size_t {
+    if (il < np) {
+      return pos[order[il]] + n;  // leaves are larger than inner nodes
+    }
+    return (iq < inner.size()) ? inner[iq].first : 0;
+  };
+  auto pop = [&]() -> T {
+    if (il < np) {
+      return leaf(order[il++]);
+    }
+    return std::move(inner[iq++].second);
+  };
+
+  for (;;) {
+    size_t x = top();
+    T vx = pop();
+    if (x == 1) {
+      return vx;
+    }
+    size_t parent = x / 2;
+    if (x & 1) {
+      // The left sibling, if on the paths, is the next node.  The
+      // right sibling of an even X would have been popped before X.
+      if (top() == x - 1) {
+        T vl = pop();
+        inner.emplace_back(parent, join(parent, &vl, &vx));
+      } else {
+        inner.emplace_back(parent, join(parent, nullptr, &vx));
+      }
+    } else {
+      inner.emplace_back(parent, join(parent, &vx, nullptr));
+    }
+  }
+}
+
 class MerkleTree {
  public:
   explicit MerkleTree(size_t n) : n_(n), layers_(2 * n) {}
@@ -113,35 +185,54 @@ class MerkleTree {
     return layers_[1];
   }
 
+  // Same as build_tree(), but computing independent nodes in parallel.
+  //
+  // If all nodes >= HI are known, then all nodes in [ceil(HI/2), HI)
+  // can be computed, since their children are >= HI.  Thus we
+  // proceed by "levels" from the leaves up, and each level is
+  // split across EX.  For N not a power of two, a level in this sense
+  // may straddle two layers of the tree, which is harmless.
+  Digest build_tree(Executor& ex) {
+    for (size_t hi = n_; hi > 1;) {
+      size_t lo = (hi + 1) / 2;
+      ex.parallel_for(hi - lo, kNodesPerTask, [&](size_t b, size_t e) {
+        for (size_t i = lo + b; i < lo + e; ++i) {
+          layers_[i] = Digest::hash2(layers_[2 * i], layers_[2 * i + 1]);
+        }
+      });
+      hi = lo;
+    }
+    return layers_[1];
+  }
+
   // Compressed Merkle proofs over a set POS[NP] of leaves.
   //
-  // We first compute the set TREE of all nodes that are on the path
-  // from the root to any leaf in POS.  Then, for each inner node in
-  // TREE, we include in the proof the child that is not in TREE, if
-  // any.  Note, this method requires pos to contain no duplicates.
+  // Consider the set TREE of all nodes that are on the path from the
+  // root to any leaf in POS.  For each inner node in TREE, in
+  // decreasing index order, we include in the proof the child that is
+  // not in TREE, if any.  Note, this method requires pos to contain no
+  // duplicates.
   size_t generate_compressed_proof(std::vector<Digest>& proof,
                                    const size_t pos[/*np*/], size_t np) {
-    std::vector<bool> tree = compressed_merkle_proof_tree(n_, pos, np);
-
-    // For each TREE node, include in the proof the
-    // child that is not TREE, if any.
     size_t sz = 0;
-    for (size_t i = n_; i-- > 1;) {
-      if (tree[i]) {
-        size_t child = 2 * i;
-        if (tree[child]) {
-          // try the other child
-          child = 2 * i + 1;
-        }
-        if (!tree[child]) {
-          proof.push_back(layers_[child]);
-          ++sz;
-        }
-      }
-    }
+    merkle_walk_compressed<bool>(
+        n_, pos, np, [](size_t) { return true; },
+        [&](size_t i, const bool* l, const bool* r) {
+          if (l == nullptr) {
+            proof.push_back(layers_[2 * i]);
+            ++sz;
+          } else if (r == nullptr) {
+            proof.push_back(layers_[2 * i + 1]);
+            ++sz;
+          }
+          return true;
+        });
     return sz;
   }
 
+  // Minimum number of inner nodes hashed by one task of build_tree().
+  static constexpr size_t kNodesPerTask = 256;
+
   size_t n_;
   // layers_[n, 2 * n) stores the leaves (nodes at layer 0).
   // layers_[n/2, n) stores nodes at layer 1.
@@ -160,50 +251,27 @@ class MerkleTreeVerifier {
   bool verify_compressed_proof(const Digest* proof, size_t proof_len,
                                const Digest leaves[/*np*/],
                                const size_t pos[/*np*/], size_t np) const {
-    // Reconstructed layers_, where only the DEFINED subset is
-    // defined.
-    std::vector<Digest> layers(2 * n_, Digest{});
-    std::vector<bool> defined(2 * n_, false);
-
-    /*scope for TREE */ {
-      std::vector<bool> tree = compressed_merkle_proof_tree(n_, pos, np);
-
-      // read the proof
-      size_t sz = 0;
-      for (size_t i = n_; i-- > 1;) {
-        if (tree[i]) {
-          size_t child = 2 * i;
-          if (tree[child]) {
-            // try the other child
-            child = 2 * i + 1;
+    // Recompute the nodes on the paths to the root, reading the
+    // missing siblings from the proof in the order in which
+    // generate_compressed_proof() wrote them.
+    size_t sz = 0;
+    bool ok = true;
+    Digest root = merkle_walk_compressed<Digest>(
+        n_, pos, np, [&](size_t ip) { return leaves[ip]; },
+        [&](size_t, const Digest* l, const Digest* r) {
+          if (l != nullptr && r != nullptr) {
+            return Digest::hash2(*l, *r);
           }
-          if (!tree[child]) {
-            if (sz >= proof_len) {
-              return false;
-            }
-            layers[child] = proof[sz++];
-            defined[child] = true;
+          if (sz >= proof_len) {
+            ok = false;
+            return Digest{};
           }
-        }
-      }
-    }
-
-    // set LAYERS at all leaves in POS
-    for (size_t ip = 0; ip < np; ++ip) {
-      size_t l = pos[ip] + n_;
-      layers[l] = leaves[ip];
-      defined[l] = true;
-    }
-
-    // Recompute as many inner nodes as we can
-    for (size_t i = n_; i-- > 1;) {
-      if (defined[2 * i] && defined[2 * i + 1]) {
-        layers[i] = Digest::hash2(layers[2 * i], layers[2 * i + 1]);
-        defined[i] = true;
-      }
-    }
+          const Digest& sibling = proof[sz++];
+          return (l == nullptr) ? Digest::hash2(sibling, *r)
+                                : Digest::hash2(*l, sibling);
+        });
 
-    return (defined[1] && (root_ == layers[1]));
+    return ok && (root_ == root);
   }
 
  private:
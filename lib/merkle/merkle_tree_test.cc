@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <vector>
 
+#include "util/thread_pool.h"
 #include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
@@ -43,6 +44,21 @@ TEST(MerkleTree, BuildTree) {
                                 Digest::hash2(leaves[2], leaves[3])));
 }
 
+TEST(MerkleTree, BuildTreeParallel) {
+  ThreadPool pool(4);
+  for (size_t n = 1; n <= 2000; n = 3 * n / 2 + 1) {
+    MerkleTree mt(n), mtp(n);
+    for (size_t i = 0; i < n; i++) {
+      Digest leaf{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+      mt.set_leaf(i, leaf);
+      mtp.set_leaf(i, leaf);
+    }
+    EXPECT_EQ(mt.build_tree(), mtp.build_tree(pool));
+    for (size_t i = 1; i < 2 * n; i++) {
+      EXPECT_EQ(mt.layers_[i], mtp.layers_[i]);
+    }
+  }
+}
 
 MerkleTree setupBatch(size_t n, size_t batch_size, std::vector<Digest>& leaves,
                       std::vector<size_t>& idx) {
@@ -84,6 +100,36 @@ TEST(MerkleTree, VerifyCompressedProof) {
   }
 }
 
+TEST(MerkleTree, CompressedProofMatchesTreeScan) {
+  // The proof lists the same nodes, in the same order, as a scan of
+  // all inner nodes of the tree.
+  for (size_t n = 1; n <= 70; ++n) {
+    for (size_t np = 1; np <= n; np = 2 * np + 1) {
+      std::vector<size_t> idx;
+      std::vector<Digest> leaves;
+      MerkleTree prover = setupBatch(n, np, leaves, idx);
+      Digest root = prover.build_tree();
+      std::vector<Digest> proof;
+      size_t len = prover.generate_compressed_proof(proof, &idx[0], np);
+
+      std::vector<bool> tree = compressed_merkle_proof_tree(n, &idx[0], np);
+      std::vector<Digest> expected;
+      for (size_t i = n; i-- > 1;) {
+        if (tree[i] && !(tree[2 * i] && tree[2 * i + 1])) {
+          expected.push_back(prover.layers_[tree[2 * i] ? 2 * i + 1 : 2 * i]);
+        }
+      }
+      EXPECT_EQ(len, expected.size());
+      EXPECT_EQ(proof, expected);
+
+      MerkleTreeVerifier verifier(n, root);
+      EXPECT_TRUE(verifier.verify_compressed_proof(proof.data(), len,
+                                                   leaves.data(), idx.data(),
+                                                   np));
+    }
+  }
+}
+
 TEST(MerkleTree, VerifyCompressedProofFailure) {
   const size_t kTestSize = 80;
   for (size_t n = 200; n <= 300; ++n) {
@@ -31,6 +31,7 @@
 #include "sumcheck/circuit_id.h"
 #include "sumcheck/quad.h"
 #include "util/ceildiv.h"
+#include "util/crypto.h"
 #include "util/panic.h"
 #include "util/readbuffer.h"
 
@@ -247,7 +248,234 @@ class CircuitRep {
     return c;
   }
 
+  // ------------------------------------------------------------
+  // Circuit images.
+  //
+  // An image stores a circuit in the same layout as the in-memory
+  // quads, so that a circuit can be loaded, e.g. from a memory-mapped
+  // file, without parsing or copying the quads.  The layout is:
+  //
+  //   ImageHeader
+  //   ImageLayer[nl]
+  //   for each layer, at an offset that is a multiple of kImageAlign:
+  //     Quad<Field>::corner[nq]
+  //
+  // Corners are stored in the native representation of this build
+  // (byte order, Elt representation, struct layout), and the header
+  // records enough of it to reject images from incompatible builds.
+  // The header also records the SIZE of the image, so that images can
+  // be concatenated.  The checksum is SHA-256 of the SIZE bytes of the
+  // image with the checksum field of the header set to zero.
+  static constexpr uint64_t kImageVersion = 2;
+  static constexpr size_t kImageAlign = 64;
+
+  struct ImageHeader {
+    uint8_t magic[8];
+    uint64_t version;
+    uint64_t field_id;
+    uint64_t corner_size;
+    uint64_t byte_order;
+    uint64_t size;
+    uint64_t nv, nc, npub_in, subfield_boundary, ninputs, nl;
+    uint8_t id[32];
+    uint8_t checksum[kSHA256DigestSize];
+  };
+
+  struct ImageLayer {
+    uint64_t nw, logw, nq, offset;
+  };
+
+  void to_image(const Circuit<Field>& sc_c, std::vector<uint8_t>& bytes) {
+    size_t nl = sc_c.l.size();
+    size_t size = sizeof(ImageHeader) + nl * sizeof(ImageLayer);
+    std::vector<ImageLayer> layers(nl);
+    for (size_t ly = 0; ly < nl; ++ly) {
+      size = ceildiv(size, kImageAlign) * kImageAlign;
+      const auto& layer = sc_c.l[ly];
+      layers[ly] = ImageLayer{layer.nw, layer.logw, layer.quad->n_, size};
+      size += layer.quad->n_ * sizeof(QuadCornerT);
+    }
+
+    // Zero-fill, so that padding and the holes in the corners are
+    // deterministic and the checksum is reproducible.
+    bytes.assign(size, 0);
+    ImageHeader h{};
+    memcpy(h.magic, kImageMagic, sizeof(h.magic));
+    h.version = kImageVersion;
+    h.field_id = field_id_;
+    h.corner_size = sizeof(QuadCornerT);
+    h.byte_order = kImageByteOrder;
+    h.size = size;
+    h.nv = sc_c.nv;
+    h.nc = sc_c.nc;
+    h.npub_in = sc_c.npub_in;
+    h.subfield_boundary = sc_c.subfield_boundary;
+    h.ninputs = sc_c.ninputs;
+    h.nl = nl;
+    memcpy(h.id, sc_c.id, sizeof(h.id));
+
+    memcpy(&bytes[sizeof(ImageHeader)], layers.data(),
+           nl * sizeof(ImageLayer));
+    for (size_t ly = 0; ly < nl; ++ly) {
+      const Quad<Field>& q = *sc_c.l[ly].quad;
+      auto dst = reinterpret_cast<QuadCornerT*>(&bytes[layers[ly].offset]);
+      for (size_t i = 0; i < q.n_; ++i) {
+        // Assign member by member, leaving the holes zero.
+        dst[i].g = q.c_[i].g;
+        dst[i].h[0] = q.c_[i].h[0];
+        dst[i].h[1] = q.c_[i].h[1];
+        dst[i].v = q.c_[i].v;
+      }
+    }
+
+    memcpy(bytes.data(), &h, sizeof(h));
+    image_checksum(h.checksum, bytes.data(), size);
+    memcpy(bytes.data(), &h, sizeof(h));
+  }
+
+  // Returns a circuit whose quads point into the image at DATA, or
+  // nullptr if the image is malformed or was written by an incompatible
+  // build.  The image must fit in the SIZE bytes at DATA, which may be
+  // followed by other data, e.g. another image; see image_size().
+  // DATA must be suitably aligned for the corners, which holds for
+  // mmap() and for the heap.  OWNER, if not null, is stored in the
+  // circuit to keep DATA alive.  Otherwise the caller must keep DATA
+  // alive as long as the circuit.
+  //
+  // As in from_bytes(), every corner is checked to index wires within
+  // its layer and to hold a field element in canonical form, and the
+  // circuit id is checked if ENFORCE_CIRCUIT_ID is TRUE.  These checks
+  // do not depend on VERIFY_CHECKSUM, which only detects accidental
+  // corruption of the image, including of the header.  Both the corner
+  // checks and the checksum read the whole image once.
+  std::unique_ptr<Circuit<Field>> from_image(const uint8_t* data, size_t size,
+                                             std::shared_ptr<const void> owner,
+                                             bool enforce_circuit_id,
+                                             bool verify_checksum) {
+    if (data == nullptr || size < sizeof(ImageHeader) ||
+        reinterpret_cast<uintptr_t>(data) % alignof(QuadCornerT) != 0) {
+      return nullptr;
+    }
+
+    ImageHeader h;
+    memcpy(&h, data, sizeof(h));
+    if (memcmp(h.magic, kImageMagic, sizeof(h.magic)) != 0 ||
+        h.version != kImageVersion ||
+        h.field_id != static_cast<uint64_t>(field_id_) ||
+        h.corner_size != sizeof(QuadCornerT) ||
+        h.byte_order != kImageByteOrder || h.size < sizeof(ImageHeader) ||
+        h.size > size || h.npub_in > h.ninputs ||
+        h.subfield_boundary > h.ninputs || h.nl > kMaxLayers ||
+        h.nl * sizeof(ImageLayer) > h.size - sizeof(ImageHeader)) {
+      return nullptr;
+    }
+    size = static_cast<size_t>(h.size);
+
+    if (verify_checksum) {
+      uint8_t checksum[kSHA256DigestSize];
+      image_checksum(checksum, data, size);
+      if (memcmp(checksum, h.checksum, sizeof(checksum)) != 0) {
+        return nullptr;
+      }
+    }
+
+    auto c = std::make_unique<Circuit<Field>>();
+    *c = Circuit<Field>{
+        .nv = static_cast<size_t>(h.nv),
+        .logv = lg(static_cast<size_t>(h.nv)),
+        .nc = static_cast<size_t>(h.nc),
+        .logc = lg(static_cast<size_t>(h.nc)),
+        .nl = static_cast<size_t>(h.nl),
+        .ninputs = static_cast<size_t>(h.ninputs),
+        .npub_in = static_cast<size_t>(h.npub_in),
+        .subfield_boundary = static_cast<size_t>(h.subfield_boundary),
+    };
+    memcpy(c->id, h.id, sizeof(c->id));
+    c->l.reserve(h.nl);
+
+    uint64_t max_g = h.nv;  // a starting bound on quad number
+
+    for (size_t ly = 0; ly < h.nl; ++ly) {
+      ImageLayer il;
+      memcpy(&il, data + sizeof(ImageHeader) + ly * sizeof(ImageLayer),
+             sizeof(il));
+      auto need = checked_mul<uint64_t>(il.nq, sizeof(QuadCornerT));
+      if (il.offset % kImageAlign != 0 || il.offset > size || !need ||
+          need.value() > size - il.offset) {
+        return nullptr;
+      }
+      auto corners = reinterpret_cast<const QuadCornerT*>(data + il.offset);
+      for (uint64_t i = 0; i < il.nq; ++i) {
+        if (size_t(corners[i].g) > max_g || size_t(corners[i].h[0]) > il.nw ||
+            size_t(corners[i].h[1]) > il.nw || !is_canonical(corners[i].v)) {
+          return nullptr;
+        }
+      }
+      c->l.push_back(Layer<Field>{
+          .nw = static_cast<size_t>(il.nw),
+          .logw = static_cast<size_t>(il.logw),
+          .quad = Quad<Field>::view(static_cast<size_t>(il.nq), corners)});
+      max_g = il.nw;
+    }
+
+    if (enforce_circuit_id) {
+      uint8_t idtmp[32];
+      circuit_id(idtmp, *c, f_);
+      if (memcmp(idtmp, c->id, 32) != 0) {
+        return nullptr;
+      }
+    }
+
+    c->image = std::move(owner);
+    return c;
+  }
+
+  // Returns the size of the image at DATA as recorded in its header, or
+  // 0 if the SIZE bytes at DATA do not start with an image header.  The
+  // next image in a concatenation starts at the following multiple of
+  // kImageAlign.
+  static size_t image_size(const uint8_t* data, size_t size) {
+    if (data == nullptr || size < sizeof(ImageHeader)) {
+      return 0;
+    }
+    ImageHeader h;
+    memcpy(&h, data, sizeof(h));
+    if (memcmp(h.magic, kImageMagic, sizeof(h.magic)) != 0 ||
+        h.size < sizeof(ImageHeader) || h.size > size) {
+      return 0;
+    }
+    return static_cast<size_t>(h.size);
+  }
+
  private:
+  using QuadCornerT = typename Quad<Field>::corner;
+
+  static constexpr uint8_t kImageMagic[8] = {'Z', 'K', 'C', 'I',
+                                             'R', 'C', 'U', 'I'};
+  // Written in native byte order, and thus reads back differently on a
+  // host of the other endianness.
+  static constexpr uint64_t kImageByteOrder = 0x0102030405060708ull;
+
+  // True if V is the representation of its field element that
+  // of_bytes_field() produces, as for the constants in from_bytes().
+  bool is_canonical(const Elt& v) const {
+    uint8_t buf[Field::kBytes];
+    f_.to_bytes_field(buf, v);
+    auto vv = f_.of_bytes_field(buf);
+    return vv.has_value() && vv.value() == v;
+  }
+
+  static void image_checksum(uint8_t checksum[/*kSHA256DigestSize*/],
+                             const uint8_t* data, size_t size) {
+    ImageHeader h;
+    memcpy(&h, data, sizeof(h));
+    memset(h.checksum, 0, sizeof(h.checksum));
+    SHA256 sha;
+    sha.Update(reinterpret_cast<const uint8_t*>(&h), sizeof(h));
+    sha.Update(data + sizeof(ImageHeader), size - sizeof(ImageHeader));
+    sha.DigestData(checksum);
+  }
+
   static constexpr uint64_t kMaxValue = (1ULL << (kBytesWritten * 8)) - 1;
 
   // Multiplies arguments and checks for overflow.
@@ -14,9 +14,14 @@
 
 #include "proto/circuit.h"
 
+#include <stdlib.h>
+#include <unistd.h>
+
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "algebra/fp_p128.h"
@@ -29,7 +34,10 @@
 #include "circuits/sha/flatsha256_circuit.h"
 #include "ec/p256.h"
 #include "sumcheck/circuit.h"
+#include "sumcheck/quad.h"
+#include "util/ceildiv.h"
 #include "util/log.h"
+#include "util/mapped_file.h"
 #include "util/readbuffer.h"
 #include "gtest/gtest.h"
 
@@ -87,6 +95,114 @@ void serialize_test2(const Circuit<FF>& circuit, const FF& F,
   }
 }
 
+template <class FF>
+void image_test(const Circuit<FF>& circuit, const FF& F, FieldID field_id) {
+  CircuitRep<FF> cr(F, field_id);
+  std::vector<uint8_t> image;
+  cr.to_image(circuit, image);
+  log(INFO, "image size: %zu", image.size());
+
+  // The image is deterministic.
+  std::vector<uint8_t> image2;
+  cr.to_image(circuit, image2);
+  EXPECT_EQ(image, image2);
+
+  // Load the image from a file, as a user would.
+  char path[] = "/tmp/circuit_image_XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(write(fd, image.data(), image.size()),
+            static_cast<ssize_t>(image.size()));
+  close(fd);
+
+  std::shared_ptr<MappedFile> mf = MappedFile::open(path);
+  unlink(path);
+  ASSERT_TRUE(mf != nullptr);
+  const uint8_t* base = mf->data();
+  size_t size = mf->size();
+  auto c2 = cr.from_image(base, size, std::move(mf),
+                          /*enforce_circuit_id=*/true,
+                          /*verify_checksum=*/true);
+  ASSERT_TRUE(c2 != nullptr);
+
+  // The circuit keeps the mapping alive, and its quads point into it.
+  EXPECT_TRUE(*c2 == circuit);
+  EXPECT_EQ(memcmp(c2->id, circuit.id, 32), 0);
+  EXPECT_EQ(c2->ninputs, circuit.ninputs);
+  EXPECT_EQ(c2->npub_in, circuit.npub_in);
+  EXPECT_EQ(c2->subfield_boundary, circuit.subfield_boundary);
+  for (const auto& layer : c2->l) {
+    auto p = reinterpret_cast<const uint8_t*>(layer.quad->c_);
+    EXPECT_TRUE(p >= base && p < base + size);
+  }
+
+  // Truncated, corrupted and foreign images fail.
+  EXPECT_TRUE(cr.from_image(image.data(), image.size() - 1, nullptr,
+                            /*enforce_circuit_id=*/false,
+                            /*verify_checksum=*/true) == nullptr);
+  image[image.size() - 1] ^= 1;
+  EXPECT_TRUE(cr.from_image(image.data(), image.size(), nullptr,
+                            /*enforce_circuit_id=*/false,
+                            /*verify_checksum=*/true) == nullptr);
+  image[image.size() - 1] ^= 1;
+  CircuitRep<FF> other(F, NONE);
+  EXPECT_TRUE(other.from_image(image.data(), image.size(), nullptr,
+                               /*enforce_circuit_id=*/false,
+                               /*verify_checksum=*/true) == nullptr);
+
+  // The checksum covers the header.
+  using Header = typename CircuitRep<FF>::ImageHeader;
+  using ImageLayer = typename CircuitRep<FF>::ImageLayer;
+  std::vector<uint8_t> bad = image;
+  bad[offsetof(Header, ninputs)] ^= 1;
+  EXPECT_TRUE(cr.from_image(bad.data(), bad.size(), nullptr,
+                            /*enforce_circuit_id=*/false,
+                            /*verify_checksum=*/true) == nullptr);
+
+  // A corner out of bounds fails even without the checksum.
+  bad = image;
+  ImageLayer il;
+  memcpy(&il, &bad[sizeof(Header)], sizeof(il));
+  ASSERT_GT(il.nq, 0u);
+  auto corner = reinterpret_cast<typename Quad<FF>::corner*>(&bad[il.offset]);
+  corner->h[0] = typename Quad<FF>::quad_corner_t(il.nw + 1);
+  EXPECT_TRUE(cr.from_image(bad.data(), bad.size(), nullptr,
+                            /*enforce_circuit_id=*/false,
+                            /*verify_checksum=*/false) == nullptr);
+
+  // So does a constant that is not in canonical form.
+  bad = image;
+  corner = reinterpret_cast<typename Quad<FF>::corner*>(&bad[il.offset]);
+  memset(&corner->v, 0xff, sizeof(corner->v));
+  EXPECT_TRUE(cr.from_image(bad.data(), bad.size(), nullptr,
+                            /*enforce_circuit_id=*/false,
+                            /*verify_checksum=*/false) == nullptr);
+
+  // A wrong circuit id fails if the id is enforced.
+  bad = image;
+  bad[offsetof(Header, id)] ^= 1;
+  EXPECT_TRUE(cr.from_image(bad.data(), bad.size(), nullptr,
+                            /*enforce_circuit_id=*/false,
+                            /*verify_checksum=*/false) != nullptr);
+  EXPECT_TRUE(cr.from_image(bad.data(), bad.size(), nullptr,
+                            /*enforce_circuit_id=*/true,
+                            /*verify_checksum=*/false) == nullptr);
+
+  // Images can be concatenated.
+  size_t off = ceildiv(image.size(), CircuitRep<FF>::kImageAlign) *
+               CircuitRep<FF>::kImageAlign;
+  std::vector<uint8_t> two(off + image.size());
+  memcpy(&two[0], image.data(), image.size());
+  memcpy(&two[off], image.data(), image.size());
+  EXPECT_EQ(CircuitRep<FF>::image_size(two.data(), two.size()), image.size());
+  EXPECT_TRUE(cr.from_image(&two[0], two.size(), nullptr,
+                            /*enforce_circuit_id=*/true,
+                            /*verify_checksum=*/true) != nullptr);
+  EXPECT_TRUE(cr.from_image(&two[off], two.size() - off, nullptr,
+                            /*enforce_circuit_id=*/true,
+                            /*verify_checksum=*/true) != nullptr);
+}
+
 template <class FF>
 void serialize_test3(Circuit<FF>& circuit, const FF& F, FieldID field_id) {
   // corrupt the circuit id
@@ -143,6 +259,7 @@ TEST(circuit_io, ecdsa) {
   }
 
   serialize_test2<Fp256Base>(*circuit, p256_base, P256_ID);
+  image_test<Fp256Base>(*circuit, p256_base, P256_ID);
   serialize_test3<Fp256Base>(*circuit, p256_base, P256_ID);
 }
 
@@ -184,6 +301,7 @@ TEST(circuit_io, SHA) {
   }
 
   serialize_test2<Fp128>(*circuit, Fg, FP128_ID);
+  image_test<Fp128>(*circuit, Fg, FP128_ID);
   serialize_test3<Fp128>(*circuit, Fg, FP128_ID);
 }
 
@@ -15,6 +15,7 @@
 #ifndef PRIVACY_PROOFS_ZK_LIB_RANDOM_RANDOM_H_
 #define PRIVACY_PROOFS_ZK_LIB_RANDOM_RANDOM_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <optional>
@@ -62,10 +63,20 @@ class RandomEngine {
     }
   }
 
-  // Convenience method to sample an array of random field elements.
+  // Sample an array of random field elements.  The bytes for many
+  // elements are requested from bytes() at once, but the elements are
+  // the same as those of N calls to elt(F).
   template <class Field>
   void elt(typename Field::Elt e[/*n*/], size_t n, const Field& F) {
-    for (size_t i = 0; i < n; ++i) e[i] = elt(F);
+    fill(e, n, Field::kBytes,
+         [&](const uint8_t buf[]) { return F.of_bytes_field(buf); });
+  }
+
+  // Array version of subfield_elt(F), in the same way.
+  template <class Field>
+  void subfield_elt(typename Field::Elt e[/*n*/], size_t n, const Field& F) {
+    fill(e, n, Field::kSubFieldBytes,
+         [&](const uint8_t buf[]) { return F.of_bytes_subfield(buf); });
   }
 
   // the minimal bitmask such that (n & mask) == n
@@ -128,6 +139,30 @@ class RandomEngine {
       res[i] = A[i];
     }
   }
+
+ private:
+  // Bytes requested at once by fill()
+  static constexpr size_t kFillBytes = 1024;
+
+  // Set E[0, N) to the successive non-empty results of PARSE(BUF)
+  // over consecutive chunks BUF of L random bytes.  This consumes the
+  // random stream exactly as rejection sampling one element at a time
+  // does, but with one call to bytes() for many chunks.
+  template <class Elt, class Parse>
+  void fill(Elt e[/*n*/], size_t n, size_t l, const Parse& parse) {
+    check(l <= kFillBytes, "l <= kFillBytes");
+    uint8_t buf[kFillBytes];
+    size_t i = 0;
+    while (i < n) {
+      size_t m = std::min(kFillBytes / l, n - i);
+      bytes(buf, m * l);
+      for (size_t j = 0; j < m; ++j) {
+        if (auto maybe = parse(&buf[j * l])) {
+          e[i++] = maybe.value();
+        }
+      }
+    }
+  }
 };
 }  // namespace proofs
 
@@ -127,5 +127,33 @@ TEST(Random, SecureRandomEngine) {
   test_all(&e);
 }
 
+TEST(Random, BufferedSecureRandomEngine) {
+  BufferedSecureRandomEngine e;
+  test_all(&e);
+}
+
+TEST(Random, BulkEltMatchesSingleElt) {
+  // A prime close to 2^63, so that about half of the 8-byte
+  // candidates are rejected.
+  static const Field F63("9223372036854775783");
+  constexpr size_t N = 1000;
+  Transcript t0((uint8_t *)"test", 4);
+  Transcript t1((uint8_t *)"test", 4);
+
+  std::vector<Elt> x(N);
+  t0.elt(x.data(), N, F63);
+  for (size_t i = 0; i < N; ++i) {
+    EXPECT_EQ(x[i], t1.elt(F63));
+  }
+
+  t0.subfield_elt(x.data(), N, F63);
+  for (size_t i = 0; i < N; ++i) {
+    EXPECT_EQ(x[i], t1.subfield_elt(F63));
+  }
+
+  // the two streams are still in sync
+  EXPECT_EQ(t0.elt(F63), t1.elt(F63));
+}
+
 }  // namespace
 }  // namespace proofs
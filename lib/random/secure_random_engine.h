@@ -17,8 +17,11 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 
 #include "random/random.h"
 #include "util/crypto.h"
@@ -32,6 +35,79 @@ class SecureRandomEngine : public RandomEngine {
   void bytes(uint8_t* buf, size_t n) override { rand_bytes(buf, n); }
 };
 
+// BufferedSecureRandomEngine is a RandomEngine that expands a key from
+// openssl's RNG with the PRF in counter mode, that is, AES-256-CTR,
+// kBufferSize bytes at a time, and draws a fresh key every
+// kReseedBytes.  A proof consumes megabytes of blinding randomness in
+// small requests, for which SecureRandomEngine pays one openssl call
+// each.
+class BufferedSecureRandomEngine : public RandomEngine {
+ public:
+  BufferedSecureRandomEngine() { reseed(); }
+
+  ~BufferedSecureRandomEngine() override { secure_zero(buf_, sizeof(buf_)); }
+
+  BufferedSecureRandomEngine(const BufferedSecureRandomEngine&) = delete;
+  BufferedSecureRandomEngine& operator=(const BufferedSecureRandomEngine&) =
+      delete;
+
+  void bytes(uint8_t* buf, size_t n) override {
+    while (n > 0) {
+      if (rdptr_ == kBufferSize) {
+        refill();
+      }
+      size_t m = std::min(n, kBufferSize - rdptr_);
+      memcpy(buf, &buf_[rdptr_], m);
+      // do not keep bytes that have been handed out
+      secure_zero(&buf_[rdptr_], m);
+      rdptr_ += m;
+      buf += m;
+      n -= m;
+    }
+  }
+
+ private:
+  static constexpr size_t kBufferSize = 4096;
+  static constexpr size_t kBlocks = kBufferSize / kPRFOutputSize;
+  static constexpr uint64_t kReseedBytes = uint64_t(1) << 30;
+
+  void reseed() {
+    uint8_t key[kPRFKeySize];
+    rand_bytes(key, sizeof(key));
+    prf_ = std::make_unique<PRF>(key);
+    secure_zero(key, sizeof(key));
+    rand_bytes(ctr_, sizeof(ctr_));
+    nbytes_ = 0;
+    rdptr_ = kBufferSize;
+  }
+
+  // The keystream is the PRF of consecutive values of the big-endian
+  // counter CTR_, all evaluated with one call.
+  void refill() {
+    if (nbytes_ >= kReseedBytes) {
+      reseed();
+    }
+    uint8_t in[kBufferSize];
+    for (size_t b = 0; b < kBlocks; ++b) {
+      memcpy(&in[b * kPRFInputSize], ctr_, kPRFInputSize);
+      for (size_t i = kPRFInputSize; i-- > 0;) {
+        if (++ctr_[i] != 0) {
+          break;
+        }
+      }
+    }
+    prf_->Eval(buf_, in, kBlocks);
+    nbytes_ += kBufferSize;
+    rdptr_ = 0;
+  }
+
+  std::unique_ptr<PRF> prf_;
+  uint8_t ctr_[kPRFInputSize];
+  uint64_t nbytes_;  // bytes generated since the last reseed
+  size_t rdptr_;     // read pointer into buf_[]
+  uint8_t buf_[kBufferSize];
+};
+
 }  // namespace proofs
 
 #endif  // PRIVACY_PROOFS_ZK_LIB_RANDOM_SECURE_RANDOM_ENGINE_H_
@@ -15,6 +15,7 @@
 #ifndef PRIVACY_PROOFS_ZK_LIB_RANDOM_TRANSCRIPT_H_
 #define PRIVACY_PROOFS_ZK_LIB_RANDOM_TRANSCRIPT_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -33,7 +34,7 @@ FSPRF and Transcript together used implement the Fiat-Shamir transform.
 class FSPRF  {
  public:
   explicit FSPRF(const uint8_t key[kPRFKeySize])
-      : prf_(key), nblock_(0), rdptr_(kPRFOutputSize) {}
+      : prf_(key), nblock_(0), nsaved_(0), rdptr_(0) {}
 
   // Disable copy for good measure.
   explicit FSPRF(const FSPRF&) = delete;
@@ -44,27 +45,44 @@ class FSPRF  {
   constexpr static uint64_t kMaxBlocks = 0x10000000000;
 
   void bytes(uint8_t buf[/*n*/], size_t n) {
-    while (n-- > 0) {
-      if (rdptr_ == kPRFOutputSize) {
-        refill();
+    while (n > 0) {
+      if (rdptr_ == nsaved_) {
+        refill(n);
       }
-      *buf++ = saved_[rdptr_++];
+      size_t m = std::min(n, nsaved_ - rdptr_);
+      memcpy(buf, &saved_[rdptr_], m);
+      rdptr_ += m;
+      buf += m;
+      n -= m;
     }
   }
 
  private:
-  void refill() {
-    check(nblock_ < kMaxBlocks, "too many blocks");
-    uint8_t in[kPRFInputSize] = {};
-    u64_to_le(in, nblock_++);
-    prf_.Eval(saved_, in);
+  // Blocks generated at once when a large request is pending.
+  static constexpr size_t kBatchBlocks = 64;
+
+  // Generate enough blocks for a request of N bytes, up to
+  // kBatchBlocks.  A short request generates one block, so that
+  // small transcripts do not pay for a whole batch.  The output
+  // does not depend on the batching.
+  void refill(size_t n) {
+    size_t nb = (n + kPRFOutputSize - 1) / kPRFOutputSize;
+    nb = std::min<size_t>(nb, kBatchBlocks);
+    check(nblock_ + nb <= kMaxBlocks, "too many blocks");
+    uint8_t in[kBatchBlocks * kPRFInputSize] = {};
+    for (size_t i = 0; i < nb; ++i) {
+      u64_to_le(&in[i * kPRFInputSize], nblock_++);
+    }
+    prf_.Eval(saved_, in, nb);
+    nsaved_ = nb * kPRFOutputSize;
     rdptr_ = 0;
   }
 
   PRF prf_;
   uint64_t nblock_;
+  size_t nsaved_;      // number of valid bytes in saved_[]
   size_t rdptr_;       // read pointer into saved[]
-  uint8_t saved_[kPRFOutputSize];  // saved pseudo-random bytes
+  uint8_t saved_[kBatchBlocks * kPRFOutputSize];  // saved pseudo-random bytes
 };
 
 class Transcript : public RandomEngine {
@@ -150,12 +168,24 @@ class Transcript : public RandomEngine {
     }
     length(n);
 
-    for (size_t i = 0; i < n; ++i) {
-      write_untyped(e[i * ince], F);
+    // Serialize into a staging buffer and hash many elements per
+    // update.  SHA256 does not care how the input is split.
+    constexpr size_t kPerBatch =
+        std::max<size_t>(1, kStagingBytes / Field::kBytes);
+    uint8_t buf[kPerBatch * Field::kBytes];
+    for (size_t i = 0; i < n; i += kPerBatch) {
+      size_t m = std::min(kPerBatch, n - i);
+      for (size_t j = 0; j < m; ++j) {
+        F.to_bytes_field(&buf[j * Field::kBytes], e[(i + j) * ince]);
+      }
+      write_untyped(buf, m * Field::kBytes);
     }
   }
 
  private:
+  // Size of the buffer used to absorb arrays of field elements.
+  static constexpr size_t kStagingBytes = 1024;
+
   explicit Transcript(const SHA256& sha, size_t version)
       : sha_(), version_(version) {
     sha_.CopyState(sha);
@@ -16,9 +16,11 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <vector>
 
 #include "algebra/fp.h"
 #include "gtest/gtest.h"
@@ -170,6 +172,52 @@ TEST(Transcript, TestWriteFieldElementArray) {
   }
 }
 
+TEST(Transcript, BatchedBytes) {
+  // Requests of any size see the same PRF stream, whether or not
+  // they cross a batch boundary.
+  constexpr size_t n = 5000;
+  std::vector<uint8_t> a(n), b(n);
+  Transcript ts((uint8_t *)"test", 4);
+  ts.write(F.of_scalar(7), F);
+  ts.clone().bytes(a.data(), n);
+  for (size_t i = 0, k = 1; i < n; i += k, k = k % 37 + 1) {
+    ts.bytes(&b[i], std::min(k, n - i));
+  }
+  EXPECT_EQ(a, b);
+}
+
+TEST(Transcript, StagedArrayWrite) {
+  // An array longer than the staging buffer hashes the same bytes as
+  // writing the elements one by one.
+  constexpr size_t n = 100;
+  std::vector<Elt> array(n);
+  for (size_t i = 0; i < n; ++i) {
+    array[i] = F.of_scalar(i * i + 1);
+  }
+
+  uint8_t key[kPRFKeySize], key1[kSHA256DigestSize];
+  Transcript ts((uint8_t *)"test", 4, /*version=*/4);
+  ts.write(array.data(), 1, n, F);
+  ts.get(key);
+
+  SHA256 sha;
+  const uint8_t init[] = {0, 4, 0, 0, 0, 0, 0, 0, 0, 't', 'e', 's', 't'};
+  sha.Update(init, sizeof(init));
+  const uint8_t tag = 2;
+  sha.Update(&tag, 1);
+  sha.Update8(n);
+  for (size_t i = 0; i < n; ++i) {
+    uint8_t buf[Field::kBytes];
+    F.to_bytes_field(buf, array[i]);
+    sha.Update(buf, sizeof(buf));
+  }
+  sha.DigestData(key1);
+
+  for (size_t i = 0; i < kPRFKeySize; ++i) {
+    EXPECT_EQ(key[i], key1[i]);
+  }
+}
+
 TEST(Transcript, TestVec) {
   uint8_t key[32];
 
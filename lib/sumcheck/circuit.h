@@ -58,6 +58,10 @@ struct Circuit {
 
   uint8_t id[32];  // unique id for the circuit, created by the compiler
 
+  // Owner of the corners of the layer quads when these are views into
+  // a circuit image (see CircuitRep::from_image()), null otherwise.
+  std::shared_ptr<const void> image = nullptr;
+
   bool operator==(const Circuit& y) const {
     return nv == y.nv && logv == y.logv && nc == y.nc && logc == y.logc &&
            nl == y.nl && l == y.l;
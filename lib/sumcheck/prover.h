@@ -21,6 +21,7 @@
 #include "sumcheck/circuit.h"
 #include "sumcheck/prover_layers.h"
 #include "sumcheck/transcript_sumcheck.h"
+#include "util/executor.h"
 
 namespace proofs {
 
@@ -35,15 +36,16 @@ class Prover : public ProverLayers<Field> {
  public:
   using typename super::inputs;
 
-  explicit Prover(const Field& f) : ProverLayers<Field>(f) {}
+  explicit Prover(const Field& f, Executor* executor = nullptr)
+      : ProverLayers<Field>(f, executor) {}
 
   // Generate proof for circuit. pad can be nullptr if the caller does not
   // want to add any pad to the proof. Caller must ensure in, t, and F remain
   // valid during call duration.
   // This method always succeeds, but may not produce a verifying proof if
-  // the inputs do not satisfy the circuit.
+  // the inputs do not satisfy the circuit.  IN is consumed by the proof.
   void prove(Proof<Field>* proof, const Proof<Field>* pad,
-             const Circuit<Field>* circ, const inputs& in, Transcript& t) {
+             const Circuit<Field>* circ, inputs& in, Transcript& t) {
     if (proof == nullptr || circ == nullptr) return;
 
     TranscriptSumcheck<Field> ts(t, super::f_);
@@ -17,6 +17,7 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -25,7 +26,10 @@
 #include "arrays/eqs.h"
 #include "sumcheck/circuit.h"
 #include "sumcheck/quad.h"
+#include "sumcheck/quad_soa.h"
 #include "sumcheck/transcript_sumcheck.h"
+#include "util/ceildiv.h"
+#include "util/executor.h"
 #include "util/panic.h"
 
 namespace proofs {
@@ -40,7 +44,32 @@ class ProverLayers {
  public:
   using inputs = std::vector<std::unique_ptr<Dense<Field>>>;
 
-  explicit ProverLayers(const Field& f) : f_(f) {}
+  // EXECUTOR, if not null, runs the sumcheck rounds of each layer in
+  // parallel.  The proof does not depend on the executor.
+  explicit ProverLayers(const Field& f, Executor* executor = nullptr)
+      : f_(f),
+        checkpoint_(0),
+        peak_(0),
+        wclone_(f),
+        qw_(f),
+        quad_(0),
+        ex_(executor != nullptr ? executor : &serial_) {}
+
+  ProverLayers(const ProverLayers&) = delete;
+  ProverLayers& operator=(const ProverLayers&) = delete;
+
+  // Trade CPU for memory.  With K > 1, eval_circuit() keeps only the
+  // input wires of every K-th layer, counting from the circuit input,
+  // and prove() recomputes the other layers from the nearest kept one
+  // when it reaches them, one run of K layers at a time.  The layer
+  // inputs then take about NL/K + K layers worth of memory instead of
+  // NL, and the circuit is evaluated about twice.  K <= 1 keeps all
+  // layers.  The proof does not depend on K.
+  void set_checkpoint_interval(size_t k) { checkpoint_ = k; }
+
+  // Peak number of field elements held in the layer inputs during the
+  // last eval_circuit() and prove().
+  size_t peak_wires() const { return peak_; }
 
   // Evaluate CIRCUIT on input wires W0.  This function stores the
   // input wires of each layer L into IN->at(L), and returns the
@@ -53,46 +82,29 @@ class ProverLayers {
                                              const Field& F) {
     if (in == nullptr || circ == nullptr || W0 == nullptr) return nullptr;
 
-    std::unique_ptr<Dense<Field>> finalV;
-    size_t nl = circ->nl, nc = circ->nc;
+    size_t nl = circ->nl;
     check(nl >= 1, "nl >= 1");
-    check(nc >= 1, "nc >= 1");
-
-    Dense<Field>* W = W0.get();
 
     in->resize(nl);
     in->at(nl - 1).swap(W0);
+    return eval_layers(in, circ, F);
+  }
 
-    // Allocate memory and evaluate layer on input W and output V
-    for (size_t l = nl; l-- > 0;) {
-      Dense<Field>* V;
-      if (l > 0) {
-        // input of layer l-1 = output of layer l
-        in->at(l - 1) = std::make_unique<Dense<Field>>(nc, circ->l[l - 1].nw);
-        V = in->at(l - 1).get();
-      } else {
-        // final output = output of layer 0
-        finalV = std::make_unique<Dense<Field>>(nc, circ->nv);
-        V = finalV.get();
-      }
-
-      bool ok = eval_quad(circ->l[l].quad.get(), V, W, F);
-      if (!ok) {
-        // Early exit in case of assertion failure.
-        // In this case IN is only partially allocated.
-        // To avoid ambiguities, free all memory that we may have allocated.
-        for (size_t i = 0; i < nl; ++i) {
-          in->at(i) = nullptr;
-        }
-        finalV = nullptr;
-
-        return /*finalV=*/nullptr;
-      }
-
-      W = V;
-    }
+  // Same as eval_circuit(IN, CIRC, W0.clone(), F), except that the
+  // arrays already in IN, if any, are reused.  Evaluating the same
+  // circuit again with the same IN thus does not allocate the input
+  // wires of the layers.
+  std::unique_ptr<Dense<Field>> eval_circuit(inputs* in,
+                                             const Circuit<Field>* circ,
+                                             const Dense<Field>& W0,
+                                             const Field& F) {
+    if (in == nullptr || circ == nullptr) return nullptr;
+    check(circ->nl >= 1, "nl >= 1");
 
-    return finalV;
+    in->resize(circ->nl);
+    reuse(in->at(circ->nl - 1), W0.n0_, W0.n1_);
+    in->at(circ->nl - 1)->copy_from(W0);
+    return eval_layers(in, circ, F);
   }
 
  protected:
@@ -109,8 +121,11 @@ class ProverLayers {
 
   // Generate proof for circuit, as a protected member, the caller must
   // ensure that input parameters are valid.
+  // The sumcheck consumes IN, which is left in an unspecified state,
+  // and layers dropped by set_checkpoint_interval() are recomputed
+  // into IN as needed.
   void prove(Proof<Field>* pr, const Proof<Field>* pad,
-             const Circuit<Field>* circ, const inputs& in, ProofAux<Field>* aux,
+             const Circuit<Field>* circ, inputs& in, ProofAux<Field>* aux,
              bindings& bnd, TranscriptSumcheck<Field>& ts, const Field& F) {
     size_t logc = circ->logc;
     corner_t nc = circ->nc;
@@ -137,14 +152,36 @@ class ProverLayers {
       Elt alpha, beta;
       ts.begin_layer(alpha, beta, ly);
       Eqs<Field> EQ(logc, nc, bnd.q, F);
-      auto QUAD = clr->quad->clone();
-      QUAD->bind_g(bnd.logv, bnd.g[0], bnd.g[1], alpha, beta, F);
 
-      layer(pr, pad, ts, bnd, ly, logc, clr->logw, &EQ, QUAD.get(),
-            in.at(ly).get(), F);
+      if (in.at(ly) == nullptr) {
+        recompute(in, circ, ly, F);
+      }
 
-      if (aux != nullptr) {
-        aux->bound_quad[ly] = QUAD->scalar();
+      // Large layers bind G directly into the leaner QuadSoA, which
+      // also avoids copying the circuit's quad.  Both are bound into
+      // storage that is reused across layers and proofs.
+      if (clr->quad->n_ >= kQuadSoAMinTerms) {
+        quad_soa_.bind_g(*clr->quad, bnd.logv, bnd.g[0], bnd.g[1], alpha, beta,
+                         F);
+        layer(pr, pad, ts, bnd, ly, logc, clr->logw, &EQ, &quad_soa_,
+              in.at(ly).get(), F);
+        if (aux != nullptr) {
+          aux->bound_quad[ly] = quad_soa_.scalar();
+        }
+      } else {
+        quad_.copy_from(*clr->quad);
+        quad_.bind_g(bnd.logv, bnd.g[0], bnd.g[1], alpha, beta, F);
+        layer(pr, pad, ts, bnd, ly, logc, clr->logw, &EQ, &quad_,
+              in.at(ly).get(), F);
+        if (aux != nullptr) {
+          aux->bound_quad[ly] = quad_.scalar();
+        }
+      }
+
+      if (checkpoint_ > 1) {
+        // no longer needed
+        in.at(ly) = nullptr;
+        track(in);
       }
     }
   }
@@ -156,6 +193,105 @@ class ProverLayers {
   using FCPoly = typename LayerProof<Field>::FCPoly;
   using FWPoly = typename LayerProof<Field>::FWPoly;
 
+  // Make D an array of N0 x N1, reusing the existing one if any.
+  static void reuse(std::unique_ptr<Dense<Field>>& d, corner_t n0,
+                    corner_t n1) {
+    if (d == nullptr) {
+      d = std::make_unique<Dense<Field>>(n0, n1);
+    } else {
+      d->resize(n0, n1);
+    }
+  }
+
+  // The common part of eval_circuit(), with the input wires of the
+  // last layer already in IN->at(NL - 1).
+  std::unique_ptr<Dense<Field>> eval_layers(inputs* in,
+                                            const Circuit<Field>* circ,
+                                            const Field& F) {
+    std::unique_ptr<Dense<Field>> finalV;
+    size_t nl = circ->nl, nc = circ->nc;
+    check(nc >= 1, "nc >= 1");
+
+    Dense<Field>* W = in->at(nl - 1).get();
+    peak_ = 0;
+    track(*in);
+
+    // Allocate memory and evaluate layer on input W and output V
+    for (size_t l = nl; l-- > 0;) {
+      Dense<Field>* V;
+      if (l > 0) {
+        // input of layer l-1 = output of layer l
+        reuse(in->at(l - 1), nc, circ->l[l - 1].nw);
+        track(*in);
+        V = in->at(l - 1).get();
+      } else {
+        // final output = output of layer 0
+        finalV = std::make_unique<Dense<Field>>(nc, circ->nv);
+        V = finalV.get();
+      }
+
+      bool ok = eval_quad(circ->l[l].quad.get(), V, W, F);
+      if (!ok) {
+        // Early exit in case of assertion failure.
+        // In this case IN is only partially allocated.
+        // To avoid ambiguities, free all memory that we may have allocated.
+        for (size_t i = 0; i < nl; ++i) {
+          in->at(i) = nullptr;
+        }
+        finalV = nullptr;
+
+        return /*finalV=*/nullptr;
+      }
+
+      // Drop the inputs of layer L unless they are a checkpoint.  The
+      // inputs of layer 0 are needed first by prove().
+      if (l > 0 && !kept(l, nl)) {
+        in->at(l) = nullptr;
+        track(*in);
+      }
+
+      W = V;
+    }
+
+    return finalV;
+  }
+
+  // Whether eval_circuit() keeps the inputs of layer L.
+  bool kept(size_t l, size_t nl) const {
+    return checkpoint_ <= 1 || (nl - 1 - l) % checkpoint_ == 0;
+  }
+
+  // Recompute the inputs of layers [LY, C) from the nearest kept layer
+  // C > LY, as in eval_circuit().  All of them are kept until prove()
+  // consumes them, so each layer is recomputed at most once.
+  void recompute(inputs& in, const Circuit<Field>* circ, size_t ly,
+                 const Field& F) {
+    size_t c = ly + 1;
+    while (c < circ->nl && in.at(c) == nullptr) {
+      ++c;
+    }
+    check(c < circ->nl, "no checkpoint above layer");
+
+    for (size_t l = c; l > ly; --l) {
+      reuse(in.at(l - 1), circ->nc, circ->l[l - 1].nw);
+      track(in);
+      bool ok = eval_quad(circ->l[l].quad.get(), in.at(l - 1).get(),
+                          in.at(l).get(), F);
+      check(ok, "eval_quad() failed on recomputation");
+    }
+  }
+
+  // Update the peak memory of the layer inputs.
+  void track(const inputs& in) {
+    size_t live = 0;
+    for (const auto& d : in) {
+      if (d != nullptr) {
+        live += d->v_.size();
+      }
+    }
+    peak_ = std::max(peak_, live);
+  }
+
   /*
   Engage in single-layer sumcheck on
 
@@ -167,10 +303,13 @@ class ProverLayers {
 
   logw: number of sumcheck rounds in r, l
   logc: number of sumcheck rounds in c
+
+  QUADT is either Quad<Field> or QuadSoA<Field>, with G already bound.
   */
+  template <class QuadT>
   void layer(Proof<Field>* pr, const Proof<Field>* pad,
              TranscriptSumcheck<Field>& ts, bindings& bnd, size_t layer,
-             size_t logc, size_t logw, Eqs<Field>* EQ, Quad<Field>* QUAD,
+             size_t logc, size_t logw, Eqs<Field>* EQ, QuadT* QUAD,
              Dense<Field>* W, const Field& F) {
     check(EQ->n() == W->n0_, "EQ->n() == W->n0_");
 
@@ -183,34 +322,45 @@ class ProverLayers {
     // cases number_of_copies > log(circuit_size), so we don't have to
     // optimize binding R, L.
     for (size_t round = 0; round < logc; ++round) {
-      CPoly sum{};
+      // The sum below ranges over pairs of terms and copies.  Split
+      // the copies of each term into NR ranges of NP pairs, so that a
+      // layer with few terms and many copies still yields enough
+      // tasks for the executor.  n0_ is the copy dimension, n1_ is the
+      // wire dimension.
+      size_t ncp = (W->n0_ + 1) / 2;
+      size_t nr = std::min<size_t>(
+          ncp, ceildiv<size_t>(4 * ex_->concurrency(),
+                               std::max<size_t>(QUAD->n_, 1)));
+      size_t np = ceildiv<size_t>(ncp, nr);
+      nr = ceildiv<size_t>(ncp, np);
 
       // sum over r,l: QUAD[|r,l] EQ[|c] W[r,c] W[l,c]
-      for (index_t i = 0; i < QUAD->n_; i++) {
-        corner_t r(QUAD->c_[i].h[0]);
-        corner_t l(QUAD->c_[i].h[1]);
+      CPoly sum = parallel_sum<CPoly>(QUAD->n_ * nr, [&](size_t k) {
+        index_t i = k / nr;
+        corner_t r = QUAD->hand(i, 0);
+        corner_t l = QUAD->hand(i, 1);
 
-        // sum over c: EQ[|c] W[r,c] W[l,c]
+        // sum over c in the range: EQ[|c] W[r,c] W[l,c]
         CPoly sumc{};
-
-        // n0_ is the copy dimension, n1_ is the wire dimension.
-        for (corner_t c = 0; c < W->n0_; c += 2) {
+        corner_t cb = 2 * (k % nr) * np;
+        corner_t ce = std::min<size_t>(cb + 2 * np, W->n0_);
+        for (corner_t c = cb; c < ce; c += 2) {
           CPoly poly = cpoly_at_dense(EQ, c, 0, F)
                            .mul(cpoly_at_dense(W, c, r, F), F)
                            .mul(cpoly_at_dense(W, c, l, F), F);
           sumc.add(poly, F);
         }
 
-        sumc.mul_scalar(QUAD->c_[i].v, F);
-        sum.add(sumc, F);
-      }
+        sumc.mul_scalar(QUAD->val(i), F);
+        return sumc;
+      }, F, ceildiv<size_t>(kTermsPerTask, np));
 
       Elt rnd = round_c(pr, pad, ts, layer, round, sum, F);
       bnd.q[round] = rnd;
 
       // bind the c variable in both EQ and W
       EQ->bind(rnd, F);
-      W->bind(rnd, F);
+      W->bind(rnd, F, *ex_, &bind_scratch_);
     }
 
     Elt eq0 = EQ->scalar();
@@ -218,39 +368,40 @@ class ProverLayers {
     W->reshape(W->n1_);
     check(W->n1_ == 1, "W->n1_ == 1");
 
-    auto Wclone = W->clone();                 // keep alive until function end
-    Dense<Field>* WH[2] = {W, Wclone.get()};  // reuse W
+    // The second hand starts as a copy of W, in storage that is kept
+    // across layers and proofs.
+    wclone_.copy_from(*W);
+    Dense<Field>* WH[2] = {W, &wclone_};  // reuse W
+
+    // QW only shrinks from round to round, and its storage is kept
+    // across layers and proofs.
+    Dense<Field>& QW = qw_;
 
     for (size_t round = 0; round < logw; ++round) {
       for (size_t hand = 0; hand < 2; hand++) {
         // In SUM_{l,r} Q[l,r] W[l] W[r], first precompute QW[l] =
         // SUM_{r} Q[l,r] W[r] as a dense array, and then compute
         // SUM_{l} QW[l] W[l].
-        Dense<Field> QW(WH[hand]->n0_, 1);
+        QW.resize(WH[hand]->n0_, 1);
         QW.clear(F);
         size_t ohand = 1 - hand;
 
         // QW[l] = SUM_{r} Q[l,r] W[r]
-        for (index_t i = 0; i < QUAD->n_; ++i) {
-          corner_t p0(QUAD->c_[i].h[hand]);
-          corner_t p1(QUAD->c_[i].h[ohand]);
-          F.add(QW.v_[p0], F.mulf(QUAD->c_[i].v, WH[ohand]->v_[p1]));
-        }
+        scatter_qw(&QW, QUAD, hand, WH[ohand], F);
 
         // SUM_{l} QW[l] W[l].
-        WPoly sum{};
-        for (corner_t l = 0; l < QW.n0_; l += 2) {
-          WPoly poly = wpoly_at_dense(WH[hand], l, 0, F)
-                           .mul(wpoly_at_dense(&QW, l, 0, F), F);
-          sum.add(poly, F);
-        }
+        WPoly sum = parallel_sum<WPoly>((QW.n0_ + 1) / 2, [&](corner_t j) {
+          corner_t l = 2 * j;
+          return wpoly_at_dense(WH[hand], l, 0, F)
+              .mul(wpoly_at_dense(&QW, l, 0, F), F);
+        }, F);
 
         sum.mul_scalar(eq0, F);
         Elt rnd = round_h(pr, pad, ts, layer, hand, round, sum, F);
         bnd.g[hand][round] = rnd;
 
         // bind the r variable in W[hand] and QUAD
-        WH[hand]->bind(rnd, F);
+        WH[hand]->bind(rnd, F, *ex_, &bind_scratch_);
         QUAD->bind_h(rnd, hand, F);
       }
     }
@@ -260,6 +411,73 @@ class ProverLayers {
     end_layer(pr, pad, ts, layer, WC, F);
   }
 
+  // Return SUM_{i < N} TERM(i).  The range is split into contiguous
+  // chunks of at least GRAIN terms whose partial sums are computed in
+  // parallel, and the partial sums are then added in chunk order on
+  // the calling thread.
+  template <class P, class Term>
+  P parallel_sum(size_t n, const Term& term, const Field& F,
+                 size_t grain = kTermsPerTask) {
+    size_t nchunks = std::min<size_t>(ceildiv<size_t>(n, grain),
+                                      4 * ex_->concurrency());
+    if (nchunks <= 1) {
+      P sum{};
+      for (size_t i = 0; i < n; ++i) {
+        sum.add(term(i), F);
+      }
+      return sum;
+    }
+
+    std::vector<P> partial(nchunks);
+    ex_->run(nchunks, [&](size_t k) {
+      size_t b = n * k / nchunks, e = n * (k + 1) / nchunks;
+      P sum{};
+      for (size_t i = b; i < e; ++i) {
+        sum.add(term(i), F);
+      }
+      partial[k] = sum;
+    });
+
+    P sum{};
+    for (size_t k = 0; k < nchunks; ++k) {
+      sum.add(partial[k], F);
+    }
+    return sum;
+  }
+
+  // QW[p0] += Q[p0,p1] W[p1] for all terms of QUAD, where p0 is the
+  // HAND variable and p1 the other one.  Distinct terms may scatter
+  // into the same p0, so only the products are computed in parallel,
+  // one block of terms at a time, and the additions are serial.
+  template <class QuadT>
+  void scatter_qw(Dense<Field>* QW, const QuadT* QUAD, size_t hand,
+                  const Dense<Field>* W, const Field& F) {
+    size_t ohand = 1 - hand;
+    if (ex_->concurrency() <= 1) {
+      for (index_t i = 0; i < QUAD->n_; ++i) {
+        corner_t p0 = QUAD->hand(i, hand);
+        corner_t p1 = QUAD->hand(i, ohand);
+        F.add(QW->v_[p0], F.mulf(QUAD->val(i), W->v_[p1]));
+      }
+      return;
+    }
+
+    std::vector<Elt> prod(std::min<size_t>(QUAD->n_, kScatterBlock));
+    for (index_t b = 0; b < QUAD->n_; b += kScatterBlock) {
+      index_t e = std::min<index_t>(QUAD->n_, b + kScatterBlock);
+      ex_->parallel_for(e - b, kTermsPerTask, [&](size_t i0, size_t i1) {
+        for (size_t i = i0; i < i1; ++i) {
+          corner_t p1 = QUAD->hand(b + i, ohand);
+          prod[i] = F.mulf(QUAD->val(b + i), W->v_[p1]);
+        }
+      });
+      for (index_t i = b; i < e; ++i) {
+        corner_t p0 = QUAD->hand(i, hand);
+        F.add(QW->v_[p0], prod[i - b]);
+      }
+    }
+  }
+
   // Evaluate the quadratic form
   //
   //         V[g,c] = QUAD[g|r,l] W[r,c] W[l,c]
@@ -344,6 +562,30 @@ class ProverLayers {
     auto tmp = FWPoly::extend(D->t2_at_corners(p0, p1, F), F);
     return WPoly(tmp);
   }
+
+  // Minimum number of terms per task in parallel_sum() and scatter_qw().
+  static constexpr size_t kTermsPerTask = 1024;
+
+  // Number of products buffered by scatter_qw().
+  static constexpr size_t kScatterBlock = 1 << 16;
+
+  // Layers with at least this many terms are proven with QuadSoA.
+  static constexpr size_t kQuadSoAMinTerms = 4096;
+
+  size_t checkpoint_;  // see set_checkpoint_interval()
+  size_t peak_;        // see peak_wires()
+
+  // Scratch storage for layer(), kept across layers and proofs so
+  // that proving does not allocate it again: the copy of the wires for
+  // the second hand, the partial products QW, the bound quads, and the
+  // buffer into which Dense::bind() binds in parallel.
+  Dense<Field> wclone_;
+  Dense<Field> qw_;
+  Quad<Field> quad_;
+  QuadSoA<Field> quad_soa_;
+  std::vector<Elt> bind_scratch_;
+  SerialExecutor serial_;
+  Executor* ex_;
 };
 }  // namespace proofs
 
@@ -87,20 +87,44 @@ class Quad {
 
   using index_t = size_t;
   index_t n_;
-  std::vector<corner> c_;
+
+  // C_ points to the quad's own storage, or, for quads created by
+  // view(), to memory owned by someone else.
+  corner* c_;
 
   bool operator==(const Quad& y) const {
-    return n_ == y.n_ &&
-           std::equal(c_.begin(), c_.end(), y.c_.begin(), y.c_.end());
+    return n_ == y.n_ && std::equal(c_, c_ + n_, y.c_, y.c_ + y.n_);
   }
 
-  explicit Quad(index_t n) : n_(n), c_(n) {}
+  explicit Quad(index_t n) : n_(n), c_(nullptr), storage_(n) {
+    c_ = storage_.data();
+  }
+
+  // Return a read-only quad of the N corners at C, without copying
+  // them.  The caller must keep C alive as long as the quad.  This is
+  // how circuits loaded from a memory-mapped image share the mapping.
+  static std::unique_ptr<const Quad> view(index_t n, const corner c[/*n*/]) {
+    return std::unique_ptr<const Quad>(new Quad(n, c));
+  }
 
   // no copies, but see clone() below
   Quad(const Quad& y) = delete;
   Quad(const Quad&& y) = delete;
   Quad operator=(const Quad& y) = delete;
 
+  // Accessors shared with QuadSoA.
+  corner_t hand(index_t i, size_t k) const { return corner_t(c_[i].h[k]); }
+  const Elt& val(index_t i) const { return c_[i].v; }
+
+  // Same as *this = *Y.clone(), keeping the storage if it is large
+  // enough.
+  void copy_from(const Quad& y) {
+    storage_.resize(y.n_);
+    c_ = storage_.data();
+    n_ = y.n_;
+    std::copy(y.c_, y.c_ + y.n_, c_);
+  }
+
   std::unique_ptr<Quad> clone() const {
     auto s = std::make_unique<Quad>(n_);
     for (index_t i = 0; i < n_; ++i) {
@@ -203,13 +227,17 @@ class Quad {
     for (index_t i = 0; i < n_; ++i) {
       c_[i].canonicalize();
     }
-    std::sort(c_.begin(), c_.end(), [&F](const corner& x, const corner& y) {
+    std::sort(c_, c_ + n_, [&F](const corner& x, const corner& y) {
       return corner::compare(x, y, F);
     });
     coalesce(F);
   }
 
  private:
+  // The const_cast is safe because view() returns a const quad.
+  Quad(index_t n, const corner c[/*n*/])
+      : n_(n), c_(const_cast<corner*>(c)) {}
+
   void coalesce(const Field& F) {
     // Coalesce duplicates.
     // The (rd,wr)=(0,0) iteration executes the else{} branch and
@@ -226,6 +254,8 @@ class Quad {
     }
     n_ = wr;
   }
+
+  std::vector<corner> storage_;  // empty for views
 };
 }  // namespace proofs
 
@@ -0,0 +1,142 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_SUMCHECK_QUAD_SOA_H_
+#define PRIVACY_PROOFS_ZK_LIB_SUMCHECK_QUAD_SOA_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "arrays/affine.h"
+#include "arrays/eqs.h"
+#include "sumcheck/quad.h"
+#include "util/panic.h"
+
+namespace proofs {
+// ------------------------------------------------------------
+// Structure-of-arrays variant of Quad<Field> for use by the prover.
+//
+// Once the prover has bound the G variables of a layer, all corners
+// have g = 0, and the remaining sumcheck rounds only look at the two
+// hand variables and the coefficient.  QuadSoA stores exactly these,
+// in three separate arrays.  Compared to Quad::corner, this drops the
+// g field and the alignment holes, and bind_h() streams over
+// contiguous indices without dragging the coefficients of terms that
+// it does not combine through the cache.
+template <class Field>
+class QuadSoA {
+  using Elt = typename Field::Elt;
+
+ public:
+  using quad_corner_t = typename Quad<Field>::quad_corner_t;
+  using index_t = typename Quad<Field>::index_t;
+
+  index_t n_;
+  std::vector<quad_corner_t> h_[2];  // [n_] each
+  std::vector<Elt> v_;               // [n_]
+
+  QuadSoA() : n_(0) {}
+
+  // Equivalent to Q.clone() followed by bind_g(logv, G0, G1, alpha,
+  // beta, F), but without materializing the copy of Q.
+  QuadSoA(const Quad<Field>& Q, size_t logv, const Elt* G0, const Elt* G1,
+          const Elt& alpha, const Elt& beta, const Field& F)
+      : n_(0) {
+    bind_g(Q, logv, G0, G1, alpha, beta, F);
+  }
+
+  QuadSoA(const QuadSoA& y) = delete;
+  QuadSoA(const QuadSoA&& y) = delete;
+  QuadSoA operator=(const QuadSoA& y) = delete;
+
+  // Replace the contents with Q bound to G as in the constructor,
+  // keeping the storage if it is large enough.
+  void bind_g(const Quad<Field>& Q, size_t logv, const Elt* G0, const Elt* G1,
+              const Elt& alpha, const Elt& beta, const Field& F) {
+    size_t nv = size_t(1) << logv;
+    auto dot = Eqs<Field>::raw_eq2(logv, nv, G0, G1, alpha, F);
+
+    n_ = 0;
+    h_[0].resize(Q.n_);
+    h_[1].resize(Q.n_);
+    v_.resize(Q.n_);
+    for (index_t i = 0; i < Q.n_; ++i) {
+      const auto& c = Q.c_[i];
+      Elt v = c.v;
+      if (v == F.zero()) {
+        v = beta;
+      }
+      F.mul(v, dot[corner_t(c.g)]);
+
+      // Coalesce adjacent duplicates, as Quad::bind_g() does.
+      if (n_ > 0 && h_[0][n_ - 1] == c.h[0] && h_[1][n_ - 1] == c.h[1]) {
+        F.add(v_[n_ - 1], v);
+      } else {
+        h_[0][n_] = c.h[0];
+        h_[1][n_] = c.h[1];
+        v_[n_] = v;
+        ++n_;
+      }
+    }
+  }
+
+  corner_t hand(index_t i, size_t k) const { return corner_t(h_[k][i]); }
+  const Elt& val(index_t i) const { return v_[i]; }
+
+  // Same as Quad::bind_h().
+  void bind_h(const Elt& r, size_t hand, const Field& F) {
+    quad_corner_t* hh = h_[hand].data();
+    quad_corner_t* ho = h_[1 - hand].data();
+    index_t rd = 0, wr = 0;
+    while (rd < n_) {
+      quad_corner_t h = hh[rd], o = ho[rd];
+      Elt v;
+
+      index_t rd1 = rd + 1;
+      if (rd1 < n_ && ho[rd1] == o && (hh[rd1] >> 1) == (h >> 1) &&
+          hh[rd1] == h + quad_corner_t(1)) {
+        // we have two corners.
+        v = affine_interpolation(r, v_[rd], v_[rd1], F);
+        rd += 2;
+      } else {
+        // we have one corner and the other one is zero.
+        if ((h & quad_corner_t(1)) == quad_corner_t(0)) {
+          v = affine_interpolation_nz_z(r, v_[rd], F);
+        } else {
+          v = affine_interpolation_z_nz(r, v_[rd], F);
+        }
+        rd = rd1;
+      }
+
+      hh[wr] = h >> 1;
+      ho[wr] = o;
+      v_[wr] = v;
+      ++wr;
+    }
+
+    // shrink the array
+    n_ = wr;
+  }
+
+  Elt scalar() {
+    check(n_ == 1, "n_ == 1");
+    check(h_[0][0] == quad_corner_t(0), "h_[0][0] == 0");
+    check(h_[1][0] == quad_corner_t(0), "h_[1][0] == 0");
+    return v_[0];
+  }
+};
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_SUMCHECK_QUAD_SOA_H_
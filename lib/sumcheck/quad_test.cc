@@ -24,6 +24,7 @@
 #include "algebra/fp.h"
 #include "arrays/affine.h"
 #include "arrays/sparse.h"
+#include "sumcheck/quad_soa.h"
 #include "gtest/gtest.h"
 
 namespace proofs {
@@ -142,6 +143,76 @@ TEST(Quad, BindH) {
   one_bind_h(index_t(512), 33);
 }
 
+// QuadSoA must agree with Quad::bind_g() and Quad::bind_h() term by
+// term.
+void one_soa(index_t n, size_t logv, size_t logw) {
+  Quad<Field> Q(n);
+  size_t maskv = (size_t(1) << logv) - 1;
+  size_t maskw = (size_t(1) << logw) - 1;
+  for (index_t i = 0; i < n; ++i) {
+    // Small ranges so that binding G creates duplicates.
+    Q.c_[i] = Quad<Field>::corner{
+        .g = quad_corner_t((7 * i + 1) & maskv),
+        .h = {quad_corner_t((13 * i + 4) & maskw),
+              quad_corner_t((23 * i + 3) & maskw)},
+        .v = (i % 5 == 0) ? F.zero() : rng.next()};
+  }
+  Q.canonicalize(F);
+
+  RandomSlice G0(logv), G1(logv), H0(logw), H1(logw);
+  Elt alpha = rng.next(), beta = rng.next();
+
+  auto B = Q.clone();
+  B->bind_g(logv, G0.r_.data(), G1.r_.data(), alpha, beta, F);
+  QuadSoA<Field> S(Q, logv, G0.r_.data(), G1.r_.data(), alpha, beta, F);
+
+  auto same = [&]() {
+    EXPECT_EQ(B->n_, S.n_);
+    for (index_t i = 0; i < B->n_ && i < S.n_; ++i) {
+      EXPECT_EQ(B->hand(i, 0), S.hand(i, 0));
+      EXPECT_EQ(B->hand(i, 1), S.hand(i, 1));
+      EXPECT_EQ(B->val(i), S.val(i));
+    }
+  };
+
+  same();
+  for (size_t round = 0; round < logw; ++round) {
+    B->bind_h(H0.r_[round], /*hand=*/0, F);
+    S.bind_h(H0.r_[round], /*hand=*/0, F);
+    same();
+    B->bind_h(H1.r_[round], /*hand=*/1, F);
+    S.bind_h(H1.r_[round], /*hand=*/1, F);
+    same();
+  }
+  EXPECT_EQ(B->scalar(), S.scalar());
+
+  // Copying and binding into storage that already holds another quad
+  // gives the same result as fresh storage.
+  Quad<Field> C(2 * n);
+  C.copy_from(Q);
+  EXPECT_TRUE(C == Q);
+  QuadSoA<Field> T, U(Q, logv, G0.r_.data(), G1.r_.data(), alpha, beta, F);
+  T.bind_g(Q, logv, G1.r_.data(), G0.r_.data(), beta, alpha, F);
+  T.bind_h(H0.r_[0], /*hand=*/0, F);
+  T.bind_g(C, logv, G0.r_.data(), G1.r_.data(), alpha, beta, F);
+  EXPECT_EQ(T.n_, U.n_);
+  for (index_t i = 0; i < T.n_ && i < U.n_; ++i) {
+    EXPECT_EQ(T.hand(i, 0), U.hand(i, 0));
+    EXPECT_EQ(T.hand(i, 1), U.hand(i, 1));
+    EXPECT_EQ(T.val(i), U.val(i));
+  }
+}
+
+TEST(Quad, SoA) {
+  one_soa(index_t(1), 1, 1);
+  one_soa(index_t(666), 3, 10);
+  for (size_t i = 200; i < 220; i++) {
+    for (size_t logw = 1; logw < 12; ++logw) {
+      one_soa(index_t(i), 4, logw);
+    }
+  }
+}
+
 TEST(Quad, equality) {
   auto Q1 = Quad<Field>(1);
   auto Q1b = Quad<Field>(1);
@@ -28,6 +28,8 @@
 #include "sumcheck/prover.h"
 #include "sumcheck/quad.h"
 #include "sumcheck/verifier.h"
+#include "util/ceildiv.h"
+#include "util/thread_pool.h"
 #include "gtest/gtest.h"
 
 namespace proofs {
@@ -318,5 +320,118 @@ TEST(Sumcheck, RandomCircuit) {
     one_test_sumcheck(CIRCUIT.get());
   }
 }
+
+// A parallel prover must produce the same proof as the serial one,
+// for a circuit of NC copies of two layers of NW wires and NTERMS
+// terms each.
+void parallel_prover_test(corner_t nc, corner_t nw, index_t nterms) {
+  std::unique_ptr<Circuit<Field>> CIRCUIT(new Circuit<Field>);
+  *CIRCUIT = Circuit<Field>{
+      .nv = nw,
+      .logv = lg(nw),
+      .nc = nc,
+      .logc = lg(nc),
+      .nl = 2,
+  };
+  for (size_t ly = 0; ly < CIRCUIT->nl; ++ly) {
+    CIRCUIT->l.push_back(Layer<Field>{
+        .nw = nw,
+        .logw = lg(nw),
+        .quad = random_quad(nterms, nw, nw),
+    });
+  }
+
+  auto W = std::make_unique<Dense<Field>>(CIRCUIT->nc, nw);
+  for (corner_t i = 0; i < W->n0_ * W->n1_; ++i) {
+    W->v_[i] = rng.next();
+  }
+
+  ThreadPool pool(4);
+  Elt challenge[2][2];
+  for (size_t parallel = 0; parallel < 2; ++parallel) {
+    // The second proof reuses the scratch storage of the first.
+    Prover<Field> prover(F, parallel ? &pool : nullptr);
+    for (size_t iter = 0; iter < 2; ++iter) {
+      Proof<Field> proof(CIRCUIT->nl);
+      Prover<Field>::inputs in;
+      auto V = prover.eval_circuit(&in, CIRCUIT.get(), W->clone(), F);
+
+      Transcript tsp((uint8_t *)"test", 4);
+      prover.prove(&proof, nullptr, CIRCUIT.get(), in, tsp);
+
+      // The transcript has absorbed the entire proof.
+      challenge[parallel][iter] = tsp.elt(F);
+
+      const char* why;
+      Transcript tsv((uint8_t *)"test", 4);
+      EXPECT_TRUE(Verifier<Field>::verify(&why, CIRCUIT.get(), &proof,
+                                          std::move(V), W->clone(), tsv, F));
+    }
+  }
+  EXPECT_EQ(challenge[0][0], challenge[0][1]);
+  EXPECT_EQ(challenge[0][0], challenge[1][0]);
+  EXPECT_EQ(challenge[1][0], challenge[1][1]);
+}
+
+TEST(Sumcheck, ParallelProver) {
+  // Layers large enough to split the terms.
+  parallel_prover_test(/*nc=*/4, /*nw=*/9000, /*nterms=*/10000);
+
+  // Few terms and many copies, which splits the copies of each term.
+  parallel_prover_test(/*nc=*/1000, /*nw=*/20, /*nterms=*/5);
+}
+
+// A prover that recomputes layers from checkpoints must produce the
+// same proof as one that keeps all layers, with less memory.
+TEST(Sumcheck, CheckpointedProver) {
+  const size_t nw = 20;
+  std::unique_ptr<Circuit<Field>> CIRCUIT(new Circuit<Field>);
+  *CIRCUIT = Circuit<Field>{
+      .nv = nw,
+      .logv = lg(nw),
+      .nc = 16,
+      .logc = 4,
+      .nl = 12,
+  };
+  for (size_t ly = 0; ly < CIRCUIT->nl; ++ly) {
+    CIRCUIT->l.push_back(Layer<Field>{
+        .nw = nw,
+        .logw = lg(nw),
+        .quad = random_quad(300, nw, nw),
+    });
+  }
+
+  auto W = std::make_unique<Dense<Field>>(CIRCUIT->nc, nw);
+  for (corner_t i = 0; i < W->n0_ * W->n1_; ++i) {
+    W->v_[i] = rng.next();
+  }
+
+  Elt challenge0;
+  size_t peak0 = 0;
+  for (size_t k : {0, 2, 3, 5, 12}) {
+    Proof<Field> proof(CIRCUIT->nl);
+    Prover<Field>::inputs in;
+    Prover<Field> prover(F);
+    prover.set_checkpoint_interval(k);
+    auto V = prover.eval_circuit(&in, CIRCUIT.get(), W->clone(), F);
+
+    Transcript tsp((uint8_t *)"test", 4);
+    prover.prove(&proof, nullptr, CIRCUIT.get(), in, tsp);
+    Elt challenge = tsp.elt(F);
+
+    const char* why;
+    Transcript tsv((uint8_t *)"test", 4);
+    EXPECT_TRUE(Verifier<Field>::verify(&why, CIRCUIT.get(), &proof,
+                                        std::move(V), W->clone(), tsv, F));
+    if (k == 0) {
+      challenge0 = challenge;
+      peak0 = prover.peak_wires();
+      EXPECT_EQ(peak0, CIRCUIT->nl * CIRCUIT->nc * nw);
+    } else {
+      EXPECT_EQ(challenge, challenge0);
+      EXPECT_LT(prover.peak_wires(), peak0);
+    }
+  }
+}
 }  // namespace
 }  // namespace proofs
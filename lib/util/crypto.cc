@@ -18,6 +18,7 @@
 #include <cstdint>
 
 #include "util/panic.h"
+#include "openssl/crypto.h"
 #include "openssl/rand.h"
 
 namespace proofs {
@@ -27,6 +28,8 @@ void rand_bytes(uint8_t out[/*n*/], size_t n) {
   check(ret == 1, "openssl RAND_bytes failed");
 }
 
+void secure_zero(void* p, size_t n) { OPENSSL_cleanse(p, n); }
+
 void hex_to_str(char out[/* 2*n + 1*/], const uint8_t in[/*n*/], size_t n) {
   for (size_t i = 0; i < n; ++i) {
     out[2 * i] = "0123456789abcdef"[in[i] >> 4];
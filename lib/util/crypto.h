@@ -93,6 +93,16 @@ class PRF {
     check(ret == 1, "EVP_EncryptUpdate failed");
   }
 
+  // Evaluate the PRF on NBLOCKS consecutive inputs with one call into
+  // openssl, which pipelines the AES rounds across blocks.
+  void Eval(uint8_t out[/*nblocks * kPRFOutputSize*/],
+            const uint8_t in[/*nblocks * kPRFInputSize*/], size_t nblocks) {
+    int out_len = static_cast<int>(nblocks * kPRFOutputSize);
+    int ret = EVP_EncryptUpdate(ctx_, out, &out_len, in,
+                                static_cast<int>(nblocks * kPRFInputSize));
+    check(ret == 1, "EVP_EncryptUpdate failed");
+  }
+
  private:
   EVP_CIPHER_CTX* ctx_;
 };
@@ -101,6 +111,10 @@ class PRF {
 // This method will panic if the openssl library fails.
 void rand_bytes(uint8_t out[/*n*/], size_t n);
 
+// Overwrite the N bytes at P with zeros, in a way that the compiler
+// does not optimize away, for buffers that held secrets.
+void secure_zero(void* p, size_t n);
+
 void hex_to_str(char out[/* 2*n + 1*/], const uint8_t in[/*n*/], size_t n);
 
 }  // namespace proofs
@@ -0,0 +1,78 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_UTIL_EXECUTOR_H_
+#define PRIVACY_PROOFS_ZK_LIB_UTIL_EXECUTOR_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <functional>
+
+#include "util/ceildiv.h"
+
+namespace proofs {
+
+// An Executor runs batches of independent tasks, possibly in
+// parallel.  The library never creates threads on its own; callers
+// that want parallelism inject an Executor (e.g., a ThreadPool) into
+// the prover or verifier, and callers that do not care get the
+// SerialExecutor.
+//
+// Tasks must not depend on the order in which they run.  All
+// algorithms that use an Executor are written so that the output
+// is a deterministic function of the inputs, independent of the
+// schedule.
+class Executor {
+ public:
+  virtual ~Executor() = default;
+
+  // Upper bound on the number of tasks that may run concurrently.
+  virtual size_t concurrency() const = 0;
+
+  // Call TASK(i) for all 0 <= i < N, in any order and possibly
+  // concurrently, and return after all calls have returned.
+  virtual void run(size_t n, const std::function<void(size_t)>& task) = 0;
+
+  // Split [0, N) into contiguous ranges of at least GRAIN elements,
+  // and call F(begin, end) for each range via run().  The number of
+  // ranges is a small multiple of concurrency() to balance the load.
+  void parallel_for(size_t n, size_t grain,
+                    const std::function<void(size_t, size_t)>& f) {
+    if (n == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    size_t nt = std::min(ceildiv(n, grain), 4 * concurrency());
+    size_t chunk = ceildiv(n, std::max<size_t>(nt, 1));
+    run(ceildiv(n, chunk), [&](size_t t) {
+      size_t b = t * chunk;
+      f(b, std::min(n, b + chunk));
+    });
+  }
+};
+
+// Trivial executor that runs all tasks in the calling thread, in order.
+class SerialExecutor : public Executor {
+ public:
+  size_t concurrency() const override { return 1; }
+
+  void run(size_t n, const std::function<void(size_t)>& task) override {
+    for (size_t i = 0; i < n; ++i) {
+      task(i);
+    }
+  }
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_UTIL_EXECUTOR_H_
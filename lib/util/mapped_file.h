@@ -0,0 +1,51 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_UTIL_MAPPED_FILE_H_
+#define PRIVACY_PROOFS_ZK_LIB_UTIL_MAPPED_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+namespace proofs {
+
+// A read-only, shared memory mapping of an entire file.  All processes
+// mapping the same file share one copy of its pages in the page cache.
+class MappedFile {
+ public:
+  // Map the file at PATH.  Returns nullptr if the file cannot be
+  // opened or mapped.
+  static std::unique_ptr<MappedFile> open(const char* path);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // The mapping is page-aligned.
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  const uint8_t* data_;
+  size_t size_;
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_UTIL_MAPPED_FILE_H_
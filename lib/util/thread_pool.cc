@@ -0,0 +1,107 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread_pool.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace proofs {
+
+ThreadPool::ThreadPool(size_t nthreads) : stop_(false) {
+  for (size_t i = 1; i < nthreads; ++i) {
+    workers_.emplace_back([this] { worker(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto& t : workers_) {
+    t.join();
+  }
+}
+
+void ThreadPool::run(size_t n, const std::function<void(size_t)>& task) {
+  if (workers_.empty() || n <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  // The batch lives on our stack.  It stays alive until no thread
+  // holds a reference to it, i.e., until ACTIVE drops to zero.
+  Batch b{&task, n, {0}, /*active=*/1};
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    queue_.push_back(&b);
+  }
+  work_cv_.notify_all();
+
+  drain(&b);
+
+  std::unique_lock<std::mutex> lk(mu_);
+  retire(&b);
+  --b.active;
+  done_cv_.wait(lk, [&b] { return b.active == 0; });
+}
+
+void ThreadPool::drain(Batch* b) {
+  for (;;) {
+    size_t i = b->next.fetch_add(1, std::memory_order_relaxed);
+    if (i >= b->n) return;
+    (*b->task)(i);
+  }
+}
+
+void ThreadPool::retire(Batch* b) {
+  auto it = std::find(queue_.begin(), queue_.end(), b);
+  if (it != queue_.end()) {
+    queue_.erase(it);
+  }
+}
+
+void ThreadPool::worker() {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    work_cv_.wait(lk, [this] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // stop_ is set and there is nothing left to do
+      return;
+    }
+
+    Batch* b = queue_.front();
+    ++b->active;
+    lk.unlock();
+
+    drain(b);
+
+    lk.lock();
+    // All tasks of B are claimed, so nobody else needs to find it.
+    retire(b);
+    if (--b->active == 0) {
+      done_cv_.notify_all();
+    }
+  }
+}
+
+}  // namespace proofs
@@ -0,0 +1,78 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_UTIL_THREAD_POOL_H_
+#define PRIVACY_PROOFS_ZK_LIB_UTIL_THREAD_POOL_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "util/executor.h"
+
+namespace proofs {
+
+// A fixed-size pool of worker threads implementing the Executor
+// interface.
+//
+// The thread calling run() participates in the execution of its own
+// batch, so a pool with NTHREADS total concurrency spawns NTHREADS - 1
+// workers.  Because the caller never blocks while tasks of its batch
+// remain unclaimed, tasks may themselves call run() on the same pool
+// without deadlocking.
+class ThreadPool : public Executor {
+ public:
+  explicit ThreadPool(size_t nthreads);
+  ~ThreadPool() override;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t concurrency() const override { return workers_.size() + 1; }
+
+  void run(size_t n, const std::function<void(size_t)>& task) override;
+
+ private:
+  struct Batch {
+    const std::function<void(size_t)>* task;
+    size_t n;
+    std::atomic<size_t> next;  // next unclaimed task index
+    size_t active;             // threads working on the batch, under mu_
+  };
+
+  // Claim and run tasks of B until none are left.
+  static void drain(Batch* b);
+
+  // Remove B from the queue if present.  Requires mu_.
+  void retire(Batch* b);
+
+  void worker();
+
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  std::deque<Batch*> queue_;
+  bool stop_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_UTIL_THREAD_POOL_H_
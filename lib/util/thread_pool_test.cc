@@ -0,0 +1,74 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread_pool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "util/executor.h"
+#include "gtest/gtest.h"
+
+namespace proofs {
+namespace {
+
+TEST(ThreadPool, RunsEveryTaskOnce) {
+  for (size_t nthreads = 1; nthreads <= 8; ++nthreads) {
+    ThreadPool pool(nthreads);
+    EXPECT_EQ(pool.concurrency(), nthreads);
+    for (size_t n : {0, 1, 2, 7, 1000}) {
+      std::vector<std::atomic<size_t>> hits(n);
+      pool.run(n, [&](size_t i) { hits[i].fetch_add(1); });
+      for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(hits[i].load(), 1u);
+      }
+    }
+  }
+}
+
+TEST(ThreadPool, Nested) {
+  ThreadPool pool(4);
+  const size_t n = 17, m = 23;
+  std::vector<std::atomic<size_t>> hits(n * m);
+  pool.run(n, [&](size_t i) {
+    pool.run(m, [&](size_t j) { hits[i * m + j].fetch_add(1); });
+  });
+  for (size_t i = 0; i < n * m; ++i) {
+    EXPECT_EQ(hits[i].load(), 1u);
+  }
+}
+
+TEST(ThreadPool, ParallelFor) {
+  ThreadPool pool(3);
+  SerialExecutor serial;
+  for (Executor* ex : {static_cast<Executor*>(&pool),
+                       static_cast<Executor*>(&serial)}) {
+    for (size_t n : {0, 1, 5, 100, 12345}) {
+      for (size_t grain : {0, 1, 16, 100000}) {
+        std::vector<std::atomic<size_t>> hits(n);
+        ex->parallel_for(n, grain, [&](size_t b, size_t e) {
+          EXPECT_LT(b, e);
+          for (size_t i = b; i < e; ++i) hits[i].fetch_add(1);
+        });
+        for (size_t i = 0; i < n; ++i) {
+          EXPECT_EQ(hits[i].load(), 1u);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace proofs
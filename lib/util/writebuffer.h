@@ -0,0 +1,70 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_UTIL_WRITEBUFFER_H_
+#define PRIVACY_PROOFS_ZK_LIB_UTIL_WRITEBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "util/panic.h"
+
+namespace proofs {
+
+// The dual of ReadBuffer: sequential writes into a caller-provided
+// buffer of fixed size.
+class WriteBuffer {
+ public:
+  explicit WriteBuffer(uint8_t *buf, size_t sz)
+      : buf_(buf), size_(sz), next_(0) {}
+
+  // no copies
+  WriteBuffer(const WriteBuffer &) = delete;
+
+  // TRUE if at least N bytes remain
+  bool have(size_t n) const { return remaining() >= n; }
+
+  size_t remaining() const {
+    check(next_ <= size_, "next_ <= size_");
+    return size_ - next_;
+  }
+
+  // number of bytes written so far
+  size_t written() const { return next_; }
+
+  // Reserve the next N bytes, for the caller to fill in.
+  uint8_t *next(size_t n) {
+    check(have(n), "have(n)");
+    uint8_t *p = &buf_[next_];
+    next_ += n;
+    return p;
+  }
+
+  void next(size_t n, const uint8_t src[/*n*/]) {
+    uint8_t *p = next(n);
+    if (n > 0) {
+      memcpy(p, src, n);
+    }
+  }
+
+ private:
+  uint8_t *buf_;
+  size_t size_;
+  size_t next_;
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_UTIL_WRITEBUFFER_H_
@@ -44,6 +44,7 @@ class ZkCommon {
   using CPoly = typename LayerProof<Field>::CPoly;
   using WPoly = typename LayerProof<Field>::WPoly;
   using FWPoly = typename LayerProof<Field>::FWPoly;
+  using FCPoly = typename LayerProof<Field>::FCPoly;
 
  public:
   // pi: witness index for first pad element in a larger commitment
@@ -68,9 +69,7 @@ class ZkCommon {
     size_t ci = 0;  // Index of the next Ligero constraint.
 
     const typename FWPoly::dot_interpolation dot_wpoly(F);
-
-    // no copies in this version.
-    check(circuit.logc == 0, "assuming that copies=1");
+    const typename FCPoly::dot_interpolation dot_cpoly(F);
 
     // Constraints from the sumcheck verifier.
     for (size_t ly = 0; ly < circuit.nl; ++ly) {
@@ -83,12 +82,23 @@ class ZkCommon {
       // The loop below assumes at least one round.
       check(clr->logw > 0, "clr->logw > 0");
 
-      PadLayout pl(clr->logw);
+      PadLayout pl(circuit.logc, clr->logw);
       ConstraintBuilder cb(pl, F);  // representing 0
 
       cb.first(challenge->alpha, cla.claim);
       // now cb contains claim_{-1} from the previous layer
 
+      // Copy rounds, which bind the C variables first.
+      for (size_t round = 0; round < circuit.logc; ++round) {
+        const CPoly& cp = plr->cp[round];
+        challenge->cb[round] = tss.round(cp);
+        const FCPoly lag = dot_cpoly.coef(challenge->cb[round], F);
+
+        cb.next_c(round, &lag[0], cp.t_);
+        // now cb contains a symbolic representation of the claim
+        // after copy round ROUND
+      }
+
       for (size_t round = 0; round < clr->logw; ++round) {
         for (size_t hand = 0; hand < 2; ++hand) {
           size_t r = 2 * round + hand;
@@ -108,7 +118,7 @@ class ZkCommon {
       Elt quad = aux == nullptr ? bind_quad(clr, cla, challenge, F)
                                 : aux->bound_quad[ly];
       Elt eqv =
-          Eq<Field>::eval(circuit.logc, circuit.nc, ch.q, challenge->cb, F);
+          Eq<Field>::eval(circuit.logc, circuit.nc, cla.q, challenge->cb, F);
       Elt eqq = F.mulf(eqv, quad);
 
       // Add the final constraint from above.
@@ -133,14 +143,23 @@ class ZkCommon {
     auto plr = &proof.l[circuit.nl - 1];
     Elt got = F.addf(plr->wc[0], F.mulf(alpha, plr->wc[1]));
 
-    return input_constraint(cla, pub, npub, ninp, pi, got, alpha, a, b, ci, F);
+    return input_constraint(cla, pub, circuit.nc, circuit.logc, npub, ninp, pi,
+                            got, alpha, a, b, ci, F);
+  }
+
+  // Returns the number of committed witnesses for circuit C, which
+  // are the private inputs of all copies.  Inputs are stored with the
+  // copies as the fast dimension, so the private inputs of all copies
+  // start at index C.npub_in * C.nc of the input array.
+  static size_t witness_size(const Circuit<Field>& C) {
+    return (C.ninputs - C.npub_in) * C.nc;
   }
 
   // Returns the size of the proof pad for circuit C.
   static size_t pad_size(const Circuit<Field>& C) {
     size_t sz = 0;
     for (size_t i = 0; i < C.nl; ++i) {
-      PadLayout pl(C.l[i].logw);
+      PadLayout pl(C.logc, C.l[i].logw);
       sz += pl.layer_size();
     }
     return sz;
@@ -152,7 +171,7 @@ class ZkCommon {
                         size_t start_pad) {
     size_t pi = start_pad;
     for (size_t i = 0; i < C.nl; ++i) {
-      PadLayout pl(C.l[i].logw);
+      PadLayout pl(C.logc, C.l[i].logw);
       lqc[i].x = pi + pl.claim_pad(0);
       lqc[i].y = pi + pl.claim_pad(1);
       lqc[i].z = pi + pl.claim_pad(2);
@@ -167,8 +186,8 @@ class ZkCommon {
                                               const Field& F) {
     ts.write(circuit.id, sizeof(circuit.id));
 
-    // Public inputs:
-    for (size_t i = 0; i < circuit.npub_in; ++i) {
+    // Public inputs of all copies, in the order in which PUB stores them:
+    for (size_t i = 0; i < circuit.npub_in * circuit.nc; ++i) {
       ts.write(pub.at(i), F);
     }
 
@@ -192,10 +211,11 @@ class ZkCommon {
   };
 
   class PadLayout {
+    size_t logc_;
     size_t logw_;
 
    public:
-    explicit PadLayout(size_t logw) : logw_(logw) {}
+    explicit PadLayout(size_t logc, size_t logw) : logc_(logc), logw_(logw) {}
 
     // Layout of padding in the expr_.symbolic array.
     //
@@ -205,9 +225,16 @@ class ZkCommon {
     // name for the third evaluation point of the sumcheck round
     // polynomial (could be X for binary fields GF(2)[X] / (Q(X))).
     //
+    // A *cpoly pad* is a triple [dP(0), dP(2), dP(3)] for the degree-3
+    // polynomial of a copy round, with the same convention.
+    //
     // The layout of expr_.symbolic is
-    //  [CLAIM_PAD[layer - 1], POLY_PAD[0], POLY_PAD[1], ..
-    //   POLY_PAD[LOGW - 1], CLAIM_PAD[layer]]
+    //  [CLAIM_PAD[layer - 1], CPOLY_PAD[0], .. CPOLY_PAD[LOGC - 1],
+    //   POLY_PAD[0], POLY_PAD[1], .. POLY_PAD[2 * LOGW - 1],
+    //   CLAIM_PAD[layer]]
+    //
+    // which is the order in which ZkProver::fill_pad() appends the
+    // pad to the witness.
     //
     // The layout of adjacent layers thus overlaps.  For layer 0
     // we still lay out CLAIM_PAD[layer - 1] to keep the representation
@@ -221,12 +248,21 @@ class ZkCommon {
     //------------------------------------------------------------
     // Indexing without overlap.
     //------------------------------------------------------------
+    size_t cpoly_pad(size_t r, size_t point) const {
+      check(point == 0 || point == 2 || point == 3,
+            "unknown cpoly_pad() layout");
+      if (point == 0) {
+        return 3 * r;
+      } else {
+        return 3 * r + (point - 1);
+      }
+    }
     size_t poly_pad(size_t r, size_t point) const {
       check(point == 0 || point == 2, "unknown poly_pad() layout");
       if (point == 0) {
-        return 2 * r;
+        return 3 * logc_ + 2 * r;
       } else if (point == 2) {
-        return 2 * r + 1;
+        return 3 * logc_ + 2 * r + 1;
       }
       return 0;  // silence noreturn warning
     }
@@ -241,10 +277,17 @@ class ZkCommon {
     //------------------------------------------------------------
     // index of CLAIM_PAD[layer - 1][n]
     size_t ovp_claim_pad_m1(size_t n) const { return n; }
+    // index of the first pad of this layer
+    size_t ovp_layer_start() const { return 3; }
+    size_t ovp_cpoly_pad(size_t r, size_t point) const {
+      return ovp_layer_start() + cpoly_pad(r, point);
+    }
     size_t ovp_poly_pad(size_t r, size_t point) const {
-      return 3 + poly_pad(r, point);
+      return ovp_layer_start() + poly_pad(r, point);
+    }
+    size_t ovp_claim_pad(size_t n) const {
+      return ovp_layer_start() + claim_pad(n);
     }
-    size_t ovp_claim_pad(size_t n) const { return 3 + claim_pad(n); }
     size_t ovp_layer_size() const { return ovp_claim_pad(3); }
   };
 
@@ -331,6 +374,20 @@ class ZkCommon {
       // expr_ contains claim_{-1} = cl0 + alpha*cl1
     }
 
+    // Same as next(), but for copy round R, whose polynomial has
+    // degree 3.
+    void next_c(size_t r, const Elt lag[], const Elt tr[]) {
+      // expr contains the claim before this round
+      expr_.axmy(pl_.ovp_cpoly_pad(r, 0), tr[0], f_.one());
+      // expr contains p_{r}(1) = claim - p_{r}(0)
+
+      expr_.scale(lag[1]);
+      expr_.axpy(pl_.ovp_cpoly_pad(r, 0), tr[0], lag[0]);
+      expr_.axpy(pl_.ovp_cpoly_pad(r, 2), tr[2], lag[2]);
+      expr_.axpy(pl_.ovp_cpoly_pad(r, 3), tr[3], lag[3]);
+      // expr_ contains the claim <lag_{r}, p_{r}> after this round
+    }
+
     // Given claim_{r-1}, compute claim_{r}
     void next(size_t r, const Elt lag[], const Elt tr[]) {
       // expr contains claim_{r-1}
@@ -387,15 +444,15 @@ class ZkCommon {
       b.push_back(rhs);
 
       // Layer 0 does not refer to CLAIM_PAD[layer - 1]
-      size_t i0 = (ly == 0) ? pl_.ovp_poly_pad(0, 0) : pl_.ovp_claim_pad_m1(0);
+      size_t i0 = (ly == 0) ? pl_.ovp_layer_start() : pl_.ovp_claim_pad_m1(0);
 
       for (size_t i = i0; i < lhs.size(); ++i) {
         // "i" is in the "with overlap" reference frame.
         // "pi" is in the "without overlap" reference frame.
         //
-        // In theory at least, (pi - pl_.ovp_poly_pad(0, 0))
-        // could overflow, but (pi + i) - pl_.ovp_poly_pad(0, 0) cannot.
-        a.push_back(Llc{ci, (pi + i) - pl_.ovp_poly_pad(0, 0), lhs[i]});
+        // In theory at least, (pi - pl_.ovp_layer_start())
+        // could overflow, but (pi + i) - pl_.ovp_layer_start() cannot.
+        a.push_back(Llc{ci, (pi + i) - pl_.ovp_layer_start(), lhs[i]});
       }
     }
   };
@@ -404,21 +461,30 @@ class ZkCommon {
   // This method explicitly computes the public binding, and then adds the
   // constraints that
   //    binding(witness, R_w) = got - binding(pub_inputs, R_p)
+  //
+  // Input I of copy C is at index I * NC + C, and its binding is
+  // EQ[Q, C] (EQ[G0, I] + alpha EQ[G1, I]).
   static size_t input_constraint(const Claims& cla, const Dense<Field>& pub,
-                                 size_t pub_inputs, size_t num_inputs,
-                                 size_t pi, Elt got, Elt alpha,
-                                 std::vector<Llc>& a, std::vector<Elt>& b,
-                                 size_t ci, const Field& F) {
+                                 size_t nc, size_t logc, size_t pub_inputs,
+                                 size_t num_inputs, size_t pi, Elt got,
+                                 Elt alpha, std::vector<Llc>& a,
+                                 std::vector<Elt>& b, size_t ci,
+                                 const Field& F) {
+    Eqs<Field> eqc(logc, nc, cla.q, F);
     Eqs<Field> eq0(cla.logv, num_inputs, cla.g[0], F);
     Eqs<Field> eq1(cla.logv, num_inputs, cla.g[1], F);
     Elt pub_binding = F.zero();
     for (index_t i = 0; i < num_inputs; ++i) {
       Elt b_i = F.addf(eq0.at(i), F.mulf(alpha, eq1.at(i)));
-      if (i < pub_inputs) {
-        F.add(pub_binding, F.mulf(b_i, pub.at(i)));
-      } else {
-        // Use (i - pub_inputs) for the index of private inputs.
-        a.push_back(Llc{ci, i - pub_inputs, b_i});
+      for (size_t c = 0; c < nc; ++c) {
+        Elt b_ic = (nc == 1) ? b_i : F.mulf(eqc.at(c), b_i);
+        size_t k = i * nc + c;
+        if (i < pub_inputs) {
+          F.add(pub_binding, F.mulf(b_ic, pub.at(k)));
+        } else {
+          // Use (k - pub_inputs * nc) for the index of private inputs.
+          a.push_back(Llc{ci, k - pub_inputs * nc, b_ic});
+        }
       }
     }
 
@@ -426,13 +492,13 @@ class ZkCommon {
     // one past the last real layer.  The alternative of
     // considering the input as part of the last real layer
     // yields code that looks even more convoluted.
-    PadLayout pl(/*logw=*/0);
+    PadLayout pl(/*logc=*/0, /*logw=*/0);
 
     // This paranoid assertion holds unless the circuit has zero
     // layers, which is not guaranteed by this function alone.
-    check(pi >= pl.ovp_poly_pad(0, 0), "pi >= pl.ovp_poly_pad(0, 0)");
+    check(pi >= pl.ovp_layer_start(), "pi >= pl.ovp_layer_start()");
 
-    size_t claim_pad_m1 = pi - pl.ovp_poly_pad(0, 0);
+    size_t claim_pad_m1 = pi - pl.ovp_layer_start();
     a.push_back(Llc{ci, claim_pad_m1 + 0, F.mone()});
     a.push_back(Llc{ci, claim_pad_m1 + 1, F.negf(alpha)});
     b.push_back(F.subf(got, pub_binding));
@@ -27,6 +27,7 @@
 #include "util/log.h"
 #include "util/readbuffer.h"
 #include "util/serialization.h"
+#include "util/writebuffer.h"
 #include "zk/zk_common.h"
 
 namespace proofs {
@@ -63,38 +64,55 @@ struct ZkProof {
   explicit ZkProof(const Circuit<Field> &c, size_t rate, size_t req)
       : c(c),
         proof(c.nl),
-        param((c.ninputs - c.npub_in) + ZkCommon<Field>::pad_size(c), c.nl,
-              rate, req),
+        param(ZkCommon<Field>::witness_size(c) + ZkCommon<Field>::pad_size(c),
+              c.nl, rate, req),
         com_proof(&param) {}
 
   explicit ZkProof(const Circuit<Field> &c, size_t rate, size_t req,
                    size_t block_enc)
       : c(c),
         proof(c.nl),
-        param((c.ninputs - c.npub_in) + ZkCommon<Field>::pad_size(c), c.nl,
-              rate, req, block_enc),
+        param(ZkCommon<Field>::witness_size(c) + ZkCommon<Field>::pad_size(c),
+              c.nl, rate, req, block_enc),
         com_proof(&param) {}
 
-  // Maximum size of the proof in bytes. The actual size will be smaller
-  // because the Merkle proof is batched.
+  // Maximum size in bytes of the output of write(), which is known
+  // before proving.  The actual size will be smaller because the Merkle
+  // proof is batched and because subfield elements are shorter.  In
+  // the worst case of the encoding of the opened columns, every element
+  // is a run by itself, plus one empty run at the start and one more
+  // for every run split at kMaxRunLen.
   size_t size() const {
-    return Digest::kLength +
-
-           proof.size() * Field::kBytes +
+    const LigeroProof<Field> &pr = com_proof;
+    size_t n = pr.nreq * pr.nrow;
+    size_t nruns = n + 1 + 2 * (n / kMaxRunLen);
+    return Digest::kLength + sc_proof_size(proof) +
+           (2 * pr.dblock + pr.r) * Field::kBytes +
+           pr.nreq * MerkleNonce::kLength + n * Field::kBytes + 4 * nruns +
+           4 + pr.nreq * pr.mc_pathlen * Digest::kLength;
+  }
 
-           com_proof.block * 2 * Field::kBytes +
-           com_proof.nreq * com_proof.nrow * Field::kBytes +
-           com_proof.nreq * com_proof.mc_pathlen * Digest::kLength;
+  // Exact size in bytes of the output of write().
+  size_t serialized_size(const Field &F) const {
+    return Digest::kLength + sc_proof_size(proof) +
+           com_proof_size(com_proof, F);
   }
 
+  // Append the proof to BUF.
   void write(std::vector<uint8_t> &buf, const Field &F) const {
-    size_t s0 = buf.size();
+    append(buf, serialized_size(F), [&](WriteBuffer &wb) { write(wb, F); });
+  }
+
+  // Write the proof into caller-provided memory, which must have room
+  // for serialized_size(F) bytes.
+  void write(WriteBuffer &buf, const Field &F) const {
+    size_t s0 = buf.written();
     write_com(com, buf, F);
-    size_t s1 = buf.size();
+    size_t s1 = buf.written();
     write_sc_proof(proof, buf, F);
-    size_t s2 = buf.size();
+    size_t s2 = buf.written();
     write_com_proof(com_proof, buf, F);
-    size_t s3 = buf.size();
+    size_t s3 = buf.written();
     log(INFO,
         "com:%zu, sc:%zu, com_proof:%zu [%zu el, %zu el, %zu d in %zu "
         "rows]: %zub",
@@ -103,7 +121,8 @@ struct ZkProof {
         com_proof.nrow, s3 - s0);
   }
 
-  // The read function returns false on error or underflow.
+  // The read function returns false on error or underflow.  The
+  // proof is parsed in place from the memory of BUF, without copies.
   bool read(ReadBuffer &buf, const Field &F) {
     if (!read_com(com, buf, F)) return false;
     if (!read_sc_proof(proof, buf, F)) return false;
@@ -111,10 +130,36 @@ struct ZkProof {
     return true;
   }
 
+  // The vector versions of the write_*() methods append to BUF.
   void write_sc_proof(const Proof<Field> &pr, std::vector<uint8_t> &buf,
                       const Field &F) const {
-    check(c.logc == 0, "cannot write sc proof with logc != 0");
+    append(buf, sc_proof_size(pr),
+           [&](WriteBuffer &wb) { write_sc_proof(pr, wb, F); });
+  }
+
+  void write_com(const LigeroCommitment<Field> &com0,
+                 std::vector<uint8_t> &buf, const Field &F) const {
+    append(buf, Digest::kLength,
+           [&](WriteBuffer &wb) { write_com(com0, wb, F); });
+  }
+
+  void write_com_proof(const LigeroProof<Field> &pr, std::vector<uint8_t> &buf,
+                       const Field &F) const {
+    append(buf, com_proof_size(pr, F),
+           [&](WriteBuffer &wb) { write_com_proof(pr, wb, F); });
+  }
+
+  void write_sc_proof(const Proof<Field> &pr, WriteBuffer &buf,
+                      const Field &F) const {
     for (size_t i = 0; i < pr.l.size(); ++i) {
+      for (size_t ci = 0; ci < c.logc; ++ci) {
+        for (size_t k = 0; k < 4; ++k) {
+          // Optimization: do not send p(1) as it is implied by constraints.
+          if (k != 1) {
+            write_elt(pr.l[i].cp[ci].t_[k], buf, F);
+          }
+        }
+      }
       for (size_t wi = 0; wi < c.l[i].logw; ++wi) {
         for (size_t k = 0; k < 3; ++k) {
           // Optimization: do not send p(1) as it is implied by constraints.
@@ -129,34 +174,75 @@ struct ZkProof {
     }
   }
 
-  void write_com(const LigeroCommitment<Field> &com0, std::vector<uint8_t> &buf,
+  void write_com(const LigeroCommitment<Field> &com0, WriteBuffer &buf,
                  const Field &F) const {
-    buf.insert(buf.end(), com0.root.data, com0.root.data + Digest::kLength);
+    write_digest(com0.root, buf);
   }
 
-  void write_com_proof(const LigeroProof<Field> &pr, std::vector<uint8_t> &buf,
+  void write_com_proof(const LigeroProof<Field> &pr, WriteBuffer &buf,
                        const Field &F) const {
-    for (size_t i = 0; i < pr.block; ++i) {
-      write_elt(pr.y_ldt[i], buf, F);
-    }
-    for (size_t i = 0; i < pr.dblock; ++i) {
-      write_elt(pr.y_dot[i], buf, F);
-    }
-    for (size_t i = 0; i < pr.r; ++i) {
-      write_elt(pr.y_quad_0[i], buf, F);
-    }
-    for (size_t i = 0; i < pr.dblock - pr.block; ++i) {
-      write_elt(pr.y_quad_2[i], buf, F);
-    }
+    write_elts(pr.y_ldt.data(), pr.block, buf, F);
+    write_elts(pr.y_dot.data(), pr.dblock, buf, F);
+    write_elts(pr.y_quad_0.data(), pr.r, buf, F);
+    write_elts(pr.y_quad_2.data(), pr.dblock - pr.block, buf, F);
 
     // write all the Merkle nonces
     for (size_t i = 0; i < pr.nreq; ++i) {
       write_nonce(pr.merkle.nonce[i], buf);
     }
 
-    // The format of the opened rows consists of a run of full-field elements,
-    // then a run of base-field elements, and finally a run of full-field
-    // elements.  To compress, we employ a run-length encoding approach.
+    for_each_run(pr, F, [&](size_t ci, size_t runlen, bool subfield_run) {
+      write_size(runlen, buf);
+      if (subfield_run) {
+        write_subfield_elts(pr.req.data() + ci, runlen, buf, F);
+      } else {
+        write_elts(pr.req.data() + ci, runlen, buf, F);
+      }
+    });
+
+    write_size(pr.merkle.path.size(), buf);
+    for (size_t i = 0; i < pr.merkle.path.size(); ++i) {
+      write_digest(pr.merkle.path[i], buf);
+    }
+  }
+
+ private:
+  // Resize BUF to make room for SZ more bytes, and let WRITE fill them.
+  template <class Fn>
+  static void append(std::vector<uint8_t> &buf, size_t sz, const Fn &write) {
+    size_t s0 = buf.size();
+    buf.resize(s0 + sz);
+    WriteBuffer wb(buf.data() + s0, sz);
+    write(wb);
+    check(wb.remaining() == 0, "wb.remaining() == 0");
+  }
+
+  size_t sc_proof_size(const Proof<Field> &pr) const {
+    size_t sz = 0;
+    for (size_t i = 0; i < pr.l.size(); ++i) {
+      sz += (c.logc * (4 - 1) + c.l[i].logw * (3 - 1) * 2 + 2) *
+            Field::kBytes;
+    }
+    return sz;
+  }
+
+  size_t com_proof_size(const LigeroProof<Field> &pr, const Field &F) const {
+    size_t sz = (pr.block + pr.dblock + pr.r + (pr.dblock - pr.block)) *
+                    Field::kBytes +
+                pr.nreq * MerkleNonce::kLength;
+    for_each_run(pr, F, [&](size_t ci, size_t runlen, bool subfield_run) {
+      sz += 4 + runlen * (subfield_run ? Field::kSubFieldBytes : Field::kBytes);
+    });
+    return sz + 4 + pr.merkle.path.size() * Digest::kLength;
+  }
+
+  // The format of the opened rows consists of a run of full-field elements,
+  // then a run of base-field elements, and finally a run of full-field
+  // elements.  To compress, we employ a run-length encoding approach.
+  // Call FN(CI, RUNLEN, SUBFIELD_RUN) for each run REQ[CI, CI + RUNLEN).
+  template <class Fn>
+  static void for_each_run(const LigeroProof<Field> &pr, const Field &F,
+                           const Fn &fn) {
     size_t ci = 0;
     bool subfield_run = false;
     while (ci < pr.nreq * pr.nrow) {
@@ -165,61 +251,71 @@ struct ZkProof {
              F.in_subfield(pr.req[ci + runlen]) == subfield_run) {
         ++runlen;
       }
-      write_size(runlen, buf);
-      for (size_t i = ci; i < ci + runlen; ++i) {
-        if (subfield_run) {
-          write_subfield_elt(pr.req[i], buf, F);
-        } else {
-          write_elt(pr.req[i], buf, F);
-        }
-      }
+      fn(ci, runlen, subfield_run);
       ci += runlen;
       subfield_run = !subfield_run;
     }
+  }
 
-    write_size(pr.merkle.path.size(), buf);
-    for (size_t i = 0; i < pr.merkle.path.size(); ++i) {
-      write_digest(pr.merkle.path[i], buf);
-    }
+  void write_elt(const Elt &x, WriteBuffer &buf, const Field &F) const {
+    F.to_bytes_field(buf.next(Field::kBytes), x);
   }
 
- private:
-  void write_elt(const Elt &x, std::vector<uint8_t> &buf,
-                 const Field &F) const {
-    uint8_t tmp[Field::kBytes];
-    F.to_bytes_field(tmp, x);
-    buf.insert(buf.end(), tmp, tmp + Field::kBytes);
+  // Serialize a run of elements with one bounds check.
+  void write_elts(const Elt x[/*n*/], size_t n, WriteBuffer &buf,
+                  const Field &F) const {
+    uint8_t *p = buf.next(n * Field::kBytes);
+    for (size_t i = 0; i < n; ++i) {
+      F.to_bytes_field(&p[i * Field::kBytes], x[i]);
+    }
   }
 
-  void write_subfield_elt(const Elt &x, std::vector<uint8_t> &buf,
-                          const Field &F) const {
-    uint8_t tmp[Field::kSubFieldBytes];
-    F.to_bytes_subfield(tmp, x);
-    buf.insert(buf.end(), tmp, tmp + Field::kSubFieldBytes);
+  void write_subfield_elts(const Elt x[/*n*/], size_t n, WriteBuffer &buf,
+                           const Field &F) const {
+    uint8_t *p = buf.next(n * Field::kSubFieldBytes);
+    for (size_t i = 0; i < n; ++i) {
+      F.to_bytes_subfield(&p[i * Field::kSubFieldBytes], x[i]);
+    }
   }
 
-  void write_digest(const Digest &x, std::vector<uint8_t> &buf) const {
-    buf.insert(buf.end(), x.data, x.data + Digest::kLength);
+  void write_digest(const Digest &x, WriteBuffer &buf) const {
+    buf.next(Digest::kLength, x.data);
   }
 
-  void write_nonce(const MerkleNonce &x, std::vector<uint8_t> &buf) const {
-    buf.insert(buf.end(), x.bytes, x.bytes + MerkleNonce::kLength);
+  void write_nonce(const MerkleNonce &x, WriteBuffer &buf) const {
+    buf.next(MerkleNonce::kLength, x.bytes);
   }
 
   // Assumption is that all of the sizes of arrays that are part of proofs
   // fit into 4 bytes, and can thus work on 32-b machines.
-  void write_size(size_t g, std::vector<uint8_t> &buf) const {
+  void write_size(size_t g, WriteBuffer &buf) const {
+    uint8_t *p = buf.next(4);
     for (size_t i = 0; i < 4; ++i) {
-      buf.push_back(static_cast<uint8_t>(g & 0xff));
+      p[i] = static_cast<uint8_t>(g & 0xff);
       g >>= 8;
     }
   }
 
   bool read_sc_proof(Proof<Field> &pr, ReadBuffer &buf, const Field &F) {
-    if (c.logc != 0) return false;
     for (size_t i = 0; i < pr.l.size(); ++i) {
-      size_t needed = (c.l[i].logw * (3 - 1) * 2 + 2) * Field::kBytes;
+      size_t needed =
+          (c.logc * (4 - 1) + c.l[i].logw * (3 - 1) * 2 + 2) * Field::kBytes;
       if (!buf.have(needed)) return false;
+      for (size_t ci = 0; ci < c.logc; ++ci) {
+        for (size_t k = 0; k < 4; ++k) {
+          // Optimization: the p(1) value was not sent.
+          if (k != 1) {
+            auto v = read_elt(buf, F);
+            if (v) {
+              pr.l[i].cp[ci].t_[k] = v.value();
+            } else {
+              return false;
+            }
+          } else {
+            pr.l[i].cp[ci].t_[k] = F.zero();
+          }
+        }
+      }
       for (size_t wi = 0; wi < c.l[i].logw; ++wi) {
         for (size_t k = 0; k < 3; ++k) {
           // Optimization: the p(1) value was not sent.
@@ -258,44 +354,11 @@ struct ZkProof {
   }
 
   bool read_com_proof(LigeroProof<Field> &pr, ReadBuffer &buf, const Field &F) {
-    if (!buf.have(pr.block * Field::kBytes)) return false;
-    for (size_t i = 0; i < pr.block; ++i) {
-      auto v = read_elt(buf, F);
-      if (v) {
-        pr.y_ldt[i] = v.value();
-      } else {
-        return false;
-      }
-    }
-
-    if (!buf.have(pr.dblock * Field::kBytes)) return false;
-    for (size_t i = 0; i < pr.dblock; ++i) {
-      auto v = read_elt(buf, F);
-      if (v) {
-        pr.y_dot[i] = v.value();
-      } else {
-        return false;
-      }
-    }
-
-    if (!buf.have(pr.r * Field::kBytes)) return false;
-    for (size_t i = 0; i < pr.r; ++i) {
-      auto v = read_elt(buf, F);
-      if (v) {
-        pr.y_quad_0[i] = v.value();
-      } else {
-        return false;
-      }
-    }
-
-    if (!buf.have((pr.dblock - pr.block) * Field::kBytes)) return false;
-    for (size_t i = 0; i < pr.dblock - pr.block; ++i) {
-      auto v = read_elt(buf, F);
-      if (v) {
-        pr.y_quad_2[i] = v.value();
-      } else {
-        return false;
-      }
+    if (!read_elts(pr.y_ldt.data(), pr.block, buf, F)) return false;
+    if (!read_elts(pr.y_dot.data(), pr.dblock, buf, F)) return false;
+    if (!read_elts(pr.y_quad_0.data(), pr.r, buf, F)) return false;
+    if (!read_elts(pr.y_quad_2.data(), pr.dblock - pr.block, buf, F)) {
+      return false;
     }
 
     if (!buf.have(pr.nreq * MerkleNonce::kLength)) return false;
@@ -310,26 +373,11 @@ struct ZkProof {
       if (!buf.have(4)) return false;
       size_t runlen = read_size(buf); /* untrusted size input */
       if (runlen >= kMaxRunLen || ci + runlen > pr.nreq * pr.nrow) return false;
+      Elt *run = pr.req.data() + ci;
       if (subfield_run) {
-        if (!buf.have(runlen * Field::kSubFieldBytes)) return false;
-        for (size_t i = ci; i < ci + runlen; ++i) {
-          auto v = read_subfield_elt(buf, F);
-          if (v) {
-            pr.req[i] = v.value();
-          } else {
-            return false;
-          }
-        }
+        if (!read_subfield_elts(run, runlen, buf, F)) return false;
       } else {
-        if (!buf.have(runlen * Field::kBytes)) return false;
-        for (size_t i = ci; i < ci + runlen; ++i) {
-          auto v = read_elt(buf, F);
-          if (v) {
-            pr.req[i] = v.value();
-          } else {
-            return false;
-          }
-        }
+        if (!read_elts(run, runlen, buf, F)) return false;
       }
       ci += runlen;
       subfield_run = !subfield_run;
@@ -358,8 +406,30 @@ struct ZkProof {
     return F.of_bytes_field(buf.next(Field::kBytes));
   }
 
-  std::optional<Elt> read_subfield_elt(ReadBuffer &buf, const Field &F) const {
-    return F.of_bytes_subfield(buf.next(Field::kSubFieldBytes));
+  // Decode a run of N elements with one bounds check.  Return false on
+  // underflow or if any element is invalid.
+  bool read_elts(Elt x[/*n*/], size_t n, ReadBuffer &buf,
+                 const Field &F) const {
+    if (!buf.have(n * Field::kBytes)) return false;
+    const uint8_t *p = buf.next(n * Field::kBytes);
+    for (size_t i = 0; i < n; ++i) {
+      auto v = F.of_bytes_field(&p[i * Field::kBytes]);
+      if (!v) return false;
+      x[i] = v.value();
+    }
+    return true;
+  }
+
+  bool read_subfield_elts(Elt x[/*n*/], size_t n, ReadBuffer &buf,
+                          const Field &F) const {
+    if (!buf.have(n * Field::kSubFieldBytes)) return false;
+    const uint8_t *p = buf.next(n * Field::kSubFieldBytes);
+    for (size_t i = 0; i < n; ++i) {
+      auto v = F.of_bytes_subfield(&p[i * Field::kSubFieldBytes]);
+      if (!v) return false;
+      x[i] = v.value();
+    }
+    return true;
   }
 
   void read_digest(ReadBuffer &buf, Digest &x) const {
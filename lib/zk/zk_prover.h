@@ -23,11 +23,13 @@
 #include "arrays/dense.h"
 #include "ligero/ligero_param.h"
 #include "ligero/ligero_prover.h"
+#include "ligero/ligero_transcript.h"
 #include "random/random.h"
 #include "random/transcript.h"
 #include "sumcheck/circuit.h"
 #include "sumcheck/prover_layers.h"
 #include "sumcheck/transcript_sumcheck.h"
+#include "util/executor.h"
 #include "util/log.h"
 #include "util/panic.h"
 #include "zk/zk_common.h"
@@ -57,48 +59,145 @@ class ZkProver : public ProverLayers<Field> {
   using typename super::inputs;
 
  public:
+  // A ZkProver may be reused for any number of proofs on CIRCUIT, one
+  // at a time.  The witness, the pad, the Ligero tableau, and the
+  // input wires of all layers are allocated by the first proof and
+  // reused by the later ones, so that repeated proofs do not pay for
+  // allocating and faulting in fresh memory.
+  //
+  // EXECUTOR, if not null, is used to parallelize the sumcheck
+  // prover and the Ligero commitment.  LIGERO_STREAM_ROWS, if nonzero,
+  // runs the Ligero prover in low-memory mode with windows of that
+  // many rows; see LigeroProver.
   ZkProver(const Circuit<Field>& CIRCUIT, const Field& F,
-           const ReedSolomonFactory& rs_factory)
-      : ProverLayers<Field>(F),
+           const ReedSolomonFactory& rs_factory, Executor* executor = nullptr,
+           size_t ligero_stream_rows = 0)
+      : ProverLayers<Field>(F, executor),
         c_(CIRCUIT),
-        n_witness_(c_.ninputs - c_.npub_in),
+        n_witness_(ZkCommon<Field>::witness_size(c_)),
         f_(F),
         rsf_(rs_factory),
+        ex_(executor),
+        ligero_stream_rows_(ligero_stream_rows),
         pad_(c_.nl),
         witness_(n_witness_),
         lqc_(c_.nl),
-        lp_(nullptr) {}
+        lp_(nullptr),
+        precomputed_(false),
+        evaluated_(false) {}
 
   void commit(ZkProof<Field>& zkp, const Dense<Field>& W, Transcript& tp,
               RandomEngine& rng) {
+    sample_commitment(zkp, W, rng);
+    compute_commitment(zkp);
+    write_commitment(zkp, tp);
+  }
+
+  // The three phases of commit().  SAMPLE_COMMITMENT() consumes all
+  // randomness, COMPUTE_COMMITMENT() does the expensive encoding and
+  // hashing, and WRITE_COMMITMENT() appends the root to the transcript.
+  // COMPUTE_COMMITMENT() touches neither RNG nor the transcript, and may
+  // run concurrently with another prover, or with evaluate().
+  //
+  // If precompute() was called, SAMPLE_COMMITMENT() consumes no
+  // randomness, and COMPUTE_COMMITMENT() only encodes and hashes the
+  // rows that precompute() could not.
+  void sample_commitment(ZkProof<Field>& zkp, const Dense<Field>& W,
+                         RandomEngine& rng) {
     log(INFO, "ZK Commit start");
 
-    // Copy witnesses for commitment
-    // Layout of the com: 0 ...<witnesses>... start_pad <pad> len
-    // Only commit the private witnesses, which begin at index c_.npub_in.
-    for (size_t i = 0; i < n_witness_; ++i) {
-      witness_[i] = W.v_[i + c_.npub_in];
+    if (precomputed_) {
+      check(same_param(lp_->param(), zkp.param),
+            "ZkProof differs from precompute()");
+      // Keep the pad drawn by precompute().
+      copy_witness(W, n_witness_);
+      lp_->sample(&witness_[0], subfield_boundary(), &lqc_[0], rng, f_);
+      precomputed_ = false;
+      return;
     }
 
-    // Rebase the circuit SUBFIELD_BOUNDARY (if any) to start at
-    // NPUB_IN,
-    size_t subfield_boundary = 0;
-    if (c_.subfield_boundary >= c_.npub_in) {
-      subfield_boundary = c_.subfield_boundary - c_.npub_in;
-    }
+    // fill_pad() appends the pad, and so drop the pad of the previous
+    // proof, if any, keeping the capacity of WITNESS_.
+    witness_.resize(n_witness_);
+    copy_witness(W, n_witness_);
 
     // Fill pad with random values, add pad to witness, record lqc.
     fill_pad(rng);
     ZkCommon<Field>::setup_lqc(c_, lqc_, n_witness_ /* = start_pad */);
 
-    // Commit to witness and pad.
-    lp_ = std::make_unique<LigeroProver<Field, ReedSolomonFactory>>(zkp.param);
-    lp_->commit(zkp.com, tp, &witness_[0], subfield_boundary, &lqc_[0], rsf_,
-                rng, f_);
+    ligero_prover(zkp).sample(&witness_[0], subfield_boundary(), &lqc_[0], rng,
+                              f_);
+  }
+
+  // Offline phase of the next commitment, for provers that know the
+  // circuit before they know the statement.  PRECOMPUTE() draws the
+  // pad and all other randomness of the commitment, and encodes and
+  // hashes what does not depend on the witnesses: the blinding rows,
+  // the pad and the products of the pad, and the first NSTATIC
+  // private witnesses, which it reads from W.  The rest of W is
+  // ignored.  NSTATIC counts witnesses of all copies, as in the
+  // commitment, and so private input I of copy C is witness
+  // (I - c_.npub_in) * c_.nc + C.
+  //
+  // The next sample_commitment() must be given the same ZKP
+  // parameters and a W that agrees with this one on the first NSTATIC
+  // private witnesses.  The proof is distributed as without
+  // precompute().
+  void precompute(ZkProof<Field>& zkp, const Dense<Field>& W, size_t nstatic,
+                  RandomEngine& rng) {
+    log(INFO, "ZK Precompute start");
+    check(nstatic <= n_witness_, "nstatic <= n_witness_");
+
+    // The dynamic witnesses are not known yet; zero is as good as
+    // anything else.
+    witness_.resize(n_witness_);
+    copy_witness(W, nstatic);
+    for (size_t i = nstatic; i < n_witness_; ++i) {
+      witness_[i] = f_.zero();
+    }
+
+    fill_pad(rng);
+    ZkCommon<Field>::setup_lqc(c_, lqc_, n_witness_ /* = start_pad */);
+
+    ligero_prover(zkp).precompute(&witness_[0], nstatic, n_witness_,
+                                  subfield_boundary(), &lqc_[0], rsf_, rng,
+                                  f_);
+    precomputed_ = true;
+    log(INFO, "ZK Precompute done");
+  }
+
+  void compute_commitment(ZkProof<Field>& zkp) {
+    check(lp_ != nullptr, "must run sample_commitment before");
+    lp_->compute_commitment(zkp.com, rsf_, f_);
+  }
 
+  void write_commitment(ZkProof<Field>& zkp, Transcript& tp) {
+    LigeroTranscript<Field>::write_commitment(zkp.com, tp);
     log(INFO, "ZK Commitment done");
   }
 
+  // Evaluate the circuit on W and check that all outputs are zero.
+  // prove() calls this function if the caller has not already done
+  // so.  The evaluation does not depend on the transcript, and thus
+  // it may run concurrently with other provers.  W must be the same
+  // witness later passed to prove().
+  bool evaluate(const Dense<Field>& W) {
+    evaluated_ = false;
+    auto V = super::eval_circuit(&in_, &c_, W, f_);
+    if (V == nullptr) {
+      log(ERROR, "eval_circuit failed");
+      return false;
+    }
+    for (size_t i = 0; i < V->n0_ * V->n1_; ++i) {
+      if (V->v_[i] != f_.zero()) {
+        log(ERROR, "V->v_[i] != F.zero()");
+        return false;
+      };
+    }
+    evaluated_ = true;
+    return true;
+  }
+
   bool prove(ZkProof<Field>& zkp, const Dense<Field>& W, Transcript& tsp) {
     check(lp_ != nullptr, "must run commit before prove");
 
@@ -108,23 +207,14 @@ class ZkProver : public ProverLayers<Field> {
     Transcript tst = tsp.clone();
 
     // Run sumcheck to generate a padded proof.
-    inputs in;
-    auto V = super::eval_circuit(&in, &c_, W.clone(), f_);
-    if (V == nullptr) {
-      log(ERROR, "eval_circuit failed");
+    if (!evaluated_ && !evaluate(W)) {
       return false;
     }
-    for (size_t i = 0; i < V->n1_; ++i) {
-      if (V->v_[i] != f_.zero()) {
-        log(ERROR, "V->v_[i] != F.zero()");
-        return false;
-      };
-    }
     bindings bnd;
     ProofAux<Field> aux(c_.nl);
 
     TranscriptSumcheck<Field> tsts(tst, f_);
-    super::prove(&zkp.proof, &pad_, &c_, in, &aux, bnd, tsts, f_);
+    super::prove(&zkp.proof, &pad_, &c_, in_, &aux, bnd, tsts, f_);
     log(INFO, "ZK sumcheck done");
 
     // 5. Simulate the verifier to assemble constraints on the committed vals.
@@ -144,6 +234,10 @@ class ZkProver : public ProverLayers<Field> {
     lp_->prove(zkp.com_proof, tsp, ci, a.size(), &a[0], hash_of_A, &lqc_[0],
                rsf_, f_);
 
+    // The sumcheck has consumed the layer inputs; the next proof must
+    // evaluate the circuit again.
+    evaluated_ = false;
+
     log(INFO, "Prover Done: flag");
     return true;
   }
@@ -187,14 +281,55 @@ class ZkProver : public ProverLayers<Field> {
     }
   }
 
+  // Copy the first N private witnesses of all copies for the
+  // commitment.  Layout of the com: 0 ...<witnesses>... start_pad <pad>
+  // len.  The private witnesses begin at index c_.npub_in * c_.nc
+  // since copies are the fast dimension of W.
+  void copy_witness(const Dense<Field>& W, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      witness_[i] = W.v_[i + c_.npub_in * c_.nc];
+    }
+  }
+
+  // The circuit SUBFIELD_BOUNDARY (if any), rebased to start at
+  // NPUB_IN, in units of witnesses of all copies.
+  size_t subfield_boundary() const {
+    if (c_.subfield_boundary >= c_.npub_in) {
+      return (c_.subfield_boundary - c_.npub_in) * c_.nc;
+    }
+    return 0;
+  }
+
+  // The Ligero prover of the previous proof if it has the same
+  // parameters, or a new one.
+  LigeroProver<Field, ReedSolomonFactory>& ligero_prover(
+      const ZkProof<Field>& zkp) {
+    if (lp_ == nullptr || !same_param(lp_->param(), zkp.param)) {
+      lp_ = std::make_unique<LigeroProver<Field, ReedSolomonFactory>>(
+          zkp.param, ex_, ligero_stream_rows_);
+    }
+    return *lp_;
+  }
+
+  static bool same_param(const LigeroParam<Field>& a,
+                         const LigeroParam<Field>& b) {
+    return a.nw == b.nw && a.nq == b.nq && a.nreq == b.nreq &&
+           a.block == b.block && a.block_enc == b.block_enc;
+  }
+
   const Circuit<Field>& c_;
   const size_t n_witness_;
   const Field& f_;
   const ReedSolomonFactory& rsf_;
+  Executor* ex_;
+  size_t ligero_stream_rows_;
   Proof<Field> pad_;
   std::vector<Elt> witness_;
   std::vector<LigeroQuadraticConstraint> lqc_;
   std::unique_ptr<LigeroProver<Field, ReedSolomonFactory>> lp_;
+  bool precomputed_;
+  inputs in_;
+  bool evaluated_;
 };
 
 }  // namespace proofs
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "algebra/convolution.h"
+#include "algebra/fp2.h"
 #include "algebra/fp_p128.h"
 #include "algebra/reed_solomon.h"
 #include "arrays/dense.h"
@@ -32,15 +33,18 @@
 #include "ec/p256.h"
 #include "proto/circuit.h"
 #include "random/random.h"
+#include "random/secure_random_engine.h"
 #include "random/transcript.h"
 #include "sumcheck/circuit.h"
 #include "sumcheck/prover.h"
 #include "util/log.h"
 #include "util/readbuffer.h"
+#include "util/thread_pool.h"
 #include "zk/zk_common.h"
 #include "zk/zk_proof.h"
 #include "zk/zk_prover.h"
 #include "zk/zk_testing.h"
+#include "zk/zk_verifier.h"
 #include "gtest/gtest.h"
 
 namespace proofs {
@@ -132,6 +136,131 @@ TEST_F(ZKTest, prover_verifier) {
                1ull << 31);
 }
 
+// Two provers sharing one transcript, as in the mdoc prover, must
+// produce the same bytes whether the expensive parts of their
+// commitments run serially or concurrently.
+TEST_F(ZKTest, pipelined_commit) {
+  using Field2 = Fp2<Fp256Base>;
+  using FftExtConvolutionFactory = FFTExtConvolutionFactory<Fp256Base, Field2>;
+  using RSFactory = ReedSolomonFactory<Fp256Base, FftExtConvolutionFactory>;
+  const Field2 base_2(p256_base);
+  const FftExtConvolutionFactory fft(p256_base, base_2, {omega_x_, omega_y_},
+                                     1ull << 31);
+  const RSFactory rsf(fft, p256_base);
+
+  std::vector<uint8_t> bytes[2];
+  for (size_t pipelined = 0; pipelined < 2; ++pipelined) {
+    ZkProof<Fp256Base> zk0(*circuit1_, kLigeroRate, kLigeroNreq);
+    ZkProof<Fp256Base> zk1(*circuit1_, kLigeroRate, kLigeroNreq);
+    ZkProver<Fp256Base, RSFactory> p0(*circuit1_, p256_base, rsf);
+    ZkProver<Fp256Base, RSFactory> p1(*circuit1_, p256_base, rsf);
+    Transcript rng((uint8_t*)"rng", 3, kVersion);
+    Transcript tp((uint8_t*)"zk_test", 7, kVersion);
+
+    if (pipelined) {
+      p0.sample_commitment(zk0, *w_, rng);
+      p1.sample_commitment(zk1, *w_, rng);
+      ThreadPool pool(2);
+      pool.run(2, [&](size_t i) {
+        if (i == 0) {
+          p0.compute_commitment(zk0);
+        } else {
+          p1.compute_commitment(zk1);
+        }
+      });
+      p0.write_commitment(zk0, tp);
+      p1.write_commitment(zk1, tp);
+      bool ok[2];
+      pool.run(2, [&](size_t i) { ok[i] = (i == 0 ? p0 : p1).evaluate(*w_); });
+      EXPECT_TRUE(ok[0] && ok[1]);
+    } else {
+      p0.commit(zk0, *w_, tp, rng);
+      p1.commit(zk1, *w_, tp, rng);
+    }
+    EXPECT_TRUE(p0.prove(zk0, *w_, tp));
+    EXPECT_TRUE(p1.prove(zk1, *w_, tp));
+    zk0.write(bytes[pipelined], p256_base);
+    zk1.write(bytes[pipelined], p256_base);
+  }
+  EXPECT_EQ(bytes[0], bytes[1]);
+}
+
+// A prover that is reused after another proof must produce the same
+// bytes as a fresh one.
+TEST_F(ZKTest, reused_prover) {
+  using Field2 = Fp2<Fp256Base>;
+  using FftExtConvolutionFactory = FFTExtConvolutionFactory<Fp256Base, Field2>;
+  using RSFactory = ReedSolomonFactory<Fp256Base, FftExtConvolutionFactory>;
+  const Field2 base_2(p256_base);
+  const FftExtConvolutionFactory fft(p256_base, base_2, {omega_x_, omega_y_},
+                                     1ull << 31);
+  const RSFactory rsf(fft, p256_base);
+
+  auto run = [&](ZkProver<Fp256Base, RSFactory>& prover, const char* seed,
+                 std::vector<uint8_t>& bytes) {
+    ZkProof<Fp256Base> zk(*circuit1_, kLigeroRate, kLigeroNreq);
+    Transcript rng((const uint8_t*)seed, strlen(seed), kVersion);
+    Transcript tp((uint8_t*)"zk_test", 7, kVersion);
+    prover.commit(zk, *w_, tp, rng);
+    EXPECT_TRUE(prover.prove(zk, *w_, tp));
+    zk.write(bytes, p256_base);
+  };
+
+  std::vector<uint8_t> fresh, first, reused;
+  ZkProver<Fp256Base, RSFactory> p0(*circuit1_, p256_base, rsf);
+  run(p0, "rng", fresh);
+
+  ZkProver<Fp256Base, RSFactory> p1(*circuit1_, p256_base, rsf);
+  run(p1, "other rng", first);
+  run(p1, "rng", reused);
+  EXPECT_NE(fresh, first);
+  EXPECT_EQ(fresh, reused);
+}
+
+// A commitment completed from precompute() must verify, and must not
+// depend on how much of the witness was known offline, given the same
+// random stream.
+TEST_F(ZKTest, precomputed_commit) {
+  using Field2 = Fp2<Fp256Base>;
+  using FftExtConvolutionFactory = FFTExtConvolutionFactory<Fp256Base, Field2>;
+  using RSFactory = ReedSolomonFactory<Fp256Base, FftExtConvolutionFactory>;
+  const Field2 base_2(p256_base);
+  const FftExtConvolutionFactory fft(p256_base, base_2, {omega_x_, omega_y_},
+                                     1ull << 31);
+  const RSFactory rsf(fft, p256_base);
+  const size_t npriv = circuit1_->ninputs - circuit1_->npub_in;
+
+  std::vector<uint8_t> bytes[2];
+  size_t nstatic[2] = {0, npriv / 3};
+  for (size_t k = 0; k < 2; ++k) {
+    // Only the public inputs and the static witnesses are known offline.
+    auto W_off = pub_->clone();
+    for (size_t i = 0; i < nstatic[k]; ++i) {
+      W_off->v_[circuit1_->npub_in + i] = w_->v_[circuit1_->npub_in + i];
+    }
+
+    ZkProof<Fp256Base> zk(*circuit1_, kLigeroRate, kLigeroNreq);
+    ZkProver<Fp256Base, RSFactory> prover(*circuit1_, p256_base, rsf);
+    Transcript rng((uint8_t*)"rng", 3, kVersion);
+    prover.precompute(zk, *W_off, nstatic[k], rng);
+
+    Transcript tp((uint8_t*)"zk_test", 7, kVersion);
+    prover.commit(zk, *w_, tp, rng);
+    EXPECT_TRUE(prover.prove(zk, *w_, tp));
+    zk.write(bytes[k], p256_base);
+
+    ZkProof<Fp256Base> zkv(*circuit1_, kLigeroRate, kLigeroNreq);
+    ReadBuffer rb(bytes[k]);
+    EXPECT_TRUE(zkv.read(rb, p256_base));
+    ZkVerifier<Fp256Base, RSFactory> verifier(*circuit1_, rsf, kLigeroRate,
+                                              kLigeroNreq, p256_base);
+    Transcript tv((uint8_t*)"zk_test", 7, kVersion);
+    verifier.recv_commitment(zkv, tv);
+    EXPECT_TRUE(verifier.verify(zkv, *pub_, tv));
+  }
+  EXPECT_EQ(bytes[0], bytes[1]);
+}
+
 TEST_F(ZKTest, failing_test) {
   auto W_fail = Dense<Fp256Base>(1, circuit1_->ninputs);
   DenseFiller<Fp256Base> wf(W_fail);
@@ -237,6 +366,78 @@ class TestRandomEngine : public RandomEngine {
   }
 };
 
+// The s-gonal circuit of Rfc_testvector1 below, with NC copies under
+// one commitment.  Copy C proves that m(2m - 1) is the m-th hexagonal
+// number, for m = C + 1.
+TEST(ZK, copies) {
+  using Fp128 = Fp128<>;
+  using CompilerBackend = CompilerBackend<Fp128>;
+  using LogicCircuit = Logic<Fp128, CompilerBackend>;
+  using EltW = LogicCircuit::EltW;
+  const Fp128 Fg;
+  constexpr size_t nc = 5;
+  std::unique_ptr<Circuit<Fp128>> circuit;
+
+  /*scope to delimit compile-time*/ {
+    QuadCircuit<Fp128> Q(Fg);
+    CompilerBackend cbk(&Q);
+    const LogicCircuit LC(&cbk, Fg);
+    EltW n = LC.eltw_input();
+    Q.private_input();
+    EltW m = LC.eltw_input();
+    EltW s = LC.eltw_input();
+    EltW sm2 = LC.sub(&s, LC.konst(2));
+    EltW m2 = LC.mul(&m, m);
+    EltW sm2m2 = LC.mul(&sm2, m2);
+    EltW sm4 = LC.sub(&s, LC.konst(4));
+    EltW sm4m = LC.mul(&sm4, m);
+    EltW t = LC.sub(&sm2m2, sm4m);
+    EltW k2 = LC.konst(2);
+    EltW nn = LC.mul(&n, k2);
+    LC.assert_eq(&t, nn);
+    circuit = Q.mkcircuit(nc);
+  }
+  EXPECT_EQ(circuit->nc, nc);
+  EXPECT_GT(circuit->logc, 0u);
+
+  // Input I of copy C is at W.v_[I * nc + C].
+  Dense<Fp128> W(nc, circuit->ninputs);
+  for (size_t c = 0; c < nc; ++c) {
+    uint64_t mc = c + 1;
+    W.v_[0 * nc + c] = Fg.one();
+    W.v_[1 * nc + c] = Fg.of_scalar(mc * (2 * mc - 1));
+    W.v_[2 * nc + c] = Fg.of_scalar(mc);
+    W.v_[3 * nc + c] = Fg.of_scalar(6);
+  }
+
+  auto omega = Fg.of_string("164956748514267535023998284330560247862");
+  uint64_t omega_order = 1ull << 32;
+  run_test_zk(*circuit, W, W, omega, omega_order, Fg);
+
+  // The same proof fails if the public input of one copy changes.
+  using FftConvolutionFactory = FFTConvolutionFactory<Fp128>;
+  using RSFactory = ReedSolomonFactory<Fp128, FftConvolutionFactory>;
+  FftConvolutionFactory fft(Fg, omega, omega_order);
+  const RSFactory rsf(fft, Fg);
+
+  ZkProof<Fp128> zkpr(*circuit, kLigeroRate, kLigeroNreq);
+  Transcript tp((uint8_t*)"zk_test", 7, kVersion);
+  SecureRandomEngine rng;
+  ZkProver<Fp128, RSFactory> prover(*circuit, Fg, rsf);
+  prover.commit(zkpr, W, tp, rng);
+  EXPECT_TRUE(prover.prove(zkpr, W, tp));
+
+  Dense<Fp128> pub(nc, circuit->ninputs);
+  pub.copy_from(W);
+  pub.v_[1 * nc + 3] = Fg.of_scalar(29);
+
+  ZkVerifier<Fp128, RSFactory> verifier(*circuit, rsf, kLigeroRate,
+                                        kLigeroNreq, Fg);
+  Transcript tv((uint8_t*)"zk_test", 7, kVersion);
+  verifier.recv_commitment(zkpr, tv);
+  EXPECT_FALSE(verifier.verify(zkpr, pub, tv));
+}
+
 // This Test method generates the examples used in our RFC for a circuit,
 // for a sumcheck run, and a Ligero run.
 // First, it defines a small test circuit:
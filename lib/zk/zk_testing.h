@@ -28,6 +28,7 @@
 #include "sumcheck/circuit.h"
 #include "util/log.h"
 #include "util/readbuffer.h"
+#include "util/writebuffer.h"
 #include "zk/zk_proof.h"
 #include "zk/zk_prover.h"
 #include "zk/zk_verifier.h"
@@ -136,6 +137,16 @@ void run_test_zk(const Circuit<Field>& circuit, Dense<Field>& W,
   zkpr.write(zbuf, F);
   log(INFO, "zkp len: %zu bytes", zbuf.size());
 
+  // Writing into caller memory produces the same bytes, of the
+  // predicted size.
+  EXPECT_EQ(zbuf.size(), zkpr.serialized_size(F));
+  EXPECT_LE(zkpr.serialized_size(F), zkpr.size());
+  std::vector<uint8_t> zbuf2(zkpr.serialized_size(F));
+  WriteBuffer wb(zbuf2.data(), zbuf2.size());
+  zkpr.write(wb, F);
+  EXPECT_EQ(wb.remaining(), 0u);
+  EXPECT_EQ(zbuf, zbuf2);
+
   // ======= zk verifier =============
   // Re-parse the proof to simulate a different client.
   ZkProof<Field> zkpv(circuit, kLigeroRate, kLigeroNreq);
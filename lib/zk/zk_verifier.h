@@ -45,7 +45,7 @@ class ZkVerifier {
   explicit ZkVerifier(const Circuit<Field>& c, const RSFactory& rsf,
                       size_t rate, size_t nreq, const Field& F)
       : circ_(c),
-        n_witness_(c.ninputs - c.npub_in),
+        n_witness_(ZkCommon<Field>::witness_size(c)),
         param_(n_witness_ + ZkCommon<Field>::pad_size(c), c.nl, rate, nreq),
         lqc_(c.nl),
         rsf_(rsf),
@@ -57,7 +57,7 @@ class ZkVerifier {
                       size_t rate, size_t nreq, size_t block_enc,
                       const Field& F)
       : circ_(c),
-        n_witness_(c.ninputs - c.npub_in),
+        n_witness_(ZkCommon<Field>::witness_size(c)),
         param_(n_witness_ + ZkCommon<Field>::pad_size(c), c.nl, rate, nreq,
                block_enc),
         lqc_(c.nl),